@@ -0,0 +1,119 @@
+#pragma once
+///
+///	A 2D affine transform stored as the top 2 rows of a 3x3 matrix.
+///
+/// r[0]   0  1  2
+/// r[1]   3  4  5
+///        0  0  1   (implicit)
+///
+/// affine2<float> is 24 bytes. Composing two transforms takes 12 multiplies
+/// and transforming a point takes 4, against 64 and 16 for matrix4.
+///
+/// toMatrix() embeds the transform in a matrix4 that passes z through
+/// unchanged, for uploading to the GPU.
+///
+
+namespace maths {
+
+template<typename T>
+struct affine2 final {
+    static_assert(std::is_floating_point<T>::value);
+
+    vector3<T> r[2];
+
+    constexpr static affine2 identity() {
+        return {vector3<T>{1, 0, 0}, vector3<T>{0, 1, 0}};
+    }
+    constexpr static affine2 fromMatrix(const matrix3<T>& m) {
+        assert(m[0].z == 0 && m[1].z == 0 && m[2].z == 1);
+        return {vector3<T>{m[0].x, m[1].x, m[2].x}, vector3<T>{m[0].y, m[1].y, m[2].y}};
+    }
+    constexpr matrix3<T> toMatrix3() const {
+        return matrix3<T>::rowMajor({
+            r[0].x, r[0].y, r[0].z,
+            r[1].x, r[1].y, r[1].z,
+            0, 0, 1
+        });
+    }
+    constexpr matrix4<T> toMatrix() const {
+        return matrix4<T>::rowMajor({
+            r[0].x, r[0].y, 0, r[0].z,
+            r[1].x, r[1].y, 0, r[1].z,
+            0, 0, 1, 0,
+            0, 0, 0, 1
+        });
+    }
+
+    constexpr static affine2 translate(const vector2<T>& v) {
+        return {vector3<T>{1, 0, v.x}, vector3<T>{0, 1, v.y}};
+    }
+    constexpr static affine2 scale(const vector2<T>& v) {
+        return {vector3<T>{v.x, 0, 0}, vector3<T>{0, v.y, 0}};
+    }
+    constexpr static affine2 rotate(T radians) {
+        T S, C;
+        trig::sincos(radians, S, C);
+        return {vector3<T>{C, -S, 0}, vector3<T>{S, C, 0}};
+    }
+
+    /// The translation column
+    constexpr vector2<T> translation() const {
+        return {r[0].z, r[1].z};
+    }
+
+    constexpr bool operator==(const affine2& o) const {
+        return r[0] == o.r[0] && r[1] == o.r[1];
+    }
+    constexpr bool operator!=(const affine2& o) const {
+        return !operator==(o);
+    }
+    constexpr bool approx(const affine2& o) const {
+        return r[0].approx(o.r[0]) && r[1].approx(o.r[1]);
+    }
+
+    /// this * o, ie. apply o then this
+    constexpr affine2 operator*(const affine2& o) const {
+        return {row(r[0], o), row(r[1], o)};
+    }
+    constexpr vector2<T> transformPoint(const vector2<T>& p) const {
+        return {r[0].x * p.x + r[0].y * p.y + r[0].z, r[1].x * p.x + r[1].y * p.y + r[1].z};
+    }
+    /// Ignores the translation
+    constexpr vector2<T> transformDirection(const vector2<T>& d) const {
+        return {r[0].x * d.x + r[0].y * d.y, r[1].x * d.x + r[1].y * d.y};
+    }
+
+    constexpr T determinant() const {
+        return r[0].x * r[1].y - r[0].y * r[1].x;
+    }
+    /// Inverts the 2x2 part and transforms the negated translation by it.
+    /// A singular transform returns the adjugate
+    constexpr affine2 inversed() const {
+        T det = determinant();
+        if(det == 0) det = 1; /// this transform has no inverse
+        const T id = 1 / det;
+        const vector2<T> l0{r[1].y * id, -r[0].y * id}, l1{-r[1].x * id, r[0].x * id};
+        const vector2<T> t = translation();
+        return {vector3<T>{l0.x, l0.y, -l0.dot(t)}, vector3<T>{l1.x, l1.y, -l1.dot(t)}};
+    }
+
+    std::string toString() const {
+        char buf[96];
+        sprintf_s(buf, "%5.2f %5.2f %5.2f\n%5.2f %5.2f %5.2f",
+                  r[0].x, r[0].y, r[0].z,
+                  r[1].x, r[1].y, r[1].z);
+        return std::string(buf);
+    }
+private:
+    /// A row of this * o
+    constexpr static vector3<T> row(const vector3<T>& a, const affine2& o) {
+        return o.r[0] * a.x + o.r[1] * a.y + vector3<T>{0, 0, a.z};
+    }
+};
+
+static_assert(sizeof(affine2<float>) == 6 * sizeof(float));
+
+typedef affine2<float> float2x3;
+typedef affine2<double> double2x3;
+
+}
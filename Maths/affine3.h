@@ -0,0 +1,153 @@
+#pragma once
+///
+///	An affine transform stored as the top 3 rows of a 4x4 matrix.
+///
+/// r[0]   0  1  2  3
+/// r[1]   4  5  6  7
+/// r[2]   8  9 10 11
+///        0  0  0  1   (implicit)
+///
+/// Each row is a vector4 so affine3<float> is 48 bytes against 64 for a
+/// matrix and the row operations use the SSE float4 code. Composing two
+/// transforms takes 36 multiplies against 64 for matrix * matrix.
+///
+/// affine3<float>::fromMatrix(m).toMatrix() == m for any matrix whose last
+/// row is [0 0 0 1].
+///
+
+namespace maths {
+
+template<typename T>
+struct affine3 final {
+    static_assert(std::is_floating_point<T>::value);
+
+    vector4<T> r[3];
+
+    constexpr static affine3 identity() {
+        return {vector4<T>{1, 0, 0, 0}, vector4<T>{0, 1, 0, 0}, vector4<T>{0, 0, 1, 0}};
+    }
+    constexpr static affine3 fromMatrix(const matrix4<T>& m) {
+        assert(m[0].w == 0 && m[1].w == 0 && m[2].w == 0 && m[3].w == 1);
+        return {
+            vector4<T>{m[0].x, m[1].x, m[2].x, m[3].x},
+            vector4<T>{m[0].y, m[1].y, m[2].y, m[3].y},
+            vector4<T>{m[0].z, m[1].z, m[2].z, m[3].z}
+        };
+    }
+    constexpr matrix4<T> toMatrix() const {
+        return matrix4<T>::rowMajor({
+            r[0].x, r[0].y, r[0].z, r[0].w,
+            r[1].x, r[1].y, r[1].z, r[1].w,
+            r[2].x, r[2].y, r[2].z, r[2].w,
+            0, 0, 0, 1
+        });
+    }
+
+    constexpr static affine3 translate(const vector3<T>& v) {
+        return {vector4<T>{1, 0, 0, v.x}, vector4<T>{0, 1, 0, v.y}, vector4<T>{0, 0, 1, v.z}};
+    }
+    constexpr static affine3 scale(const vector3<T>& v) {
+        return {vector4<T>{v.x, 0, 0, 0}, vector4<T>{0, v.y, 0, 0}, vector4<T>{0, 0, v.z, 0}};
+    }
+    constexpr static affine3 rotateX(T radians) {
+        return fromMatrix(matrix4<T>::rotateX(radians));
+    }
+    constexpr static affine3 rotateY(T radians) {
+        return fromMatrix(matrix4<T>::rotateY(radians));
+    }
+    constexpr static affine3 rotateZ(T radians) {
+        return fromMatrix(matrix4<T>::rotateZ(radians));
+    }
+    constexpr static affine3 lookAtLH(const vector3<T>& eye, const vector3<T>& target, const vector3<T>& up) {
+        return fromMatrix(matrix4<T>::lookAtLH(eye, target, up));
+    }
+    constexpr static affine3 lookAtRH(const vector3<T>& eye, const vector3<T>& target, const vector3<T>& up) {
+        return fromMatrix(matrix4<T>::lookAtRH(eye, target, up));
+    }
+
+    /// The translation column
+    constexpr vector3<T> translation() const {
+        return {r[0].w, r[1].w, r[2].w};
+    }
+
+    constexpr bool operator==(const affine3& o) const {
+        return r[0] == o.r[0] && r[1] == o.r[1] && r[2] == o.r[2];
+    }
+    constexpr bool operator!=(const affine3& o) const {
+        return !operator==(o);
+    }
+    constexpr bool approx(const affine3& o) const {
+        return r[0].approx(o.r[0]) && r[1].approx(o.r[1]) && r[2].approx(o.r[2]);
+    }
+
+    /// this * o, ie. apply o then this
+    constexpr affine3 operator*(const affine3& o) const {
+        return {row(r[0], o), row(r[1], o), row(r[2], o)};
+    }
+    constexpr vector3<T> transformPoint(const vector3<T>& p) const {
+        return {
+            r[0].x * p.x + r[0].y * p.y + r[0].z * p.z + r[0].w,
+            r[1].x * p.x + r[1].y * p.y + r[1].z * p.z + r[1].w,
+            r[2].x * p.x + r[2].y * p.y + r[2].z * p.z + r[2].w
+        };
+    }
+    /// Ignores the translation
+    constexpr vector3<T> transformDirection(const vector3<T>& d) const {
+        return {
+            r[0].x * d.x + r[0].y * d.y + r[0].z * d.z,
+            r[1].x * d.x + r[1].y * d.y + r[1].z * d.z,
+            r[2].x * d.x + r[2].y * d.y + r[2].z * d.z
+        };
+    }
+
+    constexpr T determinant() const {
+        return vector3<T>{r[0].x, r[0].y, r[0].z}.tripleProduct(
+            vector3<T>{r[1].x, r[1].y, r[1].z},
+            vector3<T>{r[2].x, r[2].y, r[2].z});
+    }
+    /// Inverts the 3x3 part with cross products and transforms the negated
+    /// translation by it. A singular transform returns the adjugate
+    constexpr affine3 inversed() const {
+        const vector3<T> a{r[0].x, r[1].x, r[2].x}, b{r[0].y, r[1].y, r[2].y}, d{r[0].z, r[1].z, r[2].z};
+        const vector3<T> i0 = b.cross(d), i1 = d.cross(a), i2 = a.cross(b);
+        T det = a.dot(i0);
+        if(det == 0) det = 1; /// this transform has no inverse
+        const T id = 1 / det;
+        return withTranslation(i0 * id, i1 * id, i2 * id);
+    }
+    /// Inverse of a rotation plus translation with no scale
+    constexpr affine3 inversedRigid() const {
+        return withTranslation(
+            vector3<T>{r[0].x, r[1].x, r[2].x},
+            vector3<T>{r[0].y, r[1].y, r[2].y},
+            vector3<T>{r[0].z, r[1].z, r[2].z});
+    }
+
+    std::string toString() const {
+        char buf[192];
+        sprintf_s(buf, "%5.2f %5.2f %5.2f %5.2f\n%5.2f %5.2f %5.2f %5.2f\n%5.2f %5.2f %5.2f %5.2f",
+                  r[0].x, r[0].y, r[0].z, r[0].w,
+                  r[1].x, r[1].y, r[1].z, r[1].w,
+                  r[2].x, r[2].y, r[2].z, r[2].w);
+        return std::string(buf);
+    }
+private:
+    /// A row of this * o
+    constexpr static vector4<T> row(const vector4<T>& a, const affine3& o) {
+        return o.r[0] * a.x + o.r[1] * a.y + o.r[2] * a.z + vector4<T>{0, 0, 0, a.w};
+    }
+    /// The transform with 3x3 rows l0, l1 and l2 and translation -l * translation()
+    constexpr affine3 withTranslation(const vector3<T>& l0, const vector3<T>& l1, const vector3<T>& l2) const {
+        const vector3<T> t = translation();
+        return {
+            vector4<T>{l0.x, l0.y, l0.z, -l0.dot(t)},
+            vector4<T>{l1.x, l1.y, l1.z, -l1.dot(t)},
+            vector4<T>{l2.x, l2.y, l2.z, -l2.dot(t)}
+        };
+    }
+};
+
+typedef affine3<float> affine;
+typedef affine3<double> daffine;
+
+}
@@ -0,0 +1,70 @@
+#pragma once
+///
+///	Batch quaternion interpolation and dual quaternion skinning.
+///
+/// slerpAll(keyA, keyB, t, pose);   /// xyzw quaternions in float4 streams
+/// skinAll(bones, joints, weights, positions, skinned);
+///
+/// Each vertex has 4 influences: 4 bone indices in joints (interleaved,
+/// joints[i * 4 + k]) and 4 weights in a float4 stream (weights.x is the
+/// weight of joints[i * 4]). Unused influences should have weight 0.
+/// Every joint index must be less than bones.size().
+///
+/// The skinning kernel gathers the bones of 4, 8 or 16 vertices at a time
+/// into registers and blends them as dualquaternion::blend does. Inputs
+/// larger than one chunk of 16384 vertices are split across the threads
+/// in parallel.h.
+///
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include "kernels.h"
+#include "parallel.h"
+
+namespace maths {
+
+namespace detail {
+
+constexpr std::size_t SKIN_CHUNK = 1 << 14;
+
+inline void skin(std::span<const dualquat> bones, std::span<const uint16_t> joints, cfloat4_span weights,
+				 cfloat3_span p, float3_span outP, const cfloat3_span* nrm, const float3_span* outN)
+{
+	assert(!bones.empty() && joints.size() == p.size() * 4);
+	assert(weights.size() == p.size() && outP.size() == p.size());
+	assert(std::all_of(joints.begin(), joints.end(), [&](uint16_t j) { return j < bones.size(); }) && "Joint index out of range");
+	const std::size_t n = p.size();
+	parallel::forEach((n + SKIN_CHUNK - 1) / SKIN_CHUNK, [&](std::size_t c) {
+		const std::size_t begin = c * SKIN_CHUNK, count = std::min(SKIN_CHUNK, n - begin);
+		const kernels::csoa cn = nrm ? kernels::ptrs(nrm->subspan(begin, count)) : kernels::csoa{};
+		const kernels::soa on = outN ? kernels::ptrs(outN->subspan(begin, count)) : kernels::soa{};
+		kernels::table().skin(&bones[0].real.x, joints.data() + begin * 4,
+							  kernels::ptrs(weights.subspan(begin, count)),
+							  kernels::ptrs(p.subspan(begin, count)), kernels::ptrs(outP.subspan(begin, count)),
+							  cn, on, count);
+	});
+}
+
+}
+
+/// out[i] = a[i].slerp(b[i], t). out may be a or b
+inline void slerpAll(cfloat4_span a, cfloat4_span b, float t, float4_span out) {
+	assert(a.size() == out.size() && b.size() == out.size());
+	kernels::table().slerp(kernels::ptrs(a), kernels::ptrs(b), t, kernels::ptrs(out), out.size());
+}
+
+/// outP[i] = dualquat::blend(bones[joints[i * 4 + k]], weights[i]).transformPoint(p[i])
+inline void skinAll(std::span<const dualquat> bones, std::span<const uint16_t> joints, cfloat4_span weights,
+					cfloat3_span p, float3_span outP)
+{
+	detail::skin(bones, joints, weights, p, outP, nullptr, nullptr);
+}
+/// Also rotates normals by the blended bones
+inline void skinAll(std::span<const dualquat> bones, std::span<const uint16_t> joints, cfloat4_span weights,
+					cfloat3_span p, float3_span outP, cfloat3_span normals, float3_span outNormals)
+{
+	assert(normals.size() == p.size() && outNormals.size() == p.size());
+	detail::skin(bones, joints, weights, p, outP, &normals, &outNormals);
+}
+
+}
@@ -1,12 +1,43 @@
 #pragma once
+///
+///	The interface shared by Camera2D and Camera3D.
+///
+/// The version stamps increase every time the camera is changed through its
+/// methods, so a consumer can keep the last version it saw and skip
+/// recomputing or uploading matrices that have not changed:
+///
+///	if(camera.viewProjVersion() != uploadedVersion) {
+///		upload(camera.VP());
+///		uploadedVersion = camera.viewProjVersion();
+///	}
+///
+/// Every version starts at 1 so a consumer starting at 0 always sees a
+/// change. Writing to the public fields directly does not change the versions
+/// (or mark the matrices for recalculation).
+///
 
 namespace maths {
 
 class Camera {
+protected:
+	uint64_t viewVer = 1;
+	uint64_t projVer = 1;
 public:
 	virtual const matrix& V() = 0;
 	virtual const matrix& P() = 0;
 	virtual const matrix& VP() = 0;
+	virtual const matrix& invV() = 0;
+	virtual const matrix& invP() = 0;
+	virtual const matrix& invVP() = 0;
+	/// The inverse transpose of V() without the translation, for view space normals
+	virtual const matrix& normalMatrix() = 0;
+
+	/// Changes with V(), invV() and normalMatrix()
+	uint64_t viewVersion() const { return viewVer; }
+	/// Changes with P() and invP()
+	uint64_t projVersion() const { return projVer; }
+	/// Changes with VP() and invVP(), whenever either of the others does
+	uint64_t viewProjVersion() const { return viewVer + projVer; }
 };
 
 }
\ No newline at end of file
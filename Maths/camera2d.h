@@ -1,4 +1,15 @@
 #pragma once
+///
+///	An orthographic camera that pans and zooms in the xy plane.
+///
+/// VP2() is the view-projection for z = 0 as a 2D affine transform, built
+/// without any 4x4 maths. Use it with transformPoints(VP2(), sprites, out).
+/// VP() embeds VP2() in a matrix4 for the GPU, with z mapped the same way as
+/// P() * V(). V() and P() are only built when asked for.
+///
+/// The inverses are cached the same way. V() is rigid and VP() is affine so
+/// none of them need a general 4x4 inverse.
+///
 
 namespace maths {
 
@@ -6,11 +17,38 @@ class Camera2D final : public Camera {
 	matrix view;
 	matrix proj;
 	matrix viewProj;
+	matrix invView;
+	matrix invProj;
+	matrix invViewProj;
+	matrix normal;
+	float2x3 viewProj2;
 	float _zoomFactor = 1, minZoom = 0.01f, maxZoom = 100;
 	float rotationRads = 0;
 	bool recalculateView = true;
 	bool recalculateProj = true;
 	bool recalculateViewProj = true;
+	bool recalculateViewProj2 = true;
+	bool recalculateInvView = true;
+	bool recalculateInvProj = true;
+	bool recalculateInvViewProj = true;
+	bool recalculateNormal = true;
+	static constexpr float ZNEAR = 0, ZFAR = 100;
+
+	void viewChanged() {
+		recalculateView = true;
+		viewVer++;
+		changed();
+	}
+	void projChanged() {
+		recalculateProj = true;
+		projVer++;
+		changed();
+	}
+	void changed() {
+		recalculateViewProj = true;
+		recalculateViewProj2 = true;
+		recalculateInvViewProj = true;
+	}
 public:
 	float3 position;
 	float3 up;
@@ -26,16 +64,18 @@ public:
 		this->windowSize = windowSize;
 		this->position = float3{(float)windowSize.x / 2, (float)windowSize.y / 2, 1};
 		this->up = float3{0, 1, 0};
+		viewChanged();
+		projChanged();
         return *this;
 	}
 	auto& moveTo(float2 pos) {
 		position = {pos.x, pos.y, 1};
-		recalculateView = true;
+		viewChanged();
 		return *this;
 	}
 	auto& moveBy(float2 pos) {
 		position += {pos.x, pos.y, 0};
-		recalculateView = true;
+		viewChanged();
 		return *this;
 	}
 	// TODO - can we do zoom using Z?
@@ -44,7 +84,7 @@ public:
 		_zoomFactor = 1 / z;
 		this->minZoom = minZoom;
 		this->maxZoom = maxZoom;
-		recalculateProj = true;
+		projChanged();
 		return *this;
 	}
 	auto& zoomOut(float z) {
@@ -53,7 +93,7 @@ public:
 		if(_zoomFactor > maxZoom) {
 			_zoomFactor = maxZoom;
 		}
-		recalculateProj = true;
+		projChanged();
 		return *this;
 	}
 	auto& zoomIn(float z) {
@@ -62,7 +102,7 @@ public:
 		if(_zoomFactor < minZoom) {
 			_zoomFactor = minZoom;
 		}
-		recalculateProj = true;
+		projChanged();
 		return *this;
 	}
 	const matrix& P() final override {
@@ -70,10 +110,10 @@ public:
 			float width  = (float)windowSize.x*_zoomFactor;
 			float height = (float)windowSize.y*_zoomFactor;
 
-			proj = matrix::orthoRH(width, -height, 0.0f, 100.0f);
+			proj = matrix::orthoRH(width, -height, ZNEAR, ZFAR);
 
 			recalculateProj = false;
-			recalculateViewProj = true;
+			recalculateInvProj = true;
 		}
 		return proj;
 	}
@@ -83,19 +123,69 @@ public:
 			view = matrix::lookAtRH(position, position + float3{0, 0, -1}, up);
 
 			recalculateView = false;
-			recalculateViewProj = true;
+			recalculateInvView = true;
+			recalculateNormal = true;
 		}
 		return view;
 	}
 	const matrix& VP() final override {
-		if(recalculateView || recalculateProj || recalculateViewProj) {
-			V();
-			P();
-			viewProj = proj * view;
+		if(recalculateViewProj) {
+			/// z' = (z - position.z) / (ZFAR - ZNEAR) as orthoRH * lookAtRH gives
+			const float fRange = 1 / (ZFAR - ZNEAR);
+			viewProj = VP2().toMatrix();
+			viewProj[2][2] = fRange;
+			viewProj[3][2] = (ZNEAR - position.z) * fRange;
 			recalculateViewProj = false;
 		}
 		return viewProj;
 	}
+	const matrix& invV() final override {
+		if(recalculateView || recalculateInvView) {
+			invView = V().inversedRigid();
+			recalculateInvView = false;
+		}
+		return invView;
+	}
+	const matrix& invP() final override {
+		if(recalculateProj || recalculateInvProj) {
+			invProj = P().inversedOrtho();
+			recalculateInvProj = false;
+		}
+		return invProj;
+	}
+	const matrix& invVP() final override {
+		if(recalculateInvViewProj) {
+			invViewProj = VP().inversedAffine();
+			recalculateInvViewProj = false;
+		}
+		return invViewProj;
+	}
+	const matrix& normalMatrix() final override {
+		if(recalculateView || recalculateNormal) {
+			normal = V();
+			normal[3] = float4{0, 0, 0, 1};
+			recalculateNormal = false;
+		}
+		return normal;
+	}
+	/// The xy part of lookAtRH and orthoRH. The view axes are in the xy
+	/// plane because the camera looks down -z
+	const float2x3& VP2() {
+		if(recalculateViewProj2) {
+			const float2 xaxis = float2{up.y, -up.x}.normalised();
+			const float2 yaxis{-xaxis.y, xaxis.x};
+			const float2 eye{position.x, position.y};
+			const float2x3 view2{
+				float3{xaxis.x, xaxis.y, -xaxis.dot(eye)},
+				float3{yaxis.x, yaxis.y, -yaxis.dot(eye)}
+			};
+			const float width  = (float)windowSize.x*_zoomFactor;
+			const float height = (float)windowSize.y*_zoomFactor;
+			viewProj2 = float2x3::scale({2 / width, 2 / -height}) * view2;
+			recalculateViewProj2 = false;
+		}
+		return viewProj2;
+	}
 };
 
 }
\ No newline at end of file
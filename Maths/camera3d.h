@@ -6,13 +6,30 @@ class Camera3D final : public Camera {
 	matrix view;
 	matrix proj;
 	matrix viewProj;
+	matrix invView;
+	matrix invProj;
+	matrix invViewProj;
+	matrix normal;
 	bool recalculateView = true;
 	bool recalculateProj = true;
 	bool recalculateViewProj = true;
+	bool recalculateInvView = true;
+	bool recalculateInvProj = true;
+	bool recalculateInvViewProj = true;
+	bool recalculateNormal = true;
 	float focalLength = 0;
 	float _fov = toRadians(60);
 	float _near = 0.1f;
 	float _far = 100.0f;
+
+	void viewChanged() {
+		recalculateView = true;
+		viewVer++;
+	}
+	void projChanged() {
+		recalculateProj = true;
+		projVer++;
+	}
 public:
 	float3 position{0, 1, 0};
 	float3 up{0, 1, 0};
@@ -38,27 +55,26 @@ public:
 		this->up		  = up.normalised();
 		this->forward     = (focalPoint-pos).normalised();
 		this->focalLength = (focalPoint-pos).length();
-        recalculateView = true;
-        recalculateProj = true;
-        recalculateViewProj = true;
+        viewChanged();
+        projChanged();
         return *this;
 	}
 	auto& fovNearFar(float fovInRadians, float nr, float fr) {
 		this->_fov = fovInRadians;
 		this->_near = nr;
 		this->_far = fr;
-		recalculateProj = true;
+		projChanged();
 		return *this;
 	}
 	auto& moveForward(float f) {
 		auto dist = forward * f;
 		position += dist;
-		recalculateView = true;
+		viewChanged();
 		return *this;
 	}
 	auto& movePositionRelative(const float3& newpos) {
 		position += newpos;
-		recalculateView = true;
+		viewChanged();
 		return *this;
 	}
     /// Rotate around the Y axis 
@@ -66,7 +82,7 @@ public:
         position = position.rotatedAroundY(radians);
         up       = up.rotatedAroundY(radians);
         forward  = forward.rotatedAroundY(radians);
-        recalculateView = true;
+        viewChanged();
         return *this;
     }
 	/// move focal point up/down (around x plane)
@@ -75,7 +91,7 @@ public:
 		auto dist  = up * f;
 		forward  = (forward + dist).normalised();
 		up = right.cross(forward);
-		recalculateView = true;
+		viewChanged();
 		return *this;
 	}
 	/// move focal point left/right (around y plane)
@@ -83,7 +99,7 @@ public:
 		auto right = forward.cross(up);
 		auto dist = right * f;
 		forward = (forward + dist).normalised();
-		recalculateView = true;
+		viewChanged();
 		return *this;
 	}
 	/// tip (around z plane)
@@ -91,7 +107,7 @@ public:
 		auto right = forward.cross(up);
 		auto dist = right * f;
 		up = (up + dist).normalised();
-		recalculateView = true;
+		viewChanged();
 		return *this;
 	}
 	const matrix& V() final override {
@@ -101,12 +117,12 @@ public:
 
 			recalculateView = false;
 			recalculateViewProj = true;
+			recalculateInvView = true;
+			recalculateInvViewProj = true;
+			recalculateNormal = true;
 		}
 		return view;
 	}
-	matrix invV() {
-		return V().inversed();
-	}
 	const matrix& P() final override {
 		if(recalculateProj) {
 
@@ -119,6 +135,8 @@ public:
 
 			recalculateProj = false;
 			recalculateViewProj = true;
+			recalculateInvProj = true;
+			recalculateInvViewProj = true;
 		}
 		return proj;
 	}
@@ -131,6 +149,37 @@ public:
 		}
 		return viewProj;
 	}
+	/// The inverses use the closed forms for lookAtRH and perspectiveFovRH
+	const matrix& invV() final override {
+		if(recalculateView || recalculateInvView) {
+			invView = V().inversedRigid();
+			recalculateInvView = false;
+		}
+		return invView;
+	}
+	const matrix& invP() final override {
+		if(recalculateProj || recalculateInvProj) {
+			invProj = P().inversedPerspective();
+			recalculateInvProj = false;
+		}
+		return invProj;
+	}
+	const matrix& invVP() final override {
+		if(recalculateView || recalculateProj || recalculateInvViewProj) {
+			invViewProj = invV() * invP();
+			recalculateInvViewProj = false;
+		}
+		return invViewProj;
+	}
+	/// V() is rigid so this is its rotation
+	const matrix& normalMatrix() final override {
+		if(recalculateView || recalculateNormal) {
+			normal = V();
+			normal[3] = float4{0, 0, 0, 1};
+			recalculateNormal = false;
+		}
+		return normal;
+	}
 };
 
 }
\ No newline at end of file
@@ -0,0 +1,145 @@
+#pragma once
+///
+///	constexpr versions of sqrt, sin, cos and tan.
+///
+/// constexpr float s = cx::sin(0.5f);
+/// constexpr auto table = cx::table<256>([](std::size_t i) { return cx::sin(i * 0.1f); });
+///
+/// These are used by maths::sqrt and the trig:: scalar functions when they
+/// are constant evaluated, so that matrix4::rotateX(), perspectiveFovRH(),
+/// vector3::length() etc. can be folded at compile time. At run time those
+/// use the standard library or the polynomial code in trig.h, so compile time
+/// and run time results can differ in the last bit.
+///
+/// All of the calculations are done in double. sqrt is exact to 1 ulp of
+/// double. sin, cos and tan are within 1e-15 of the true result for
+/// |x| <= 1e6 and lose accuracy beyond that.
+///
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <type_traits>
+
+namespace maths {
+
+namespace cx {
+
+namespace detail {
+
+/// pi/2 split so that q*PIO2_HI is exact for |q| < 2^20
+constexpr double PIO2_HI = 1.57079632673412561417e+00;
+constexpr double PIO2_LO = 6.07710050650619224932e-11;
+constexpr double TWO_OVER_PI = 6.36619772367581382433e-01;
+
+/// Taylor series for |r| <= pi/4
+constexpr double sinPoly(double r) {
+	const double z = r * r;
+	double term = r, sum = r;
+	for(int i = 2; i < 24; i += 2) {
+		term *= -z / (i * (i + 1));
+		sum += term;
+	}
+	return sum;
+}
+constexpr double cosPoly(double r) {
+	const double z = r * r;
+	double term = 1, sum = 1;
+	for(int i = 1; i < 23; i += 2) {
+		term *= -z / (i * (i + 1));
+		sum += term;
+	}
+	return sum;
+}
+/// x = q*pi/2 + r. Returns q mod 4
+constexpr int reduce(double x, double& r) {
+	const double f = x * TWO_OVER_PI;
+	const long long q = (long long)(f < 0 ? f - 0.5 : f + 0.5);
+	r = (x - q * PIO2_HI) - q * PIO2_LO;
+	return (int)(q & 3);
+}
+
+}
+
+constexpr double sqrt(double x) {
+	if(!(x >= 0)) return std::numeric_limits<double>::quiet_NaN();
+	if(x == 0 || x == std::numeric_limits<double>::infinity()) return x;
+	/// Scale into [1, 4) by powers of 4 so that a fixed number of
+	/// Newton-Raphson steps converges
+	double scale = 1;
+	while(x >= 4) {
+		x *= 0.25;
+		scale *= 2;
+	}
+	while(x < 1) {
+		x *= 4;
+		scale *= 0.5;
+	}
+	double r = 1.5;
+	for(int i = 0; i < 7; i++) r = 0.5 * (r + x / r);
+	return r * scale;
+}
+constexpr void sincos(double x, double& s, double& c) {
+	double r = 0;
+	const int q = detail::reduce(x, r);
+	const double ps = detail::sinPoly(r), pc = detail::cosPoly(r);
+	switch(q) {
+		case 0: s = ps; c = pc; break;
+		case 1: s = pc; c = -ps; break;
+		case 2: s = -ps; c = -pc; break;
+		default: s = -pc; c = ps; break;
+	}
+}
+constexpr double sin(double x) {
+	double s = 0, c = 0;
+	sincos(x, s, c);
+	return s;
+}
+constexpr double cos(double x) {
+	double s = 0, c = 0;
+	sincos(x, s, c);
+	return c;
+}
+constexpr double tan(double x) {
+	double s = 0, c = 0;
+	sincos(x, s, c);
+	return s / c;
+}
+
+constexpr float sqrt(float x) { return (float)sqrt((double)x); }
+constexpr float sin(float x) { return (float)sin((double)x); }
+constexpr float cos(float x) { return (float)cos((double)x); }
+constexpr float tan(float x) { return (float)tan((double)x); }
+constexpr void sincos(float x, float& s, float& c) {
+	double ds = 0, dc = 0;
+	sincos((double)x, ds, dc);
+	s = (float)ds;
+	c = (float)dc;
+}
+
+/// std::array of fn(0) ... fn(N-1)
+template<std::size_t N, typename F>
+constexpr auto table(F fn) {
+	std::array<decltype(fn(std::size_t(0))), N> t{};
+	for(std::size_t i = 0; i < N; i++) t[i] = fn(i);
+	return t;
+}
+
+}
+
+/// std::sqrt at run time, cx::sqrt when constant evaluated.
+/// Integer arguments give a double, as std::sqrt does
+constexpr float sqrt(float x) {
+	if(std::is_constant_evaluated()) return cx::sqrt(x);
+	return std::sqrt(x);
+}
+constexpr double sqrt(double x) {
+	if(std::is_constant_evaluated()) return cx::sqrt(x);
+	return std::sqrt(x);
+}
+template<typename T> requires std::is_integral_v<T>
+constexpr double sqrt(T x) {
+	return sqrt((double)x);
+}
+
+}
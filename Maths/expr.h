@@ -0,0 +1,330 @@
+#pragma once
+///
+///	Lazy element-wise expressions over float2/3/4 streams.
+///
+/// float3_stream a, b, c, out;
+/// out = (a - b).normalised() * 2.0f + c;
+///
+/// Arithmetic on streams builds an expression tree without touching any
+/// data. Assigning it to a stream (or calling evaluate) runs the whole tree
+/// in one loop, a SIMD register of each component at a time, with no
+/// intermediate buffers.
+///
+/// Operands can be float2/3/4 streams or stream spans, other expressions,
+/// plain numbers, or a std::span/vector of floats with one value per
+/// element. One-component operands such as length() or a float array
+/// broadcast across the components of the other side.
+///
+/// Expressions hold pointers to their streams, so they must be evaluated
+/// before the streams are resized or destroyed. The output may be one of
+/// the inputs.
+///
+/// The expression is only known here, in the including translation unit,
+/// so the loop always uses 4 wide SSE registers whatever simdLevel() is.
+/// Wider code belongs in the runtime dispatched kernels (kernels.h).
+///
+#include <span>
+#include <type_traits>
+#include <vector>
+#include "simd.h"
+#include "streams.h"
+
+namespace maths::expr {
+
+/// The same register type in every translation unit. See above
+using wide = simd::f32x4;
+
+constexpr std::size_t ANY_SIZE = ~(std::size_t)0;
+
+/// Base of every expression node. E must have:
+///   static constexpr int components
+///   std::size_t size() const                        (ANY_SIZE for constants)
+///   template<typename V> void load(std::size_t i, V* out) const
+template<typename E>
+struct Expr {
+	const E& self() const { return static_cast<const E&>(*this); }
+
+	auto normalised() const;
+	auto length() const;
+	template<typename O> auto dot(const O& o) const;
+	template<typename O> auto cross(const O& o) const;
+};
+
+template<typename T>
+concept Node = std::is_base_of_v<Expr<T>, T>;
+
+/// Components of a stream
+template<int N>
+struct Stream final : Expr<Stream<N>> {
+	static constexpr int components = N;
+	const float* c[N];
+	std::size_t n;
+
+	std::size_t size() const { return n; }
+	template<typename V>
+	void load(std::size_t i, V* out) const {
+		for(int k = 0; k < N; k++) out[k] = V::load(c[k] + i);
+	}
+};
+/// One float per element
+struct Scalars final : Expr<Scalars> {
+	static constexpr int components = 1;
+	const float* p;
+	std::size_t n;
+
+	std::size_t size() const { return n; }
+	template<typename V>
+	void load(std::size_t i, V* out) const { out[0] = V::load(p + i); }
+};
+struct Constant final : Expr<Constant> {
+	static constexpr int components = 1;
+	float value;
+
+	std::size_t size() const { return ANY_SIZE; }
+	template<typename V>
+	void load(std::size_t, V* out) const { out[0] = V::set1(value); }
+};
+
+inline std::size_t commonSize(std::size_t a, std::size_t b) {
+	assert(a == b || a == ANY_SIZE || b == ANY_SIZE);
+	return a == ANY_SIZE ? b : a;
+}
+
+struct Add { template<typename V> static V apply(V a, V b) { return a + b; } };
+struct Sub { template<typename V> static V apply(V a, V b) { return a - b; } };
+struct Mul { template<typename V> static V apply(V a, V b) { return a * b; } };
+struct Div { template<typename V> static V apply(V a, V b) { return a / b; } };
+struct Min { template<typename V> static V apply(V a, V b) { return min(a, b); } };
+struct Max { template<typename V> static V apply(V a, V b) { return max(a, b); } };
+
+struct Neg { template<typename V> static V apply(V a) { return -a; } };
+struct Abs { template<typename V> static V apply(V a) { return abs(a); } };
+struct Sqrt { template<typename V> static V apply(V a) { return sqrt(a); } };
+
+/// Component-wise op. A one-component side is broadcast
+template<typename Op, typename L, typename R>
+struct Binary final : Expr<Binary<Op, L, R>> {
+	static_assert(L::components == R::components || L::components == 1 || R::components == 1);
+	static constexpr int components = L::components > R::components ? L::components : R::components;
+	L l;
+	R r;
+
+	Binary(const L& l, const R& r) : l(l), r(r) {}
+
+	std::size_t size() const { return commonSize(l.size(), r.size()); }
+	template<typename V>
+	void load(std::size_t i, V* out) const {
+		V a[L::components], b[R::components];
+		l.load(i, a);
+		r.load(i, b);
+		for(int k = 0; k < components; k++) {
+			out[k] = Op::apply(a[L::components == 1 ? 0 : k], b[R::components == 1 ? 0 : k]);
+		}
+	}
+};
+template<typename Op, typename E>
+struct Unary final : Expr<Unary<Op, E>> {
+	static constexpr int components = E::components;
+	E e;
+
+	explicit Unary(const E& e) : e(e) {}
+
+	std::size_t size() const { return e.size(); }
+	template<typename V>
+	void load(std::size_t i, V* out) const {
+		e.load(i, out);
+		for(int k = 0; k < components; k++) out[k] = Op::apply(out[k]);
+	}
+};
+template<typename L, typename R>
+struct Dot final : Expr<Dot<L, R>> {
+	static_assert(L::components == R::components);
+	static constexpr int components = 1;
+	L l;
+	R r;
+
+	Dot(const L& l, const R& r) : l(l), r(r) {}
+
+	std::size_t size() const { return commonSize(l.size(), r.size()); }
+	template<typename V>
+	void load(std::size_t i, V* out) const {
+		V a[L::components], b[R::components];
+		l.load(i, a);
+		r.load(i, b);
+		V d = a[0] * b[0];
+		for(int k = 1; k < L::components; k++) d = fmadd(a[k], b[k], d);
+		out[0] = d;
+	}
+};
+template<typename L, typename R>
+struct Cross final : Expr<Cross<L, R>> {
+	static_assert(L::components == 3 && R::components == 3);
+	static constexpr int components = 3;
+	L l;
+	R r;
+
+	Cross(const L& l, const R& r) : l(l), r(r) {}
+
+	std::size_t size() const { return commonSize(l.size(), r.size()); }
+	template<typename V>
+	void load(std::size_t i, V* out) const {
+		V a[3], b[3];
+		l.load(i, a);
+		r.load(i, b);
+		out[0] = a[1] * b[2] - a[2] * b[1];
+		out[1] = a[2] * b[0] - a[0] * b[2];
+		out[2] = a[0] * b[1] - a[1] * b[0];
+	}
+};
+template<typename E>
+struct Length final : Expr<Length<E>> {
+	static constexpr int components = 1;
+	E e;
+
+	explicit Length(const E& e) : e(e) {}
+
+	std::size_t size() const { return e.size(); }
+	template<typename V>
+	void load(std::size_t i, V* out) const {
+		V a[E::components];
+		e.load(i, a);
+		V d = a[0] * a[0];
+		for(int k = 1; k < E::components; k++) d = fmadd(a[k], a[k], d);
+		out[0] = sqrt(d);
+	}
+};
+template<typename E>
+struct Normalised final : Expr<Normalised<E>> {
+	static constexpr int components = E::components;
+	E e;
+
+	explicit Normalised(const E& e) : e(e) {}
+
+	std::size_t size() const { return e.size(); }
+	template<typename V>
+	void load(std::size_t i, V* out) const {
+		e.load(i, out);
+		V d = out[0] * out[0];
+		for(int k = 1; k < components; k++) d = fmadd(out[k], out[k], d);
+		const V len = sqrt(d);
+		for(int k = 0; k < components; k++) out[k] = out[k] / len;
+	}
+};
+
+/// Anything that can be an operand
+template<Node E> const E& toExpr(const E& e) { return e; }
+inline Stream<2> toExpr(cfloat2_span s) { return {{}, {s.x.data(), s.y.data()}, s.size()}; }
+inline Stream<3> toExpr(cfloat3_span s) { return {{}, {s.x.data(), s.y.data(), s.z.data()}, s.size()}; }
+inline Stream<4> toExpr(cfloat4_span s) { return {{}, {s.x.data(), s.y.data(), s.z.data(), s.w.data()}, s.size()}; }
+inline Stream<2> toExpr(const float2_span& s) { return toExpr(cfloat2_span(s)); }
+inline Stream<3> toExpr(const float3_span& s) { return toExpr(cfloat3_span(s)); }
+inline Stream<4> toExpr(const float4_span& s) { return toExpr(cfloat4_span(s)); }
+inline Stream<2> toExpr(const float2_stream& s) { return toExpr(cfloat2_span(s)); }
+inline Stream<3> toExpr(const float3_stream& s) { return toExpr(cfloat3_span(s)); }
+inline Stream<4> toExpr(const float4_stream& s) { return toExpr(cfloat4_span(s)); }
+inline Scalars toExpr(std::span<const float> s) { return {{}, s.data(), s.size()}; }
+inline Scalars toExpr(const std::vector<float>& s) { return {{}, s.data(), s.size()}; }
+template<typename T> requires std::is_arithmetic_v<T>
+Constant toExpr(T v) { return {{}, (float)v}; }
+
+template<typename T>
+using expr_t = std::decay_t<decltype(toExpr(std::declval<const T&>()))>;
+
+/// A stream or an expression. At least one operand must be one of these
+template<typename T>
+concept Source = Node<T> ||
+	std::is_same_v<T, float2_stream> || std::is_same_v<T, float3_stream> || std::is_same_v<T, float4_stream> ||
+	std::is_same_v<T, float2_span> || std::is_same_v<T, float3_span> || std::is_same_v<T, float4_span> ||
+	std::is_same_v<T, cfloat2_span> || std::is_same_v<T, cfloat3_span> || std::is_same_v<T, cfloat4_span>;
+
+template<typename T>
+concept Operand = requires(const T& t) { toExpr(t); };
+
+template<typename L, typename R>
+concept Operands = (Source<L> || Source<R>) && Operand<L> && Operand<R>;
+
+template<typename L, typename R> requires Operands<L, R>
+auto operator+(const L& l, const R& r) { return Binary<Add, expr_t<L>, expr_t<R>>(toExpr(l), toExpr(r)); }
+template<typename L, typename R> requires Operands<L, R>
+auto operator-(const L& l, const R& r) { return Binary<Sub, expr_t<L>, expr_t<R>>(toExpr(l), toExpr(r)); }
+template<typename L, typename R> requires Operands<L, R>
+auto operator*(const L& l, const R& r) { return Binary<Mul, expr_t<L>, expr_t<R>>(toExpr(l), toExpr(r)); }
+template<typename L, typename R> requires Operands<L, R>
+auto operator/(const L& l, const R& r) { return Binary<Div, expr_t<L>, expr_t<R>>(toExpr(l), toExpr(r)); }
+template<typename E> requires Source<E>
+auto operator-(const E& e) { return Unary<Neg, expr_t<E>>(toExpr(e)); }
+
+template<typename L, typename R> requires Operand<L> && Operand<R>
+auto min(const L& l, const R& r) { return Binary<Min, expr_t<L>, expr_t<R>>(toExpr(l), toExpr(r)); }
+template<typename L, typename R> requires Operand<L> && Operand<R>
+auto max(const L& l, const R& r) { return Binary<Max, expr_t<L>, expr_t<R>>(toExpr(l), toExpr(r)); }
+template<typename E> requires Operand<E>
+auto abs(const E& e) { return Unary<Abs, expr_t<E>>(toExpr(e)); }
+template<typename E> requires Operand<E>
+auto sqrt(const E& e) { return Unary<Sqrt, expr_t<E>>(toExpr(e)); }
+template<typename L, typename R> requires Operand<L> && Operand<R>
+auto dot(const L& l, const R& r) { return Dot<expr_t<L>, expr_t<R>>(toExpr(l), toExpr(r)); }
+template<typename L, typename R> requires Operand<L> && Operand<R>
+auto cross(const L& l, const R& r) { return Cross<expr_t<L>, expr_t<R>>(toExpr(l), toExpr(r)); }
+template<typename E> requires Operand<E>
+auto length(const E& e) { return Length<expr_t<E>>(toExpr(e)); }
+template<typename E> requires Operand<E>
+auto normalised(const E& e) { return Normalised<expr_t<E>>(toExpr(e)); }
+/// a + (b-a)*t
+template<typename A, typename B, typename T> requires Operand<A> && Operand<B> && Operand<T>
+auto lerp(const A& a, const B& b, const T& t) { return toExpr(a) + (toExpr(b) - toExpr(a)) * toExpr(t); }
+
+template<typename E> auto Expr<E>::normalised() const { return Normalised<E>(self()); }
+template<typename E> auto Expr<E>::length() const { return Length<E>(self()); }
+template<typename E> template<typename O> auto Expr<E>::dot(const O& o) const { return expr::dot(self(), o); }
+template<typename E> template<typename O> auto Expr<E>::cross(const O& o) const { return expr::cross(self(), o); }
+
+/// Run e over every element writing component k to out[k]
+template<typename E>
+void evaluate(const Expr<E>& expression, float* const* out, std::size_t n) {
+	const E& e = expression.self();
+	assert(e.size() == n || e.size() == ANY_SIZE);
+	constexpr int N = E::components;
+
+	std::size_t i = 0;
+	for(; i + wide::width <= n; i += wide::width) {
+		wide v[N];
+		e.load(i, v);
+		for(int k = 0; k < N; k++) v[k].store(out[k] + i);
+	}
+	for(; i < n; i++) {
+		simd::f32x1 v[N];
+		e.load(i, v);
+		for(int k = 0; k < N; k++) v[k].store(out[k] + i);
+	}
+}
+template<typename E> requires (E::components == 1)
+void evaluate(const Expr<E>& e, std::span<float> out) {
+	float* p[] = {out.data()};
+	evaluate(e, p, out.size());
+}
+template<typename E> requires (E::components == 2)
+void evaluate(const Expr<E>& e, float2_span out) {
+	float* p[] = {out.x.data(), out.y.data()};
+	evaluate(e, p, out.size());
+}
+template<typename E> requires (E::components == 3)
+void evaluate(const Expr<E>& e, float3_span out) {
+	float* p[] = {out.x.data(), out.y.data(), out.z.data()};
+	evaluate(e, p, out.size());
+}
+template<typename E> requires (E::components == 4)
+void evaluate(const Expr<E>& e, float4_span out) {
+	float* p[] = {out.x.data(), out.y.data(), out.z.data(), out.w.data()};
+	evaluate(e, p, out.size());
+}
+
+}
+
+namespace maths {
+/// So that arithmetic on streams finds the operators
+using expr::operator+;
+using expr::operator-;
+using expr::operator*;
+using expr::operator/;
+}
@@ -0,0 +1,172 @@
+#pragma once
+///
+///	Open addressing hash map for small trivially copyable keys such as
+/// int3 voxel coordinates or uint2 grid cells.
+///
+/// flat_map<int3, Chunk*> chunks;
+/// chunks[{1, 2, 3}] = chunk;
+/// if(auto p = chunks.find({1, 2, 3})) { ... }
+///
+/// Entries live in one contiguous array probed linearly, with a parallel
+/// byte array holding a 7 bit tag of each hash so most mismatches are
+/// rejected without touching the entries. Capacity is a power of two and
+/// the load factor is kept below 3/4. Erase shifts the following entries
+/// back so there are no tombstones.
+///
+/// Values must be default constructible. Inserting a new key or erasing
+/// invalidates pointers and iterators. Looking up an existing key with
+/// insert or operator[] does not.
+///
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace maths {
+
+template<typename K, typename V, typename Hash = typename K::HashFunc>
+class flat_map final {
+public:
+	typedef std::pair<K, V> value_type;
+
+	flat_map() = default;
+	explicit flat_map(std::size_t n) { reserve(n); }
+
+	std::size_t size() const { return count; }
+	bool empty() const { return count == 0; }
+	std::size_t capacity() const { return slots.size(); }
+
+	void clear() {
+		slots.clear();
+		tags.clear();
+		count = 0;
+	}
+	/// Make room for n entries without rehashing
+	void reserve(std::size_t n) {
+		std::size_t cap = 16;
+		while(cap * 3 / 4 < n) cap *= 2;
+		if(cap > capacity()) rehash(cap);
+	}
+
+	V* find(const K& key) {
+		const std::size_t i = indexOf(key);
+		return i == NONE ? nullptr : &slots[i].second;
+	}
+	const V* find(const K& key) const {
+		return const_cast<flat_map*>(this)->find(key);
+	}
+	bool contains(const K& key) const {
+		return indexOf(key) != NONE;
+	}
+	/// Insert a default constructed value if the key is not present
+	V& operator[](const K& key) {
+		return *insert(key, V{}).first;
+	}
+	/// Insert if not present. Returns the value and whether it was inserted
+	std::pair<V*, bool> insert(const K& key, const V& value) {
+		if(capacity() == 0) rehash(16);
+		const std::size_t h = Hash{}(key);
+		const uint8_t tag = tagOf(h);
+		std::size_t mask = capacity() - 1;
+		std::size_t i = h & mask;
+		for(; tags[i] != EMPTY; i = (i + 1) & mask) {
+			if(tags[i] == tag && slots[i].first == key) {
+				return {&slots[i].second, false};
+			}
+		}
+		/// Only grow when the key is really new, then find its empty slot again
+		if((count + 1) * 4 > capacity() * 3) {
+			rehash(capacity() * 2);
+			mask = capacity() - 1;
+			for(i = h & mask; tags[i] != EMPTY; i = (i + 1) & mask) {}
+		}
+		tags[i] = tag;
+		slots[i] = {key, value};
+		count++;
+		return {&slots[i].second, true};
+	}
+	/// Returns true if the key was present
+	bool erase(const K& key) {
+		std::size_t i = indexOf(key);
+		if(i == NONE) return false;
+
+		/// Shift back any following entries that would otherwise become
+		/// unreachable from their home slot
+		const std::size_t mask = capacity() - 1;
+		for(std::size_t j = (i + 1) & mask; tags[j] != EMPTY; j = (j + 1) & mask) {
+			const std::size_t home = Hash{}(slots[j].first) & mask;
+			if(((j - home) & mask) >= ((j - i) & mask)) {
+				tags[i] = tags[j];
+				slots[i] = std::move(slots[j]);
+				i = j;
+			}
+		}
+		tags[i] = EMPTY;
+		slots[i] = {};
+		count--;
+		return true;
+	}
+
+	template<typename S>
+	class iter final {
+	public:
+		iter(S* map, std::size_t i) : map(map), i(i) { skip(); }
+
+		auto& operator*() const { return map->slots[i]; }
+		auto* operator->() const { return &map->slots[i]; }
+		iter& operator++() { i++; skip(); return *this; }
+		bool operator==(const iter& o) const { return i == o.i; }
+		bool operator!=(const iter& o) const { return i != o.i; }
+	private:
+		S* map;
+		std::size_t i;
+
+		void skip() { while(i < map->capacity() && map->tags[i] == EMPTY) i++; }
+	};
+	typedef iter<flat_map> iterator;
+	typedef iter<const flat_map> const_iterator;
+
+	/// The key of an entry must not be modified through an iterator
+	iterator begin() { return {this, 0}; }
+	iterator end() { return {this, capacity()}; }
+	const_iterator begin() const { return {this, 0}; }
+	const_iterator end() const { return {this, capacity()}; }
+private:
+	static constexpr uint8_t EMPTY = 0;
+	static constexpr std::size_t NONE = ~(std::size_t)0;
+
+	std::vector<value_type> slots;
+	std::vector<uint8_t> tags;
+	std::size_t count = 0;
+
+	/// Top 7 bits of the hash with the high bit set so it is never EMPTY
+	static uint8_t tagOf(std::size_t h) {
+		return (uint8_t)(0x80 | (h >> (sizeof(std::size_t) * 8 - 7)));
+	}
+	std::size_t indexOf(const K& key) const {
+		if(count == 0) return NONE;
+		const std::size_t h = Hash{}(key);
+		const uint8_t tag = tagOf(h);
+		const std::size_t mask = capacity() - 1;
+		for(std::size_t i = h & mask; tags[i] != EMPTY; i = (i + 1) & mask) {
+			if(tags[i] == tag && slots[i].first == key) return i;
+		}
+		return NONE;
+	}
+	void rehash(std::size_t cap) {
+		std::vector<value_type> oldSlots(cap);
+		std::vector<uint8_t> oldTags(cap, EMPTY);
+		oldSlots.swap(slots);
+		oldTags.swap(tags);
+
+		const std::size_t mask = cap - 1;
+		for(std::size_t j = 0; j < oldTags.size(); j++) {
+			if(oldTags[j] == EMPTY) continue;
+			std::size_t i = Hash{}(oldSlots[j].first) & mask;
+			while(tags[i] != EMPTY) i = (i + 1) & mask;
+			tags[i] = oldTags[j];
+			slots[i] = std::move(oldSlots[j]);
+		}
+	}
+};
+
+}
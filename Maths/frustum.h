@@ -0,0 +1,165 @@
+#pragma once
+///
+///	View frustum planes and batch frustum culling.
+///
+/// frustum f = frustum::fromCamera(camera);
+/// std::vector<uint64_t> mask(maskWords(centres.size()));
+/// cullSpheres(f, centres, radii, mask);
+///
+/// std::vector<uint32_t> visible;
+/// cullSpheres(f, centres, radii, visible);
+///
+/// The planes are extracted from a view-projection matrix for the [0, 1]
+/// depth range of the matrix4 projections and normalised so that plane
+/// distances are in world units. Given a model-view-projection matrix the
+/// planes are in model space instead.
+///
+/// The batch functions take SoA streams (see streams.h) and test V::width
+/// objects at once against all 6 planes in the runtime selected kernels.
+/// Large inputs are split into chunks of 16384 across the threads in
+/// parallel.h. The results are either masks as used by masks.h or the
+/// visible indices in increasing order.
+///
+/// The tests are conservative. An object is only culled if it is entirely
+/// outside one of the planes, so some objects near the corners of the
+/// frustum are reported visible.
+///
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+#include "kernels.h"
+#include "masks.h"
+#include "parallel.h"
+#include "reduce.h"
+#include "streams.h"
+
+namespace maths {
+
+struct frustum final {
+	/// Left, right, bottom, top, near and far. xyz is the inward facing unit
+	/// normal and p is inside a plane if dot(xyz, p) + w >= 0
+	float4 planes[6];
+
+	static frustum fromMatrix(const matrix& m) {
+		const float4 r0{m[0][0], m[1][0], m[2][0], m[3][0]};
+		const float4 r1{m[0][1], m[1][1], m[2][1], m[3][1]};
+		const float4 r2{m[0][2], m[1][2], m[2][2], m[3][2]};
+		const float4 r3{m[0][3], m[1][3], m[2][3], m[3][3]};
+		frustum f{{r3 + r0, r3 - r0, r3 + r1, r3 - r1, r2, r3 - r2}};
+		for(auto& p : f.planes) {
+			p /= float3{p.x, p.y, p.z}.length();
+		}
+		return f;
+	}
+	static frustum fromCamera(Camera& camera) {
+		return fromMatrix(camera.VP());
+	}
+
+	/// Signed distance from plane i to p
+	float distance(int i, const float3& p) const {
+		return planes[i].x * p.x + planes[i].y * p.y + planes[i].z * p.z + planes[i].w;
+	}
+	bool contains(const float3& p) const {
+		return intersects(p, 0);
+	}
+	bool intersects(const float3& centre, float radius) const {
+		for(int i = 0; i < 6; i++) {
+			if(distance(i, centre) < -radius) return false;
+		}
+		return true;
+	}
+	bool intersects(const aabb3& box) const {
+		const float3 c = box.centre(), e = box.size() * 0.5f;
+		for(auto& p : planes) {
+			const float r = e.x * std::fabs(p.x) + e.y * std::fabs(p.y) + e.z * std::fabs(p.z);
+			if(p.x * c.x + p.y * c.y + p.z * c.z + p.w < -r) return false;
+		}
+		return true;
+	}
+};
+
+namespace detail {
+
+constexpr std::size_t CULL_CHUNK = 1 << 14;
+
+inline std::size_t cullChunks(std::size_t n) {
+	return (n + CULL_CHUNK - 1) / CULL_CHUNK;
+}
+/// chunk(begin, count, mask) writes the mask words of one chunk
+template<typename Cull>
+void cull(std::size_t n, std::span<uint64_t> mask, Cull chunk) {
+	assert(mask.size() >= maskWords(n));
+	parallel::forEach(cullChunks(n), [&](std::size_t c) {
+		const std::size_t begin = c * CULL_CHUNK;
+		chunk(begin, std::min(CULL_CHUNK, n - begin), mask.data() + begin / 64);
+	});
+}
+/// Each chunk is culled and counted, then the chunks are compacted in
+/// parallel at their offsets
+template<typename Cull>
+void cull(std::size_t n, std::vector<uint32_t>& visible, Cull chunk) {
+	std::vector<uint64_t> mask(maskWords(n));
+	std::vector<std::size_t> offset(cullChunks(n) + 1);
+	const auto words = [&](std::size_t c) {
+		const std::size_t begin = c * (CULL_CHUNK / 64);
+		return std::span<const uint64_t>(mask).subspan(begin, std::min(CULL_CHUNK / 64, mask.size() - begin));
+	};
+	parallel::forEach(offset.size() - 1, [&](std::size_t c) {
+		const std::size_t begin = c * CULL_CHUNK;
+		chunk(begin, std::min(CULL_CHUNK, n - begin), mask.data() + begin / 64);
+		offset[c + 1] = countSet(words(c));
+	});
+	for(std::size_t c = 1; c < offset.size(); c++) offset[c] += offset[c - 1];
+
+	visible.resize(offset.back());
+	parallel::forEach(offset.size() - 1, [&](std::size_t c) {
+		const auto out = std::span<uint32_t>(visible).subspan(offset[c], offset[c + 1] - offset[c]);
+		compact(words(c), out);
+		for(auto& i : out) i += (uint32_t)(c * CULL_CHUNK);
+	});
+}
+inline auto spheres(const frustum& f, cfloat3_span centres, const float* radii) {
+	return [&f, centres, radii](std::size_t begin, std::size_t count, uint64_t* mask) {
+		kernels::table().cullSpheres(&f.planes[0].x,
+			{{centres.x.data() + begin, centres.y.data() + begin, centres.z.data() + begin, nullptr}},
+			radii ? radii + begin : nullptr, mask, count);
+	};
+}
+inline auto aabbs(const frustum& f, cfloat3_span lo, cfloat3_span hi) {
+	return [&f, lo, hi](std::size_t begin, std::size_t count, uint64_t* mask) {
+		kernels::table().cullAabbs(&f.planes[0].x,
+			{{lo.x.data() + begin, lo.y.data() + begin, lo.z.data() + begin, nullptr}},
+			{{hi.x.data() + begin, hi.y.data() + begin, hi.z.data() + begin, nullptr}}, mask, count);
+	};
+}
+
+}
+
+/// mask[i] = f.contains(points[i])
+inline void cullPoints(const frustum& f, cfloat3_span points, std::span<uint64_t> mask) {
+	detail::cull(points.size(), mask, detail::spheres(f, points, nullptr));
+}
+inline void cullPoints(const frustum& f, cfloat3_span points, std::vector<uint32_t>& visible) {
+	detail::cull(points.size(), visible, detail::spheres(f, points, nullptr));
+}
+/// mask[i] = f.intersects(centres[i], radii[i])
+inline void cullSpheres(const frustum& f, cfloat3_span centres, std::span<const float> radii, std::span<uint64_t> mask) {
+	assert(centres.size() == radii.size());
+	detail::cull(centres.size(), mask, detail::spheres(f, centres, radii.data()));
+}
+inline void cullSpheres(const frustum& f, cfloat3_span centres, std::span<const float> radii, std::vector<uint32_t>& visible) {
+	assert(centres.size() == radii.size());
+	detail::cull(centres.size(), visible, detail::spheres(f, centres, radii.data()));
+}
+/// mask[i] = f.intersects(aabb3{lo[i], hi[i]})
+inline void cullAabbs(const frustum& f, cfloat3_span lo, cfloat3_span hi, std::span<uint64_t> mask) {
+	assert(lo.size() == hi.size());
+	detail::cull(lo.size(), mask, detail::aabbs(f, lo, hi));
+}
+inline void cullAabbs(const frustum& f, cfloat3_span lo, cfloat3_span hi, std::vector<uint32_t>& visible) {
+	assert(lo.size() == hi.size());
+	detail::cull(lo.size(), visible, detail::aabbs(f, lo, hi));
+}
+
+}
@@ -0,0 +1,58 @@
+#pragma once
+///
+///	Hashing for the vector types.
+///
+/// std::size_t h = hash::values(v.x, v.y, v.z);
+///
+/// Each component is folded in with a wyhash style multiply-xorshift
+/// (the 128 bit product of two 64 bit values with its halves xor'ed
+/// together) so every input bit affects every output bit. Floats hash
+/// their bit pattern with -0 treated as 0 so that equal keys hash equal.
+///
+#include <bit>
+#include <cstdint>
+#include <type_traits>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace maths::hash {
+
+constexpr uint64_t SEED  = 0xa0761d6478bd642full;
+constexpr uint64_t PRIME = 0xe7037ed1a0b428dbull;
+constexpr uint64_t FINAL = 0x8ebc6af09c88c6e3ull;
+
+/// 64 x 64 -> 128 bit multiply, high xor low
+inline uint64_t mum(uint64_t a, uint64_t b) {
+#if defined(_MSC_VER)
+	uint64_t hi;
+	const uint64_t lo = _umul128(a, b, &hi);
+	return lo ^ hi;
+#else
+	const unsigned __int128 r = (unsigned __int128)a * b;
+	return (uint64_t)r ^ (uint64_t)(r >> 64);
+#endif
+}
+
+template<typename T>
+uint64_t bitsOf(T v) {
+	static_assert(std::is_arithmetic_v<T>);
+	if constexpr(std::is_same_v<T, float>) {
+		return v == 0 ? 0 : std::bit_cast<uint32_t>(v);
+	} else if constexpr(std::is_same_v<T, double>) {
+		return v == 0 ? 0 : std::bit_cast<uint64_t>(v);
+	} else {
+		return (uint64_t)v;
+	}
+}
+
+/// Hash of all the values in order
+template<typename... T>
+std::size_t values(T... v) {
+	uint64_t h = SEED;
+	((h = mum(h ^ bitsOf(v), PRIME)), ...);
+	return (std::size_t)mum(h, FINAL);
+}
+
+}
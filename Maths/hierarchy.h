@@ -0,0 +1,213 @@
+#pragma once
+///
+///	A transform hierarchy stored in flat arrays sorted by depth.
+///
+/// hierarchy h;
+/// auto body = h.add(hierarchy::NONE, {0, 1, 0});
+/// auto arm  = h.add(body, {0.5f, 0, 0}, quat::rotateZ(0.3f));
+/// h.setRotation(arm, quat::rotateZ(0.6f));
+/// h.update();
+/// const affine& w = h.world(arm);
+///
+/// Nodes are referred to by the handle returned from add(), which stays
+/// valid while the arrays are reordered. Local transforms are translation,
+/// rotation and scale (applied scale first) and world transforms are
+/// affine = parent world * local.
+///
+/// Setting a local transform marks the node dirty. update() walks the
+/// depths in order, so that every parent is final before its children
+/// are read, and recomputes the world transform of each dirty node and
+/// of every node below one. Each depth is split into chunks of 4096 nodes
+/// across the threads in parallel.h and the compose uses the SSE rows of
+/// affine.
+///
+/// Adding a node shallower than the last one added marks the arrays as
+/// unsorted and the next update() counting sorts them by depth. Nodes
+/// added in depth order (eg. breadth first) never need sorting.
+///
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+#include "parallel.h"
+
+namespace maths {
+
+class hierarchy final {
+public:
+	typedef uint32_t handle;
+	static constexpr handle NONE = 0xffffffff;
+
+	std::size_t size() const { return parents.size(); }
+	bool empty() const { return parents.empty(); }
+	/// Number of distinct depths. Valid after update()
+	std::size_t depthCount() const { return levels.size() - 1; }
+
+	void reserve(std::size_t n) {
+		translations.reserve(n);
+		rotations.reserve(n);
+		scales.reserve(n);
+		parents.reserve(n);
+		depths.reserve(n);
+		handles.reserve(n);
+		worldTransforms.reserve(n);
+		dirty.reserve(n);
+		indices.reserve(n);
+	}
+	void clear() {
+		*this = hierarchy();
+	}
+
+	/// Add a node under parent, or a root if parent is NONE
+	handle add(handle parent, const float3& translation, const quat& rotation = quat::identity(),
+			   const float3& scale = {1, 1, 1})
+	{
+		const uint32_t p = parent == NONE ? NONE : index(parent);
+		const uint32_t depth = p == NONE ? 0 : depths[p] + 1;
+		if(!depths.empty() && depth < depths.back()) sorted = false;
+		if(sorted) {
+			if(depth + 1 == levels.size()) levels.push_back(size() + 1);
+			else levels.back() = size() + 1;
+		}
+
+		const handle h = (handle)indices.size();
+		indices.push_back((uint32_t)size());
+		translations.push_back(translation);
+		rotations.push_back(rotation);
+		scales.push_back(scale);
+		parents.push_back(p);
+		depths.push_back(depth);
+		handles.push_back(h);
+		worldTransforms.push_back(affine::identity());
+		dirty.push_back(1);
+		anyDirty = true;
+		return h;
+	}
+
+	handle parent(handle h) const {
+		const uint32_t p = parents[index(h)];
+		return p == NONE ? NONE : handles[p];
+	}
+	const float3& translation(handle h) const { return translations[index(h)]; }
+	const quat& rotation(handle h) const { return rotations[index(h)]; }
+	const float3& scale(handle h) const { return scales[index(h)]; }
+
+	void setTranslation(handle h, const float3& t) {
+		translations[touch(h)] = t;
+	}
+	void setRotation(handle h, const quat& r) {
+		rotations[touch(h)] = r;
+	}
+	void setScale(handle h, const float3& s) {
+		scales[touch(h)] = s;
+	}
+	void setLocal(handle h, const float3& t, const quat& r, const float3& s) {
+		const uint32_t i = touch(h);
+		translations[i] = t;
+		rotations[i] = r;
+		scales[i] = s;
+	}
+
+	/// The world transform as of the last update()
+	const affine& world(handle h) const { return worldTransforms[index(h)]; }
+	matrix worldMatrix(handle h) const { return world(h).toMatrix(); }
+	/// Every world transform in depth order. worlds()[i] belongs to handleAt(i)
+	std::span<const affine> worlds() const { return worldTransforms; }
+	handle handleAt(std::size_t i) const { return handles[i]; }
+
+	/// Sort if needed and recompute the world transform of every dirty node and its descendants
+	void update() {
+		if(!sorted) sort();
+		if(!anyDirty) return;
+
+		for(std::size_t d = 0; d + 1 < levels.size(); d++) {
+			const std::size_t begin = levels[d], n = levels[d + 1] - begin;
+			parallel::forEach((n + CHUNK - 1) / CHUNK, [&](std::size_t c) {
+				const std::size_t from = begin + c * CHUNK, to = from + std::min(CHUNK, n - c * CHUNK);
+				for(std::size_t i = from; i < to; i++) {
+					const uint32_t p = parents[i];
+					if(p != NONE) dirty[i] |= dirty[p];
+					if(!dirty[i]) continue;
+					const affine local = trs(translations[i], rotations[i], scales[i]);
+					worldTransforms[i] = p == NONE ? local : worldTransforms[p] * local;
+				}
+			});
+		}
+		std::fill(dirty.begin(), dirty.end(), (uint8_t)0);
+		anyDirty = false;
+	}
+private:
+	static constexpr std::size_t CHUNK = 4096;
+
+	/// Per node in depth order
+	std::vector<float3> translations;
+	std::vector<quat> rotations;
+	std::vector<float3> scales;
+	std::vector<uint32_t> parents;		/// index of the parent or NONE
+	std::vector<uint32_t> depths;
+	std::vector<handle> handles;
+	std::vector<affine> worldTransforms;
+	std::vector<uint8_t> dirty;
+	/// indices[handle] = index of the node
+	std::vector<uint32_t> indices;
+	/// Depth d is [levels[d], levels[d + 1])
+	std::vector<std::size_t> levels{0};
+	bool sorted = true;
+	bool anyDirty = false;
+
+	uint32_t index(handle h) const {
+		assert(h < indices.size());
+		return indices[h];
+	}
+	uint32_t touch(handle h) {
+		const uint32_t i = index(h);
+		dirty[i] = 1;
+		anyDirty = true;
+		return i;
+	}
+	/// translate(t) * rotation * scale(s)
+	static affine trs(const float3& t, const quat& r, const float3& s) {
+		const float xx = r.x * r.x, yy = r.y * r.y, zz = r.z * r.z;
+		const float xy = r.x * r.y, xz = r.x * r.z, yz = r.y * r.z;
+		const float wx = r.w * r.x, wy = r.w * r.y, wz = r.w * r.z;
+		return {
+			float4{1 - 2 * (yy + zz), 2 * (xy - wz), 2 * (xz + wy), t.x} * float4{s.x, s.y, s.z, 1},
+			float4{2 * (xy + wz), 1 - 2 * (xx + zz), 2 * (yz - wx), t.y} * float4{s.x, s.y, s.z, 1},
+			float4{2 * (xz - wy), 2 * (yz + wx), 1 - 2 * (xx + yy), t.z} * float4{s.x, s.y, s.z, 1}
+		};
+	}
+	/// Stable counting sort by depth. Keeps the levels up to date
+	void sort() {
+		std::size_t maxDepth = 0;
+		for(uint32_t d : depths) maxDepth = std::max<std::size_t>(maxDepth, d);
+		levels.assign(maxDepth + 2, 0);
+		for(uint32_t d : depths) levels[d + 1]++;
+		for(std::size_t d = 1; d < levels.size(); d++) levels[d] += levels[d - 1];
+
+		std::vector<std::size_t> next(levels.begin(), levels.end() - 1);
+		std::vector<uint32_t> to(size());
+		for(std::size_t i = 0; i < size(); i++) to[i] = (uint32_t)next[depths[i]]++;
+
+		permute(translations, to);
+		permute(rotations, to);
+		permute(scales, to);
+		permute(depths, to);
+		permute(handles, to);
+		permute(worldTransforms, to);
+		permute(dirty, to);
+		for(uint32_t& p : parents) {
+			if(p != NONE) p = to[p];
+		}
+		permute(parents, to);
+		for(std::size_t i = 0; i < size(); i++) indices[handles[i]] = (uint32_t)i;
+		sorted = true;
+	}
+	template<typename E>
+	static void permute(std::vector<E>& v, const std::vector<uint32_t>& to) {
+		std::vector<E> r(v.size());
+		for(std::size_t i = 0; i < v.size(); i++) r[to[i]] = v[i];
+		v.swap(r);
+	}
+};
+
+}
@@ -0,0 +1,135 @@
+#include "_pch.h"
+#include "maths.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <immintrin.h>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+
+namespace maths {
+
+namespace {
+
+void cpuid(int leaf, int subleaf, unsigned int r[4]) {
+#if defined(_MSC_VER)
+	int regs[4];
+	__cpuidex(regs, leaf, subleaf);
+	for(int i = 0; i < 4; i++) r[i] = (unsigned int)regs[i];
+#else
+	__cpuid_count(leaf, subleaf, r[0], r[1], r[2], r[3]);
+#endif
+}
+unsigned long long xgetbv0() {
+#if defined(_MSC_VER)
+	return _xgetbv(0);
+#else
+	unsigned int a, d;
+	__asm__ volatile("xgetbv" : "=a"(a), "=d"(d) : "c"(0));
+	return ((unsigned long long)d << 32) | a;
+#endif
+}
+bool bit(unsigned int v, int b) {
+	return (v & (1u << b)) != 0;
+}
+
+SimdLevel detect() {
+	unsigned int r[4];
+	cpuid(0, 0, r);
+	const unsigned int maxLeaf = r[0];
+	if(maxLeaf < 7) return SimdLevel::SSE2;
+
+	cpuid(1, 0, r);
+	const bool osxsave = bit(r[2], 27);
+	const bool avx     = bit(r[2], 28);
+	const bool fma     = bit(r[2], 12);
+	const bool f16c    = bit(r[2], 29);
+	if(!osxsave || !avx || !fma || !f16c) return SimdLevel::SSE2;
+
+	/// The OS must save the XMM and YMM (and for AVX-512 the opmask and ZMM) state
+	const unsigned long long xcr0 = xgetbv0();
+	if((xcr0 & 0x6) != 0x6) return SimdLevel::SSE2;
+
+	cpuid(7, 0, r);
+	const bool avx2 = bit(r[1], 5);
+	const bool bmi2 = bit(r[1], 8);
+	if(!avx2 || !bmi2) return SimdLevel::SSE2;
+
+	const bool avx512 = bit(r[1], 16) && bit(r[1], 17) && bit(r[1], 30) && bit(r[1], 31);
+	if(avx512 && (xcr0 & 0xe6) == 0xe6) return SimdLevel::AVX512;
+
+	return SimdLevel::AVX2;
+}
+
+/// MATHS_SIMD=sse2|avx2|avx512
+SimdLevel fromEnvironment(SimdLevel level) {
+	char value[16] = {};
+#if defined(_MSC_VER)
+	size_t len = 0;
+	if(getenv_s(&len, value, sizeof(value), "MATHS_SIMD") != 0 || len == 0) return level;
+#else
+	const char* e = std::getenv("MATHS_SIMD");
+	if(!e) return level;
+	std::strncpy(value, e, sizeof(value) - 1);
+#endif
+	if(std::strcmp(value, "sse2") == 0) return SimdLevel::SSE2;
+	if(std::strcmp(value, "avx2") == 0) return std::min(level, SimdLevel::AVX2);
+	if(std::strcmp(value, "avx512") == 0) return std::min(level, SimdLevel::AVX512);
+	return level;
+}
+
+/// Each table is built on first use only. makeTable is compiled for its own
+/// instruction set so a level above detectedSimdLevel() must never be built.
+const kernels::Table& tableFor(SimdLevel level) {
+	switch(level) {
+		case SimdLevel::AVX512: {
+			static const kernels::Table t = kernels::avx512Table();
+			return t;
+		}
+		case SimdLevel::AVX2: {
+			static const kernels::Table t = kernels::avx2Table();
+			return t;
+		}
+		default: {
+			static const kernels::Table t = kernels::sse2Table();
+			return t;
+		}
+	}
+}
+
+std::atomic<const kernels::Table*>& active() {
+	static std::atomic<const kernels::Table*> table{&tableFor(fromEnvironment(detectedSimdLevel()))};
+	return table;
+}
+
+}
+
+SimdLevel detectedSimdLevel() {
+	static const SimdLevel level = detect();
+	return level;
+}
+SimdLevel simdLevel() {
+	return kernels::table().level;
+}
+void setSimdLevel(SimdLevel level) {
+	active().store(&tableFor(std::min(level, detectedSimdLevel())));
+}
+const char* toString(SimdLevel level) {
+	switch(level) {
+		case SimdLevel::SSE2: return "SSE2";
+		case SimdLevel::AVX2: return "AVX2";
+		case SimdLevel::AVX512: return "AVX512";
+	}
+	return "?";
+}
+
+const kernels::Table& kernels::table() {
+	return *active().load(std::memory_order_relaxed);
+}
+
+}
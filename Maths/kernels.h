@@ -0,0 +1,170 @@
+#pragma once
+///
+///	Runtime selected batch kernels.
+///
+/// Every kernel is compiled once per instruction set (kernels_sse2.cpp,
+/// kernels_avx2.cpp and kernels_avx512.cpp) and the best table supported
+/// by the CPU is selected on first use.
+///
+/// The level can be forced lower for testing by setting the MATHS_SIMD
+/// environment variable to sse2, avx2 or avx512, or by calling setSimdLevel().
+///
+/// The ISA specific translation units only include this header, simd.h,
+/// trig.h and morton.inl so that no shared inline code is compiled with the wider instruction set.
+/// simd.h and trig.h are in a namespace per instruction set and morton.inl and
+/// kernels.inl are included inside one. The Maths project checks after a build
+/// that the SSE2 objects contain no VEX encoded instructions.
+///
+/// The kernel objects are always built with /fp:precise, so the Kahan
+/// summation in sum and the order of operations that lets the double
+/// kernels match the dmatrix and double4 members are kept in /fp:fast builds.
+///
+#include <cstddef>
+#include <cstdint>
+
+namespace maths {
+
+enum class SimdLevel { SSE2, AVX2, AVX512 };
+
+/// Comparison used by the mask functions in masks.h
+enum class Compare { EQ, NEQ, LT, LTE, GT, GTE };
+
+/// The best level supported by this CPU and OS
+SimdLevel detectedSimdLevel();
+/// The level currently used by the batch functions
+SimdLevel simdLevel();
+/// Force a level. Levels above detectedSimdLevel() are clamped
+void setSimdLevel(SimdLevel level);
+
+const char* toString(SimdLevel level);
+
+namespace kernels {
+
+/// Component pointers of a structure-of-arrays stream (x, y, z, w)
+struct soa final { float* c[4]; };
+struct csoa final { const float* c[4]; };
+
+struct Table final {
+	SimdLevel level;
+
+	/// out[i] = a[i].dot(b[i])
+	void (*dot3)(csoa a, csoa b, float* out, std::size_t n);
+	void (*dot4)(csoa a, csoa b, float* out, std::size_t n);
+	/// out[i] = a[i].cross(b[i])
+	void (*cross3)(csoa a, csoa b, soa out, std::size_t n);
+	/// out[i] = v[i].length()
+	void (*length3)(csoa v, float* out, std::size_t n);
+	void (*length4)(csoa v, float* out, std::size_t n);
+	/// v[i] = v[i].normalised()
+	void (*normalise3)(soa v, std::size_t n);
+	void (*normalise4)(soa v, std::size_t n);
+	/// out[i] = a[i] + (b[i]-a[i])*t
+	void (*lerp)(const float* a, const float* b, float t, float* out, std::size_t n);
+	/// out[i] = m * v[i] where m is 16 column-major floats
+	void (*transform4)(const float* m, csoa v, soa out, std::size_t n);
+	/// out[i] = m * float4{p[i], w} for n interleaved xyz points. outStride 3
+	/// stores xyz and 4 stores xyzw. If divide is set xyz are divided by w
+	void (*transform3)(const float* m, const float* p, float w, bool divide, float* out, int outStride, std::size_t n);
+	/// out[i] = the 2 rows of 3 floats in m * float3{p[i], w} for n interleaved xy points
+	void (*transform2)(const float* m, const float* p, float w, float* out, std::size_t n);
+	/// out + i * outStride = vp * models[i] for n column-major matrices of 16 floats.
+	/// Unless normals is null normals + i * normalStride is also set to the
+	/// inverse transpose of the upper 3x3 of models[i] as 3 columns of 4 floats
+	/// with w = 0, or zeros if the upper 3x3 is singular. Strides are in floats
+	void (*mvp)(const float* vp, const float* models, float* out, std::size_t outStride,
+				float* normals, std::size_t normalStride, std::size_t n);
+	/// out[i] += a[i]*s
+	void (*madd)(const float* a, float s, float* out, std::size_t n);
+	/// v[i] *= s
+	void (*scale)(float* v, float s, std::size_t n);
+	/// Rotate (a[i], b[i]) in its plane by radians[i]:
+	///   outA[i] = a*cos - b*sin
+	///   outB[i] = a*sin + b*cos
+	void (*rotate)(const float* a, const float* b, const float* radians, float* outA, float* outB, std::size_t n);
+	/// out[i] = a[i].slerp(b[i], t) for xyzw quaternions
+	void (*slerp)(csoa a, csoa b, float t, soa out, std::size_t n);
+	/// Dual quaternion skinning with 4 influences. bones is 8 floats per
+	/// dual quaternion and joints is 4 bone indices per vertex.
+	/// outP[i] = blend(bones, joints, weights[i]).transformPoint(p[i]).
+	/// The normals are rotated the same way unless nrm.c[0] is null
+	void (*skin)(const float* bones, const uint16_t* joints, csoa weights, csoa p, soa outP, csoa nrm, soa outN, std::size_t n);
+
+	/// Component-wise conversion of n floats to and from the packed formats in packed.h
+	void (*toHalf)(const float* in, uint16_t* out, std::size_t n);
+	void (*fromHalf)(const uint16_t* in, float* out, std::size_t n);
+	void (*toSnorm16)(const float* in, int16_t* out, std::size_t n);
+	void (*fromSnorm16)(const int16_t* in, float* out, std::size_t n);
+	void (*toUnorm8)(const float* in, uint8_t* out, std::size_t n);
+	void (*fromUnorm8)(const uint8_t* in, float* out, std::size_t n);
+	/// n xyz triples to and from octahedral snorm16 pairs
+	void (*octEncode)(const float* xyz, int16_t* out, std::size_t n);
+	void (*octDecode)(const int16_t* in, float* xyz, std::size_t n);
+	/// n rgba quads to and from rgb10a2
+	void (*toRgb10a2)(const float* rgba, uint32_t* out, std::size_t n);
+	void (*fromRgb10a2)(const uint32_t* in, float* rgba, std::size_t n);
+	/// out[i] = (float)in[i]
+	void (*toFloat)(const double* in, float* out, std::size_t n);
+	/// out + i * 16 = (a + i * aStride) * (b + i * 16) for n column-major
+	/// matrices of 16 doubles. aStride is 0 or 16. out may be a or b
+	void (*dmul)(const double* a, std::size_t aStride, const double* b, double* out, std::size_t n);
+	/// out[i] = m * v[i] for n xyzw doubles where m is 16 column-major doubles
+	void (*dtransform4)(const double* m, const double* v, double* out, std::size_t n);
+	/// out + i * 16 = (in + i * 16).transposed() or inversed() for n column-major
+	/// matrices of 16 doubles. A singular matrix gives its adjugate as
+	/// dmatrix::inversed() does. out may be in
+	void (*dtranspose)(const double* in, double* out, std::size_t n);
+	void (*dinverse)(const double* in, double* out, std::size_t n);
+	/// v[i] = v[i].normalised() for n xyzw doubles
+	void (*dnormalise4)(double* v, std::size_t n);
+
+	/// n xy pairs or xyz triples to and from 64 bit Morton codes
+	void (*mortonEncode2)(const uint32_t* xy, uint64_t* out, std::size_t n);
+	void (*mortonEncode3)(const uint32_t* xyz, uint64_t* out, std::size_t n);
+	void (*mortonDecode2)(const uint64_t* in, uint32_t* xy, std::size_t n);
+	void (*mortonDecode3)(const uint64_t* in, uint32_t* xyz, std::size_t n);
+
+	/// Component-wise min and max of n points of stride (3 or 4) floats.
+	/// lo and hi are +inf and -inf if n is 0
+	void (*bounds)(const float* p, std::size_t n, int stride, float* lo, float* hi);
+	/// Component-wise sum of n points of stride (3 or 4) floats. Each lane
+	/// uses Kahan summation and the lanes are combined in double
+	void (*sum)(const float* p, std::size_t n, int stride, double* out);
+
+	/// Bit i % 64 of mask[i / 64] = a[i] <op> b[i], or a[i] <op> s if b is null.
+	/// The unused high bits of the last word are cleared
+	void (*compare)(const float* a, const float* b, float s, Compare op, uint64_t* mask, std::size_t n);
+	/// out[i] = bit i of mask ? a[i] : b[i]
+	void (*select)(const uint64_t* mask, const float* a, const float* b, float* out, std::size_t n);
+	/// out[i] = min(max(in[i], lo), hi)
+	void (*clamp)(const float* in, float lo, float hi, float* out, std::size_t n);
+	/// out[i] = in[i] < edge ? 0 : 1
+	void (*step)(float edge, const float* in, float* out, std::size_t n);
+
+	/// Frustum culling against 6 planes of 4 floats (xyz normal and w, inside
+	/// where dot(normal, p) + w >= 0). Bit i % 64 of mask[i / 64] is set unless
+	/// sphere i (centre c[i], radius r[i]) is entirely outside one of the planes.
+	/// If r is null the spheres are points. The unused high bits of the last
+	/// word are cleared
+	void (*cullSpheres)(const float* planes, csoa c, const float* r, uint64_t* mask, std::size_t n);
+	/// The same for the boxes [lo[i], hi[i]]
+	void (*cullAabbs)(const float* planes, csoa lo, csoa hi, uint64_t* mask, std::size_t n);
+
+	/// n interleaved points of stride (2, 3 or 4) floats to and from planar arrays
+	void (*toSoa)(const float* aos, int stride, soa out, std::size_t n);
+	void (*fromSoa)(csoa in, int stride, float* aos, std::size_t n);
+	/// n interleaved points of stride (2, 3 or 4) floats to and from blocks of
+	/// block (4 or 8) points holding block x values, then block y values etc.
+	/// toAosoa pads the last block with zeros
+	void (*toAosoa)(const float* aos, int stride, int block, float* out, std::size_t n);
+	void (*fromAosoa)(const float* in, int stride, int block, float* aos, std::size_t n);
+};
+
+/// The table for the current simdLevel()
+const Table& table();
+
+Table sse2Table();
+Table avx2Table();
+Table avx512Table();
+
+}
+}
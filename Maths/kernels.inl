@@ -0,0 +1,1144 @@
+///
+///	Batch kernel bodies. Included by each kernels_<isa>.cpp inside its
+/// own namespace after defining V as the register wrapper for that ISA.
+///
+/// Each loop processes 2 registers per iteration and finishes the
+/// tail with scalar code.
+///
+/// rotate and the packed format conversions pad their tail out to a full
+/// register instead so that every element gives the same result.
+///
+/// Nothing here calls std:: templates or other inline functions outside the
+/// including namespace and simd.h/trig.h, as an out-of-line copy would be
+/// shared between the kernels_<isa>.cpp objects. minOf, maxOf and copyN
+/// stand in for std::min, std::max and std::copy.
+///
+
+constexpr std::size_t STEP = V::width * 2;
+
+template<typename T>
+T minOf(T a, T b) { return b < a ? b : a; }
+template<typename T>
+T maxOf(T a, T b) { return a < b ? b : a; }
+template<typename T>
+void copyN(const T* in, std::size_t n, T* out) { std::memcpy(out, in, n * sizeof(T)); }
+
+inline float length3(float x, float y, float z) {
+	return sqrt(simd::f32x1{x*x + y*y + z*z}).v;
+}
+inline float length4(float x, float y, float z, float w) {
+	return sqrt(simd::f32x1{x*x + y*y + z*z + w*w}).v;
+}
+
+void dot3(csoa a, csoa b, float* out, std::size_t n) {
+	std::size_t i = 0;
+	for(; i + STEP <= n; i += STEP) {
+		for(std::size_t j = i; j < i + STEP; j += V::width) {
+			V d = V::load(a.c[0] + j) * V::load(b.c[0] + j);
+			d = fmadd(V::load(a.c[1] + j), V::load(b.c[1] + j), d);
+			d = fmadd(V::load(a.c[2] + j), V::load(b.c[2] + j), d);
+			d.store(out + j);
+		}
+	}
+	for(; i < n; i++) {
+		out[i] = a.c[0][i] * b.c[0][i] + a.c[1][i] * b.c[1][i] + a.c[2][i] * b.c[2][i];
+	}
+}
+void dot4(csoa a, csoa b, float* out, std::size_t n) {
+	std::size_t i = 0;
+	for(; i + STEP <= n; i += STEP) {
+		for(std::size_t j = i; j < i + STEP; j += V::width) {
+			V d = V::load(a.c[0] + j) * V::load(b.c[0] + j);
+			d = fmadd(V::load(a.c[1] + j), V::load(b.c[1] + j), d);
+			d = fmadd(V::load(a.c[2] + j), V::load(b.c[2] + j), d);
+			d = fmadd(V::load(a.c[3] + j), V::load(b.c[3] + j), d);
+			d.store(out + j);
+		}
+	}
+	for(; i < n; i++) {
+		out[i] = a.c[0][i] * b.c[0][i] + a.c[1][i] * b.c[1][i] + a.c[2][i] * b.c[2][i] + a.c[3][i] * b.c[3][i];
+	}
+}
+void cross3(csoa a, csoa b, soa out, std::size_t n) {
+	std::size_t i = 0;
+	for(; i + STEP <= n; i += STEP) {
+		for(std::size_t j = i; j < i + STEP; j += V::width) {
+			V ax = V::load(a.c[0] + j), ay = V::load(a.c[1] + j), az = V::load(a.c[2] + j);
+			V bx = V::load(b.c[0] + j), by = V::load(b.c[1] + j), bz = V::load(b.c[2] + j);
+			(ay * bz - az * by).store(out.c[0] + j);
+			(az * bx - ax * bz).store(out.c[1] + j);
+			(ax * by - ay * bx).store(out.c[2] + j);
+		}
+	}
+	for(; i < n; i++) {
+		float ax = a.c[0][i], ay = a.c[1][i], az = a.c[2][i];
+		float bx = b.c[0][i], by = b.c[1][i], bz = b.c[2][i];
+		out.c[0][i] = ay * bz - az * by;
+		out.c[1][i] = az * bx - ax * bz;
+		out.c[2][i] = ax * by - ay * bx;
+	}
+}
+void length3(csoa v, float* out, std::size_t n) {
+	std::size_t i = 0;
+	for(; i + STEP <= n; i += STEP) {
+		for(std::size_t j = i; j < i + STEP; j += V::width) {
+			V x = V::load(v.c[0] + j), y = V::load(v.c[1] + j), z = V::load(v.c[2] + j);
+			sqrt(fmadd(z, z, fmadd(y, y, x * x))).store(out + j);
+		}
+	}
+	for(; i < n; i++) {
+		out[i] = length3(v.c[0][i], v.c[1][i], v.c[2][i]);
+	}
+}
+void length4(csoa v, float* out, std::size_t n) {
+	std::size_t i = 0;
+	for(; i + STEP <= n; i += STEP) {
+		for(std::size_t j = i; j < i + STEP; j += V::width) {
+			V x = V::load(v.c[0] + j), y = V::load(v.c[1] + j), z = V::load(v.c[2] + j), w = V::load(v.c[3] + j);
+			sqrt(fmadd(w, w, fmadd(z, z, fmadd(y, y, x * x)))).store(out + j);
+		}
+	}
+	for(; i < n; i++) {
+		out[i] = length4(v.c[0][i], v.c[1][i], v.c[2][i], v.c[3][i]);
+	}
+}
+void normalise3(soa v, std::size_t n) {
+	std::size_t i = 0;
+	for(; i + STEP <= n; i += STEP) {
+		for(std::size_t j = i; j < i + STEP; j += V::width) {
+			V x = V::load(v.c[0] + j), y = V::load(v.c[1] + j), z = V::load(v.c[2] + j);
+			V len = sqrt(fmadd(z, z, fmadd(y, y, x * x)));
+			(x / len).store(v.c[0] + j);
+			(y / len).store(v.c[1] + j);
+			(z / len).store(v.c[2] + j);
+		}
+	}
+	for(; i < n; i++) {
+		float len = length3(v.c[0][i], v.c[1][i], v.c[2][i]);
+		v.c[0][i] /= len;
+		v.c[1][i] /= len;
+		v.c[2][i] /= len;
+	}
+}
+void normalise4(soa v, std::size_t n) {
+	std::size_t i = 0;
+	for(; i + STEP <= n; i += STEP) {
+		for(std::size_t j = i; j < i + STEP; j += V::width) {
+			V x = V::load(v.c[0] + j), y = V::load(v.c[1] + j), z = V::load(v.c[2] + j), w = V::load(v.c[3] + j);
+			V len = sqrt(fmadd(w, w, fmadd(z, z, fmadd(y, y, x * x))));
+			(x / len).store(v.c[0] + j);
+			(y / len).store(v.c[1] + j);
+			(z / len).store(v.c[2] + j);
+			(w / len).store(v.c[3] + j);
+		}
+	}
+	for(; i < n; i++) {
+		float len = length4(v.c[0][i], v.c[1][i], v.c[2][i], v.c[3][i]);
+		v.c[0][i] /= len;
+		v.c[1][i] /= len;
+		v.c[2][i] /= len;
+		v.c[3][i] /= len;
+	}
+}
+void lerp(const float* a, const float* b, float t, float* out, std::size_t n) {
+	const V tt = V::set1(t);
+	std::size_t i = 0;
+	for(; i + STEP <= n; i += STEP) {
+		for(std::size_t j = i; j < i + STEP; j += V::width) {
+			V va = V::load(a + j);
+			fmadd(V::load(b + j) - va, tt, va).store(out + j);
+		}
+	}
+	for(; i < n; i++) {
+		out[i] = a[i] + (b[i] - a[i]) * t;
+	}
+}
+void transform4(const float* m, csoa v, soa out, std::size_t n) {
+	V mm[16];
+	for(int k = 0; k < 16; k++) mm[k] = V::set1(m[k]);
+
+	std::size_t i = 0;
+	for(; i + V::width <= n; i += V::width) {
+		V x = V::load(v.c[0] + i), y = V::load(v.c[1] + i), z = V::load(v.c[2] + i), w = V::load(v.c[3] + i);
+		for(int r = 0; r < 4; r++) {
+			fmadd(mm[12 + r], w, fmadd(mm[8 + r], z, fmadd(mm[4 + r], y, mm[r] * x))).store(out.c[r] + i);
+		}
+	}
+	for(; i < n; i++) {
+		float x = v.c[0][i], y = v.c[1][i], z = v.c[2][i], w = v.c[3][i];
+		for(int r = 0; r < 4; r++) {
+			out.c[r][i] = m[r] * x + m[4 + r] * y + m[8 + r] * z + m[12 + r] * w;
+		}
+	}
+}
+void madd(const float* a, float s, float* out, std::size_t n) {
+	const V ss = V::set1(s);
+	std::size_t i = 0;
+	for(; i + STEP <= n; i += STEP) {
+		for(std::size_t j = i; j < i + STEP; j += V::width) {
+			fmadd(V::load(a + j), ss, V::load(out + j)).store(out + j);
+		}
+	}
+	for(; i < n; i++) {
+		out[i] += a[i] * s;
+	}
+}
+void scale(float* v, float s, std::size_t n) {
+	const V ss = V::set1(s);
+	std::size_t i = 0;
+	for(; i + STEP <= n; i += STEP) {
+		for(std::size_t j = i; j < i + STEP; j += V::width) {
+			(V::load(v + j) * ss).store(v + j);
+		}
+	}
+	for(; i < n; i++) {
+		v[i] *= s;
+	}
+}
+void rotate(const float* a, const float* b, const float* radians, float* outA, float* outB, std::size_t n) {
+	auto step = [](V a, V b, V r, float* outA, float* outB) {
+		V s, c;
+		trig::sincos(r, s, c);
+		const V ra = a * c - b * s;
+		const V rb = fmadd(a, s, b * c);
+		ra.store(outA);
+		rb.store(outB);
+	};
+	std::size_t i = 0;
+	for(; i + STEP <= n; i += STEP) {
+		for(std::size_t j = i; j < i + STEP; j += V::width) {
+			step(V::load(a + j), V::load(b + j), V::load(radians + j), outA + j, outB + j);
+		}
+	}
+	for(; i < n; i += V::width) {
+		const std::size_t count = minOf<std::size_t>(n - i, V::width);
+		float ta[V::width] = {}, tb[V::width] = {}, tr[V::width] = {}, oa[V::width], ob[V::width];
+		for(std::size_t k = 0; k < count; k++) {
+			ta[k] = a[i + k];
+			tb[k] = b[i + k];
+			tr[k] = radians[i + k];
+		}
+		step(V::load(ta), V::load(tb), V::load(tr), oa, ob);
+		for(std::size_t k = 0; k < count; k++) {
+			outA[i + k] = oa[k];
+			outB[i + k] = ob[k];
+		}
+	}
+}
+
+void slerp(csoa a, csoa b, float t, soa out, std::size_t n) {
+	/// Same steps as quaternion::slerp
+	const V one = V::set1(1), tt = V::set1(t), ut = V::set1(1 - t);
+	auto step = [&](const float* const* pa, const float* const* pb, float* const* po) {
+		V qa[4], qb[4];
+		for(int c = 0; c < 4; c++) {
+			qa[c] = V::load(pa[c]);
+			qb[c] = V::load(pb[c]);
+		}
+		V d = fmadd(qa[3], qb[3], fmadd(qa[2], qb[2], fmadd(qa[1], qb[1], qa[0] * qb[0])));
+		const auto neg = d < V::zero();
+		d = abs(d);
+		const auto near = d >= V::set1(0.9995f);
+		const V theta = trig::acos(d);
+		const V invSin = one / sqrt(max(one - d * d, V::set1(1e-12f)));
+		const V wa = select(near, ut, trig::sin(ut * theta) * invSin);
+		V wb = select(near, tt, trig::sin(tt * theta) * invSin);
+		wb = select(neg, -wb, wb);
+		V r[4];
+		for(int c = 0; c < 4; c++) r[c] = fmadd(qb[c], wb, qa[c] * wa);
+		const V len = sqrt(fmadd(r[3], r[3], fmadd(r[2], r[2], fmadd(r[1], r[1], r[0] * r[0]))));
+		for(int c = 0; c < 4; c++) (r[c] / len).store(po[c]);
+	};
+	std::size_t i = 0;
+	for(; i + V::width <= n; i += V::width) {
+		const float* pa[4] = {a.c[0] + i, a.c[1] + i, a.c[2] + i, a.c[3] + i};
+		const float* pb[4] = {b.c[0] + i, b.c[1] + i, b.c[2] + i, b.c[3] + i};
+		float* po[4] = {out.c[0] + i, out.c[1] + i, out.c[2] + i, out.c[3] + i};
+		step(pa, pb, po);
+	}
+	if(i < n) {
+		/// Identity quaternions in the padding lanes
+		float ta[4][V::width], tb[4][V::width], to[4][V::width];
+		for(int c = 0; c < 4; c++) {
+			for(int k = 0; k < V::width; k++) {
+				ta[c][k] = tb[c][k] = c == 3 ? 1.0f : 0.0f;
+			}
+			for(std::size_t k = 0; i + k < n; k++) {
+				ta[c][k] = a.c[c][i + k];
+				tb[c][k] = b.c[c][i + k];
+			}
+		}
+		const float* pa[4] = {ta[0], ta[1], ta[2], ta[3]};
+		const float* pb[4] = {tb[0], tb[1], tb[2], tb[3]};
+		float* po[4] = {to[0], to[1], to[2], to[3]};
+		step(pa, pb, po);
+		for(int c = 0; c < 4; c++) {
+			copyN(to[c], n - i, out.c[c] + i);
+		}
+	}
+}
+/// v rotated by the unit quaternion q. Same steps as quaternion::rotate
+inline void quatRotate(const V* q, const V* v, V* out) {
+	const V t0 = (q[1] * v[2] - q[2] * v[1]) * V::set1(2);
+	const V t1 = (q[2] * v[0] - q[0] * v[2]) * V::set1(2);
+	const V t2 = (q[0] * v[1] - q[1] * v[0]) * V::set1(2);
+	out[0] = fmadd(t0, q[3], v[0]) + (q[1] * t2 - q[2] * t1);
+	out[1] = fmadd(t1, q[3], v[1]) + (q[2] * t0 - q[0] * t2);
+	out[2] = fmadd(t2, q[3], v[2]) + (q[0] * t1 - q[1] * t0);
+}
+void skin(const float* bones, const uint16_t* joints, csoa weights, csoa p, soa outP, csoa nrm, soa outN, std::size_t n) {
+	/// V::width vertices at a time. The 4 bones of each vertex are gathered into
+	/// planar arrays on the stack and blended in registers. Padding lanes use
+	/// bone 0 with weight 1
+	alignas(64) float g[8][V::width];
+	alignas(64) float tw[4][V::width], tp[3][V::width], tn[3][V::width], to[6][V::width];
+	uint16_t tj[4 * V::width];
+
+	auto step = [&](const uint16_t* jt, const float* const* w, const float* const* pp, const float* const* pn,
+					float* const* op, float* const* on) {
+		V r[4], d[4], r0[4];
+		for(int k = 0; k < 4; k++) {
+			for(int j = 0; j < V::width; j++) {
+				const float* b = bones + jt[j * 4 + k] * 8;
+				for(int c = 0; c < 8; c++) g[c][j] = b[c];
+			}
+			V wk = V::load(w[k]);
+			if(k == 0) {
+				for(int c = 0; c < 4; c++) {
+					r0[c] = V::load(g[c]);
+					r[c] = r0[c] * wk;
+					d[c] = V::load(g[4 + c]) * wk;
+				}
+				continue;
+			}
+			V q[4];
+			for(int c = 0; c < 4; c++) q[c] = V::load(g[c]);
+			const V dot = fmadd(q[3], r0[3], fmadd(q[2], r0[2], fmadd(q[1], r0[1], q[0] * r0[0])));
+			wk = select(dot < V::zero(), -wk, wk);
+			for(int c = 0; c < 4; c++) {
+				r[c] = fmadd(q[c], wk, r[c]);
+				d[c] = fmadd(V::load(g[4 + c]), wk, d[c]);
+			}
+		}
+		const V inv = V::set1(1) / sqrt(fmadd(r[3], r[3], fmadd(r[2], r[2], fmadd(r[1], r[1], r[0] * r[0]))));
+		for(int c = 0; c < 4; c++) {
+			r[c] = r[c] * inv;
+			d[c] = d[c] * inv;
+		}
+		/// Translation = 2 * (r.xyz x d.xyz + d.xyz * r.w - r.xyz * d.w)
+		const V two = V::set1(2);
+		const V t[3] = {
+			(r[1] * d[2] - r[2] * d[1] + d[0] * r[3] - r[0] * d[3]) * two,
+			(r[2] * d[0] - r[0] * d[2] + d[1] * r[3] - r[1] * d[3]) * two,
+			(r[0] * d[1] - r[1] * d[0] + d[2] * r[3] - r[2] * d[3]) * two
+		};
+		V v[3], o[3];
+		for(int c = 0; c < 3; c++) v[c] = V::load(pp[c]);
+		quatRotate(r, v, o);
+		for(int c = 0; c < 3; c++) (o[c] + t[c]).store(op[c]);
+		if(pn) {
+			for(int c = 0; c < 3; c++) v[c] = V::load(pn[c]);
+			quatRotate(r, v, o);
+			for(int c = 0; c < 3; c++) o[c].store(on[c]);
+		}
+	};
+	const bool normals = nrm.c[0] != nullptr;
+	std::size_t i = 0;
+	for(; i + V::width <= n; i += V::width) {
+		const float* w[4] = {weights.c[0] + i, weights.c[1] + i, weights.c[2] + i, weights.c[3] + i};
+		const float* pp[3] = {p.c[0] + i, p.c[1] + i, p.c[2] + i};
+		float* op[3] = {outP.c[0] + i, outP.c[1] + i, outP.c[2] + i};
+		if(normals) {
+			const float* pn[3] = {nrm.c[0] + i, nrm.c[1] + i, nrm.c[2] + i};
+			float* on[3] = {outN.c[0] + i, outN.c[1] + i, outN.c[2] + i};
+			step(joints + i * 4, w, pp, pn, op, on);
+		} else {
+			step(joints + i * 4, w, pp, nullptr, op, nullptr);
+		}
+	}
+	if(i < n) {
+		const std::size_t count = n - i;
+		for(int k = 0; k < V::width; k++) {
+			const bool used = (std::size_t)k < count;
+			for(int c = 0; c < 4; c++) {
+				tj[k * 4 + c] = used ? joints[(i + k) * 4 + c] : 0;
+				tw[c][k] = used ? weights.c[c][i + k] : (c == 0 ? 1.0f : 0.0f);
+			}
+			for(int c = 0; c < 3; c++) {
+				tp[c][k] = used ? p.c[c][i + k] : 0;
+				tn[c][k] = used && normals ? nrm.c[c][i + k] : 0;
+			}
+		}
+		const float* w[4] = {tw[0], tw[1], tw[2], tw[3]};
+		const float* pp[3] = {tp[0], tp[1], tp[2]};
+		const float* pn[3] = {tn[0], tn[1], tn[2]};
+		float* op[3] = {to[0], to[1], to[2]};
+		float* on[3] = {to[3], to[4], to[5]};
+		step(tj, w, pp, normals ? pn : nullptr, op, on);
+		for(int c = 0; c < 3; c++) {
+			copyN(to[c], count, outP.c[c] + i);
+			if(normals) copyN(to[3 + c], count, outN.c[c] + i);
+		}
+	}
+}
+
+/// Calls fn(in, out) for each block of V::width elements. A short last
+/// block is copied through zero padded buffers
+template<typename In, typename Out, typename F>
+void convert(const In* in, Out* out, std::size_t n, F fn) {
+	std::size_t i = 0;
+	for(; i + V::width <= n; i += V::width) {
+		fn(in + i, out + i);
+	}
+	if(i < n) {
+		In a[V::width] = {};
+		Out b[V::width];
+		copyN(in + i, n - i, a);
+		fn(a, b);
+		copyN(b, n - i, out + i);
+	}
+}
+void toHalf(const float* in, uint16_t* out, std::size_t n) {
+	convert(in, out, n, [](const float* a, uint16_t* b) {
+		V::load(a).storeHalf(b);
+	});
+}
+void fromHalf(const uint16_t* in, float* out, std::size_t n) {
+	convert(in, out, n, [](const uint16_t* a, float* b) {
+		V::loadHalf(a).store(b);
+	});
+}
+void toSnorm16(const float* in, int16_t* out, std::size_t n) {
+	convert(in, out, n, [](const float* a, int16_t* b) {
+		(min(max(V::load(a), V::set1(-1)), V::set1(1)) * V::set1(32767)).storeI16(b);
+	});
+}
+void fromSnorm16(const int16_t* in, float* out, std::size_t n) {
+	convert(in, out, n, [](const int16_t* a, float* b) {
+		max(V::loadI16(a) / V::set1(32767), V::set1(-1)).store(b);
+	});
+}
+void toUnorm8(const float* in, uint8_t* out, std::size_t n) {
+	convert(in, out, n, [](const float* a, uint8_t* b) {
+		(min(max(V::load(a), V::zero()), V::set1(1)) * V::set1(255)).storeU8(b);
+	});
+}
+void fromUnorm8(const uint8_t* in, float* out, std::size_t n) {
+	convert(in, out, n, [](const uint8_t* a, float* b) {
+		(V::loadU8(a) / V::set1(255)).store(b);
+	});
+}
+void octEncode(const float* xyz, int16_t* out, std::size_t n) {
+	const V one = V::set1(1);
+	for(std::size_t i = 0; i < n; i += V::width) {
+		const std::size_t count = minOf<std::size_t>(n - i, V::width);
+		float x[V::width] = {}, y[V::width] = {}, z[V::width];
+		for(float& f : z) f = 1;
+		for(std::size_t k = 0; k < count; k++) {
+			x[k] = xyz[(i + k) * 3];
+			y[k] = xyz[(i + k) * 3 + 1];
+			z[k] = xyz[(i + k) * 3 + 2];
+		}
+		const V vx = V::load(x), vy = V::load(y), vz = V::load(z);
+		/// Project onto the octahedron and fold the lower half over the diagonals
+		const V inv = one / (abs(vx) + abs(vy) + abs(vz));
+		const V px = vx * inv, py = vy * inv;
+		const auto lower = vz < V::zero();
+		const V u = select(lower, (one - abs(py)) | sign(px), px);
+		const V v = select(lower, (one - abs(px)) | sign(py), py);
+
+		int16_t qu[V::width], qv[V::width];
+		(min(max(u, -one), one) * V::set1(32767)).storeI16(qu);
+		(min(max(v, -one), one) * V::set1(32767)).storeI16(qv);
+		for(std::size_t k = 0; k < count; k++) {
+			out[(i + k) * 2] = qu[k];
+			out[(i + k) * 2 + 1] = qv[k];
+		}
+	}
+}
+void octDecode(const int16_t* in, float* xyz, std::size_t n) {
+	const V one = V::set1(1);
+	for(std::size_t i = 0; i < n; i += V::width) {
+		const std::size_t count = minOf<std::size_t>(n - i, V::width);
+		int16_t qu[V::width] = {}, qv[V::width] = {};
+		for(std::size_t k = 0; k < count; k++) {
+			qu[k] = in[(i + k) * 2];
+			qv[k] = in[(i + k) * 2 + 1];
+		}
+		V x = max(V::loadI16(qu) / V::set1(32767), -one);
+		V y = max(V::loadI16(qv) / V::set1(32767), -one);
+		const V z = one - abs(x) - abs(y);
+		/// Unfold the lower half
+		const V t = max(-z, V::zero());
+		x = x - (t ^ sign(x));
+		y = y - (t ^ sign(y));
+		const V len = sqrt(fmadd(z, z, fmadd(y, y, x * x)));
+
+		float ox[V::width], oy[V::width], oz[V::width];
+		(x / len).store(ox);
+		(y / len).store(oy);
+		(z / len).store(oz);
+		for(std::size_t k = 0; k < count; k++) {
+			xyz[(i + k) * 3] = ox[k];
+			xyz[(i + k) * 3 + 1] = oy[k];
+			xyz[(i + k) * 3 + 2] = oz[k];
+		}
+	}
+}
+void toRgb10a2(const float* rgba, uint32_t* out, std::size_t n) {
+	for(std::size_t i = 0; i < n; i += V::width) {
+		const std::size_t count = minOf<std::size_t>(n - i, V::width);
+		float c[4][V::width] = {};
+		for(std::size_t k = 0; k < count; k++) {
+			for(int j = 0; j < 4; j++) c[j][k] = rgba[(i + k) * 4 + j];
+		}
+		auto quantise = [](const float* p, float scale) {
+			return round(min(max(V::load(p), V::zero()), V::set1(1)) * V::set1(scale));
+		};
+		/// r + g<<10 and b + a<<10 are both exact in a float
+		int32_t lo[V::width], hi[V::width];
+		fmadd(quantise(c[1], 1023), V::set1(1024), quantise(c[0], 1023)).storeI32(lo);
+		fmadd(quantise(c[3], 3), V::set1(1024), quantise(c[2], 1023)).storeI32(hi);
+		for(std::size_t k = 0; k < count; k++) {
+			out[i + k] = (uint32_t)lo[k] | ((uint32_t)hi[k] << 20);
+		}
+	}
+}
+void fromRgb10a2(const uint32_t* in, float* rgba, std::size_t n) {
+	for(std::size_t i = 0; i < n; i += V::width) {
+		const std::size_t count = minOf<std::size_t>(n - i, V::width);
+		float c[4][V::width] = {};
+		for(std::size_t k = 0; k < count; k++) {
+			c[0][k] = (float)(in[i + k] & 0x3ff);
+			c[1][k] = (float)((in[i + k] >> 10) & 0x3ff);
+			c[2][k] = (float)((in[i + k] >> 20) & 0x3ff);
+			c[3][k] = (float)(in[i + k] >> 30);
+		}
+		for(int j = 0; j < 4; j++) {
+			(V::load(c[j]) / V::set1(j == 3 ? 3.0f : 1023.0f)).store(c[j]);
+		}
+		for(std::size_t k = 0; k < count; k++) {
+			for(int j = 0; j < 4; j++) rgba[(i + k) * 4 + j] = c[j][k];
+		}
+	}
+}
+void toFloat(const double* in, float* out, std::size_t n) {
+	std::size_t i = 0;
+	for(; i + STEP <= n; i += STEP) {
+		for(std::size_t j = i; j < i + STEP; j += V::width) {
+			V::loadF64(in + j).store(out + j);
+		}
+	}
+	for(; i < n; i++) {
+		out[i] = (float)in[i];
+	}
+}
+/// The columns of a 4x4 double matrix times v, added in the same order as
+/// matrix4 so the results match dmatrix * dmatrix exactly
+inline simd::f64x4 dcolumn(const simd::f64x4* m, const double* v) {
+	using D = simd::f64x4;
+	return m[0] * D::set1(v[0]) + m[1] * D::set1(v[1]) + m[2] * D::set1(v[2]) + m[3] * D::set1(v[3]);
+}
+void dmul(const double* a, std::size_t aStride, const double* b, double* out, std::size_t n) {
+	using D = simd::f64x4;
+	for(std::size_t i = 0; i < n; i++) {
+		const double* m = a + i * aStride;
+		const double* v = b + i * 16;
+		const D c[4] = {D::load(m), D::load(m + 4), D::load(m + 8), D::load(m + 12)};
+		const D r0 = dcolumn(c, v), r1 = dcolumn(c, v + 4), r2 = dcolumn(c, v + 8), r3 = dcolumn(c, v + 12);
+		double* o = out + i * 16;
+		r0.store(o);
+		r1.store(o + 4);
+		r2.store(o + 8);
+		r3.store(o + 12);
+	}
+}
+void dtransform4(const double* m, const double* v, double* out, std::size_t n) {
+	using D = simd::f64x4;
+	const D c[4] = {D::load(m), D::load(m + 4), D::load(m + 8), D::load(m + 12)};
+	for(std::size_t i = 0; i < n; i++) {
+		dcolumn(c, v + i * 4).store(out + i * 4);
+	}
+}
+void dtranspose(const double* in, double* out, std::size_t n) {
+	using D = simd::f64x4;
+	for(std::size_t i = 0; i < n * 16; i += 16) {
+		D a = D::load(in + i), b = D::load(in + i + 4), c = D::load(in + i + 8), d = D::load(in + i + 12);
+		transpose(a, b, c, d);
+		a.store(out + i);
+		b.store(out + i + 4);
+		c.store(out + i + 8);
+		d.store(out + i + 12);
+	}
+}
+/// matrix4::adjugateF64 and inversed with the same operations, so the
+/// results match dmatrix::inversed() exactly
+void dinverse(const double* in, double* out, std::size_t n) {
+	using D = simd::f64x4;
+	const D even = D::setr(1, -1, 1, -1), odd = D::setr(-1, 1, -1, 1);
+	for(std::size_t i = 0; i < n * 16; i += 16) {
+		const double* c = in + i;
+		D e[4], f[4], a[4];
+		for(int r = 0; r < 4; r++) {
+			e[r] = D::setr(c[8 + r], c[8 + r], c[r], c[r]);
+			f[r] = D::setr(c[12 + r], c[12 + r], c[4 + r], c[4 + r]);
+			a[r] = D::setr(c[4 + r], c[r], c[12 + r], c[8 + r]);
+		}
+		const D k0 = e[0] * f[1] - f[0] * e[1];
+		const D k1 = e[0] * f[2] - f[0] * e[2];
+		const D k2 = e[0] * f[3] - f[0] * e[3];
+		const D k3 = e[1] * f[2] - f[1] * e[2];
+		const D k4 = e[1] * f[3] - f[1] * e[3];
+		const D k5 = e[2] * f[3] - f[2] * e[3];
+
+		alignas(32) double adj[16];
+		((a[1] * k5 - a[2] * k4 + a[3] * k3) * even).store(adj);
+		((a[0] * k5 - a[2] * k2 + a[3] * k1) * odd).store(adj + 4);
+		((a[0] * k4 - a[1] * k2 + a[3] * k0) * even).store(adj + 8);
+		((a[0] * k3 - a[1] * k1 + a[2] * k0) * odd).store(adj + 12);
+		double det = c[0] * adj[0] + c[1] * adj[4] + c[2] * adj[8] + c[3] * adj[12];
+		if(det == 0) det = 1;	/// Singular. Write the adjugate
+		const D inv = D::set1(1 / det);
+		for(int k = 0; k < 16; k += 4) (D::load(adj + k) * inv).store(out + i + k);
+	}
+}
+/// The length is (x*x + z*z) + (y*y + w*w) as in double4::normalised()
+void dnormalise4(double* v, std::size_t n) {
+	using D = simd::f64x4;
+	std::size_t i = 0;
+	for(; i + 4 <= n; i += 4) {
+		double* p = v + i * 4;
+		D x = D::load(p), y = D::load(p + 4), z = D::load(p + 8), w = D::load(p + 12);
+		transpose(x, y, z, w);
+		const D len = sqrt((x * x + z * z) + (y * y + w * w));
+		x = x / len;
+		y = y / len;
+		z = z / len;
+		w = w / len;
+		transpose(x, y, z, w);
+		x.store(p);
+		y.store(p + 4);
+		z.store(p + 8);
+		w.store(p + 12);
+	}
+	for(; i < n; i++) {
+		double* p = v + i * 4;
+		const D len = sqrt(D::set1((p[0] * p[0] + p[2] * p[2]) + (p[1] * p[1] + p[3] * p[3])));
+		(D::load(p) / len).store(p);
+	}
+}
+void mortonEncode2(const uint32_t* xy, uint64_t* out, std::size_t n) {
+	for(std::size_t i = 0; i < n; i++) {
+		out[i] = spread2<uint64_t>(xy[i * 2]) | (spread2<uint64_t>(xy[i * 2 + 1]) << 1);
+	}
+}
+void mortonEncode3(const uint32_t* xyz, uint64_t* out, std::size_t n) {
+	for(std::size_t i = 0; i < n; i++) {
+		out[i] = spread3<uint64_t>(xyz[i * 3]) | (spread3<uint64_t>(xyz[i * 3 + 1]) << 1) | (spread3<uint64_t>(xyz[i * 3 + 2]) << 2);
+	}
+}
+void mortonDecode2(const uint64_t* in, uint32_t* xy, std::size_t n) {
+	for(std::size_t i = 0; i < n; i++) {
+		xy[i * 2] = compact2(in[i]);
+		xy[i * 2 + 1] = compact2(in[i] >> 1);
+	}
+}
+void mortonDecode3(const uint64_t* in, uint32_t* xyz, std::size_t n) {
+	for(std::size_t i = 0; i < n; i++) {
+		xyz[i * 3] = compact3(in[i]);
+		xyz[i * 3 + 1] = compact3(in[i] >> 1);
+		xyz[i * 3 + 2] = compact3(in[i] >> 2);
+	}
+}
+
+/// Loading S registers from n points of S floats gives V::width points.
+/// Lane k of register r holds component (r * V::width + k) % S
+template<int S>
+void boundsN(const float* p, std::size_t n, float* lo, float* hi) {
+	constexpr float INF = std::numeric_limits<float>::infinity();
+	V l[S], h[S];
+	for(int r = 0; r < S; r++) {
+		l[r] = V::set1(INF);
+		h[r] = V::set1(-INF);
+	}
+	std::size_t i = 0;
+	for(; i + V::width <= n; i += V::width) {
+		const float* q = p + i * S;
+		for(int r = 0; r < S; r++) {
+			const V v = V::load(q + r * V::width);
+			l[r] = min(l[r], v);
+			h[r] = max(h[r], v);
+		}
+	}
+	for(int c = 0; c < S; c++) {
+		lo[c] = INF;
+		hi[c] = -INF;
+	}
+	for(int r = 0; r < S; r++) {
+		float tl[V::width], th[V::width];
+		l[r].store(tl);
+		h[r].store(th);
+		for(int k = 0; k < V::width; k++) {
+			const int c = (r * V::width + k) % S;
+			lo[c] = minOf(lo[c], tl[k]);
+			hi[c] = maxOf(hi[c], th[k]);
+		}
+	}
+	for(; i < n; i++) {
+		for(int c = 0; c < S; c++) {
+			lo[c] = minOf(lo[c], p[i * S + c]);
+			hi[c] = maxOf(hi[c], p[i * S + c]);
+		}
+	}
+}
+template<int S>
+void sumN(const float* p, std::size_t n, double* out) {
+	V sum[S], err[S];
+	for(int r = 0; r < S; r++) {
+		sum[r] = V::zero();
+		err[r] = V::zero();
+	}
+	std::size_t i = 0;
+	for(; i + V::width <= n; i += V::width) {
+		const float* q = p + i * S;
+		for(int r = 0; r < S; r++) {
+			const V y = V::load(q + r * V::width) - err[r];
+			const V t = sum[r] + y;
+			err[r] = (t - sum[r]) - y;
+			sum[r] = t;
+		}
+	}
+	for(int c = 0; c < S; c++) out[c] = 0;
+	for(int r = 0; r < S; r++) {
+		float ts[V::width], te[V::width];
+		sum[r].store(ts);
+		err[r].store(te);
+		for(int k = 0; k < V::width; k++) {
+			out[(r * V::width + k) % S] += (double)ts[k] - (double)te[k];
+		}
+	}
+	for(; i < n; i++) {
+		for(int c = 0; c < S; c++) out[c] += p[i * S + c];
+	}
+}
+void bounds(const float* p, std::size_t n, int stride, float* lo, float* hi) {
+	if(stride == 3) boundsN<3>(p, n, lo, hi);
+	else boundsN<4>(p, n, lo, hi);
+}
+void sum(const float* p, std::size_t n, int stride, double* out) {
+	if(stride == 3) sumN<3>(p, n, out);
+	else sumN<4>(p, n, out);
+}
+
+/// Each 64 bit mask word is built from 64 / V::width registers
+template<bool SCALAR, typename Cmp>
+void compareN(const float* a, const float* b, float s, uint64_t* mask, std::size_t n, Cmp cmp) {
+	const V vs = V::set1(s);
+	std::size_t i = 0;
+	for(; i + 64 <= n; i += 64) {
+		uint64_t word = 0;
+		for(int j = 0; j < 64; j += V::width) {
+			V vb;
+			if constexpr(SCALAR) vb = vs;
+			else vb = V::load(b + i + j);
+			word |= (uint64_t)(unsigned)bits(cmp(V::load(a + i + j), vb)) << j;
+		}
+		mask[i / 64] = word;
+	}
+	if(i < n) {
+		uint64_t word = 0;
+		for(std::size_t j = 0; i + j < n; j++) {
+			word |= (uint64_t)cmp(a[i + j], SCALAR ? s : b[i + j]) << j;
+		}
+		mask[i / 64] = word;
+	}
+}
+template<typename Cmp>
+void compareN(const float* a, const float* b, float s, uint64_t* mask, std::size_t n, Cmp cmp) {
+	if(b) compareN<false>(a, b, s, mask, n, cmp);
+	else compareN<true>(a, b, s, mask, n, cmp);
+}
+void compare(const float* a, const float* b, float s, Compare op, uint64_t* mask, std::size_t n) {
+	switch(op) {
+		case Compare::EQ: compareN(a, b, s, mask, n, [](auto x, auto y) { return x == y; }); break;
+		case Compare::NEQ: compareN(a, b, s, mask, n, [](auto x, auto y) { return x != y; }); break;
+		case Compare::LT: compareN(a, b, s, mask, n, [](auto x, auto y) { return x < y; }); break;
+		case Compare::LTE: compareN(a, b, s, mask, n, [](auto x, auto y) { return x <= y; }); break;
+		case Compare::GT: compareN(a, b, s, mask, n, [](auto x, auto y) { return x > y; }); break;
+		case Compare::GTE: compareN(a, b, s, mask, n, [](auto x, auto y) { return x >= y; }); break;
+	}
+}
+void select(const uint64_t* mask, const float* a, const float* b, float* out, std::size_t n) {
+	constexpr uint64_t LANES = (1ull << V::width) - 1;
+	std::size_t i = 0;
+	for(; i + V::width <= n; i += V::width) {
+		const int m = (int)((mask[i / 64] >> (i % 64)) & LANES);
+		select(V::mask::fromBits(m), V::load(a + i), V::load(b + i)).store(out + i);
+	}
+	for(; i < n; i++) {
+		out[i] = ((mask[i / 64] >> (i % 64)) & 1) ? a[i] : b[i];
+	}
+}
+void clamp(const float* in, float lo, float hi, float* out, std::size_t n) {
+	const V l = V::set1(lo), h = V::set1(hi);
+	std::size_t i = 0;
+	for(; i + STEP <= n; i += STEP) {
+		for(std::size_t j = i; j < i + STEP; j += V::width) {
+			min(max(V::load(in + j), l), h).store(out + j);
+		}
+	}
+	for(; i < n; i++) {
+		out[i] = minOf(maxOf(in[i], lo), hi);
+	}
+}
+void step(float edge, const float* in, float* out, std::size_t n) {
+	const V e = V::set1(edge), one = V::set1(1);
+	std::size_t i = 0;
+	for(; i + STEP <= n; i += STEP) {
+		for(std::size_t j = i; j < i + STEP; j += V::width) {
+			select(V::load(in + j) >= e, one, V::zero()).store(out + j);
+		}
+	}
+	for(; i < n; i++) {
+		out[i] = in[i] < edge ? 0.0f : 1.0f;
+	}
+}
+
+/// Call f with std::integral_constant<int, stride>
+template<typename F>
+void withStride(int stride, F f) {
+	switch(stride) {
+		case 2: f(std::integral_constant<int, 2>()); break;
+		case 3: f(std::integral_constant<int, 3>()); break;
+		default: f(std::integral_constant<int, 4>()); break;
+	}
+}
+/// Points of S floats to and from a planar layout where addr(c, i) is the
+/// address of component c of point i. These loops are limited by memory
+/// bandwidth so every level uses the 4 point SSE shuffles in simd.h
+template<int S, typename Addr>
+void toPlanar(const float* aos, std::size_t n, Addr addr) {
+	simd::f32x4 r[S];
+	std::size_t i = 0;
+	for(; i + 4 <= n; i += 4) {
+		simd::deinterleave<S>(aos + i * S, r);
+		for(int c = 0; c < S; c++) r[c].store(addr(c, i));
+	}
+	for(; i < n; i++) {
+		for(int c = 0; c < S; c++) *addr(c, i) = aos[i * S + c];
+	}
+}
+template<int S, typename Addr>
+void fromPlanar(float* aos, std::size_t n, Addr addr) {
+	simd::f32x4 r[S];
+	std::size_t i = 0;
+	for(; i + 4 <= n; i += 4) {
+		for(int c = 0; c < S; c++) r[c] = simd::f32x4::load(addr(c, i));
+		simd::interleave<S>(r, aos + i * S);
+	}
+	for(; i < n; i++) {
+		for(int c = 0; c < S; c++) aos[i * S + c] = *addr(c, i);
+	}
+}
+void toSoa(const float* aos, int stride, soa out, std::size_t n) {
+	withStride(stride, [&](auto S) {
+		toPlanar<decltype(S)::value>(aos, n, [&](int c, std::size_t i) { return out.c[c] + i; });
+	});
+}
+void fromSoa(csoa in, int stride, float* aos, std::size_t n) {
+	withStride(stride, [&](auto S) {
+		fromPlanar<decltype(S)::value>(aos, n, [&](int c, std::size_t i) { return in.c[c] + i; });
+	});
+}
+void toAosoa(const float* aos, int stride, int block, float* out, std::size_t n) {
+	const int shift = block == 8 ? 3 : 2;
+	auto addr = [=](int c, std::size_t i) {
+		return out + ((((i >> shift) * stride + c) << shift) + (i & (block - 1)));
+	};
+	withStride(stride, [&](auto S) { toPlanar<decltype(S)::value>(aos, n, addr); });
+	for(std::size_t i = n; i & (block - 1); i++) {
+		for(int c = 0; c < stride; c++) *addr(c, i) = 0;
+	}
+}
+void fromAosoa(const float* in, int stride, int block, float* aos, std::size_t n) {
+	const int shift = block == 8 ? 3 : 2;
+	auto addr = [=](int c, std::size_t i) {
+		return in + ((((i >> shift) * stride + c) << shift) + (i & (block - 1)));
+	};
+	withStride(stride, [&](auto S) { fromPlanar<decltype(S)::value>(aos, n, addr); });
+}
+
+void transform3(const float* m, const float* p, float w, bool divide, float* out, int outStride, std::size_t n) {
+	/// Blocks of points are shuffled into planar arrays on the stack, transformed
+	/// V::width at a time and shuffled back. The tail of the last block is zeroed
+	constexpr std::size_t BLOCK = 64;
+	alignas(64) float in[3][BLOCK], res[4][BLOCK];
+	V mm[12], t[4];
+	for(int k = 0; k < 12; k++) mm[k] = V::set1(m[k]);
+	for(int r = 0; r < 4; r++) t[r] = V::set1(m[12 + r] * w);
+	const V one = V::set1(1);
+
+	for(std::size_t i = 0; i < n; i += BLOCK) {
+		const std::size_t count = minOf(BLOCK, n - i);
+		toPlanar<3>(p + i * 3, count, [&](int c, std::size_t j) { return in[c] + j; });
+		for(std::size_t j = count; j & (V::width - 1); j++) {
+			in[0][j] = in[1][j] = in[2][j] = 0;
+		}
+		for(std::size_t j = 0; j < count; j += V::width) {
+			const V x = V::load(in[0] + j), y = V::load(in[1] + j), z = V::load(in[2] + j);
+			V r[4];
+			for(int c = 0; c < 4; c++) {
+				r[c] = fmadd(mm[8 + c], z, fmadd(mm[4 + c], y, fmadd(mm[c], x, t[c])));
+			}
+			if(divide) {
+				const V iw = one / r[3];
+				for(int c = 0; c < 3; c++) r[c] = r[c] * iw;
+			}
+			for(int c = 0; c < 4; c++) r[c].store(res[c] + j);
+		}
+		withStride(outStride, [&](auto S) {
+			fromPlanar<decltype(S)::value>(out + i * outStride, count, [&](int c, std::size_t j) { return res[c] + j; });
+		});
+	}
+}
+
+void transform2(const float* m, const float* p, float w, float* out, std::size_t n) {
+	/// As transform3 with 2 components in and out
+	constexpr std::size_t BLOCK = 64;
+	alignas(64) float in[2][BLOCK], res[2][BLOCK];
+	const V m00 = V::set1(m[0]), m01 = V::set1(m[1]), t0 = V::set1(m[2] * w);
+	const V m10 = V::set1(m[3]), m11 = V::set1(m[4]), t1 = V::set1(m[5] * w);
+
+	for(std::size_t i = 0; i < n; i += BLOCK) {
+		const std::size_t count = minOf(BLOCK, n - i);
+		toPlanar<2>(p + i * 2, count, [&](int c, std::size_t j) { return in[c] + j; });
+		for(std::size_t j = count; j & (V::width - 1); j++) {
+			in[0][j] = in[1][j] = 0;
+		}
+		for(std::size_t j = 0; j < count; j += V::width) {
+			const V x = V::load(in[0] + j), y = V::load(in[1] + j);
+			fmadd(m01, y, fmadd(m00, x, t0)).store(res[0] + j);
+			fmadd(m11, y, fmadd(m10, x, t1)).store(res[1] + j);
+		}
+		fromPlanar<2>(out + i * 2, count, [&](int c, std::size_t j) { return res[c] + j; });
+	}
+}
+
+/// The 6 frustum planes, one broadcast register per component
+struct CullPlanes {
+	V x[6], y[6], z[6], w[6], ax[6], ay[6], az[6];
+
+	CullPlanes(const float* p) {
+		for(int k = 0; k < 6; k++) {
+			x[k] = V::set1(p[k * 4]);
+			y[k] = V::set1(p[k * 4 + 1]);
+			z[k] = V::set1(p[k * 4 + 2]);
+			w[k] = V::set1(p[k * 4 + 3]);
+			ax[k] = abs(x[k]);
+			ay[k] = abs(y[k]);
+			az[k] = abs(z[k]);
+		}
+	}
+	V distance(int k, V px, V py, V pz) const {
+		return fmadd(pz, z[k], fmadd(py, y[k], fmadd(px, x[k], w[k])));
+	}
+};
+/// A mask word from the N input arrays at in + i
+template<int N, typename Visible>
+uint64_t cullWord(const float* const* in, std::size_t i, Visible visible) {
+	uint64_t word = 0;
+	for(int j = 0; j < 64; j += V::width) {
+		V v[N];
+		for(int k = 0; k < N; k++) v[k] = V::load(in[k] + i + j);
+		word |= (uint64_t)(unsigned)bits(visible(v)) << j;
+	}
+	return word;
+}
+/// The tail is copied into a zero padded word so that every element gives
+/// the same result
+template<int N, typename Visible>
+void cullN(const float* const* in, uint64_t* mask, std::size_t n, Visible visible) {
+	std::size_t i = 0;
+	for(; i + 64 <= n; i += 64) {
+		mask[i / 64] = cullWord<N>(in, i, visible);
+	}
+	if(i < n) {
+		alignas(64) float tail[N][64] = {};
+		const float* t[N];
+		for(int k = 0; k < N; k++) {
+			copyN(in[k] + i, n - i, tail[k]);
+			t[k] = tail[k];
+		}
+		mask[i / 64] = cullWord<N>(t, 0, visible) & ((1ull << (n - i)) - 1);
+	}
+}
+void cullSpheres(const float* planes, csoa c, const float* r, uint64_t* mask, std::size_t n) {
+	const CullPlanes p{planes};
+	const auto inside = [&](V x, V y, V z, V negR) {
+		auto m = p.distance(0, x, y, z) >= negR;
+		for(int k = 1; k < 6; k++) m = m & (p.distance(k, x, y, z) >= negR);
+		return m;
+	};
+	if(r) {
+		const float* in[4] = {c.c[0], c.c[1], c.c[2], r};
+		cullN<4>(in, mask, n, [&](const V* v) { return inside(v[0], v[1], v[2], -v[3]); });
+	} else {
+		const float* in[3] = {c.c[0], c.c[1], c.c[2]};
+		cullN<3>(in, mask, n, [&](const V* v) { return inside(v[0], v[1], v[2], V::zero()); });
+	}
+}
+void cullAabbs(const float* planes, csoa lo, csoa hi, uint64_t* mask, std::size_t n) {
+	/// Each plane is tested against the box centre with the box extent
+	/// projected onto the plane normal as the radius
+	const CullPlanes p{planes};
+	const V half = V::set1(0.5f);
+	const float* in[6] = {lo.c[0], lo.c[1], lo.c[2], hi.c[0], hi.c[1], hi.c[2]};
+	cullN<6>(in, mask, n, [&](const V* v) {
+		const V cx = (v[0] + v[3]) * half, cy = (v[1] + v[4]) * half, cz = (v[2] + v[5]) * half;
+		const V ex = (v[3] - v[0]) * half, ey = (v[4] - v[1]) * half, ez = (v[5] - v[2]) * half;
+		const auto furthest = [&](int k) {
+			return fmadd(ez, p.az[k], fmadd(ey, p.ay[k], fmadd(ex, p.ax[k], p.distance(k, cx, cy, cz))));
+		};
+		auto m = furthest(0) >= V::zero();
+		for(int k = 1; k < 6; k++) m = m & (furthest(k) >= V::zero());
+		return m;
+	});
+}
+
+/// Element k of src + i * stride to planes[k][i] for i < count, for the first
+/// components elements (a multiple of 4). 4 at a time with SSE transposes
+template<std::size_t BLOCK>
+void gatherPlanes(const float* src, std::size_t stride, int components, std::size_t count, float (*planes)[BLOCK]) {
+	std::size_t i = 0;
+	for(; i + 4 <= count; i += 4) {
+		for(int c = 0; c < components; c += 4) {
+			simd::f32x4 r[4];
+			for(int k = 0; k < 4; k++) r[k] = simd::f32x4::load(src + (i + k) * stride + c);
+			simd::transpose(r[0], r[1], r[2], r[3]);
+			for(int k = 0; k < 4; k++) r[k].store(planes[c + k] + i);
+		}
+	}
+	for(; i < count; i++) {
+		for(int k = 0; k < components; k++) planes[k][i] = src[i * stride + k];
+	}
+}
+/// The inverse of gatherPlanes
+template<std::size_t BLOCK>
+void scatterPlanes(const float (*planes)[BLOCK], int components, std::size_t count, float* dest, std::size_t stride) {
+	std::size_t i = 0;
+	for(; i + 4 <= count; i += 4) {
+		for(int c = 0; c < components; c += 4) {
+			simd::f32x4 r[4];
+			for(int k = 0; k < 4; k++) r[k] = simd::f32x4::load(planes[c + k] + i);
+			simd::transpose(r[0], r[1], r[2], r[3]);
+			for(int k = 0; k < 4; k++) r[k].store(dest + (i + k) * stride + c);
+		}
+	}
+	for(; i < count; i++) {
+		for(int k = 0; k < components; k++) dest[i * stride + k] = planes[k][i];
+	}
+}
+void mvp(const float* vp, const float* models, float* out, std::size_t outStride,
+		 float* normals, std::size_t normalStride, std::size_t n) {
+	/// Blocks of matrices are transposed into 16 planes on the stack so that
+	/// V::width matrices are multiplied at once, then transposed back out.
+	/// The tail of the last block is zeroed
+	constexpr std::size_t BLOCK = 64;
+	alignas(64) float in[16][BLOCK], res[16][BLOCK], nrm[12][BLOCK];
+	V m[16];
+	for(int k = 0; k < 16; k++) m[k] = V::set1(vp[k]);
+	const V one = V::set1(1);
+
+	for(std::size_t i = 0; i < n; i += BLOCK) {
+		const std::size_t count = minOf(BLOCK, n - i);
+		gatherPlanes<BLOCK>(models + i * 16, 16, 16, count, in);
+		for(std::size_t j = count; j & (V::width - 1); j++) {
+			for(int k = 0; k < 16; k++) in[k][j] = 0;
+		}
+		for(std::size_t j = 0; j < count; j += V::width) {
+			V a[16];
+			for(int k = 0; k < 16; k++) a[k] = V::load(in[k] + j);
+			for(int c = 0; c < 4; c++) {
+				for(int r = 0; r < 4; r++) {
+					fmadd(m[12 + r], a[c * 4 + 3], fmadd(m[8 + r], a[c * 4 + 2],
+						fmadd(m[4 + r], a[c * 4 + 1], m[r] * a[c * 4]))).store(res[c * 4 + r] + j);
+				}
+			}
+			if(normals) {
+				/// The columns of the inverse transpose are the cross products of the columns / det
+				const V n0[3] = {a[5] * a[10] - a[6] * a[9], a[6] * a[8] - a[4] * a[10], a[4] * a[9] - a[5] * a[8]};
+				const V n1[3] = {a[9] * a[2] - a[10] * a[1], a[10] * a[0] - a[8] * a[2], a[8] * a[1] - a[9] * a[0]};
+				const V n2[3] = {a[1] * a[6] - a[2] * a[5], a[2] * a[4] - a[0] * a[6], a[0] * a[5] - a[1] * a[4]};
+				const V det = fmadd(a[2], n0[2], fmadd(a[1], n0[1], a[0] * n0[0]));
+				/// Singular models get zero normals
+				const auto singular = det == V::zero();
+				const V inv = select(singular, V::zero(), one / select(singular, one, det));
+				for(int r = 0; r < 3; r++) {
+					(n0[r] * inv).store(nrm[r] + j);
+					(n1[r] * inv).store(nrm[4 + r] + j);
+					(n2[r] * inv).store(nrm[8 + r] + j);
+				}
+				for(int c = 3; c < 12; c += 4) V::zero().store(nrm[c] + j);
+			}
+		}
+		scatterPlanes<BLOCK>(res, 16, count, out + i * outStride, outStride);
+		if(normals) {
+			scatterPlanes<BLOCK>(nrm, 12, count, normals + i * normalStride, normalStride);
+		}
+	}
+}
+
+Table makeTable(SimdLevel level) {
+	Table t;
+	t.level         = level;
+	t.dot3          = dot3;
+	t.dot4          = dot4;
+	t.cross3        = cross3;
+	t.length3       = length3;
+	t.length4       = length4;
+	t.normalise3    = normalise3;
+	t.normalise4    = normalise4;
+	t.lerp          = lerp;
+	t.transform4    = transform4;
+	t.transform3    = transform3;
+	t.transform2    = transform2;
+	t.mvp           = mvp;
+	t.madd          = madd;
+	t.scale         = scale;
+	t.rotate        = rotate;
+	t.slerp         = slerp;
+	t.skin          = skin;
+	t.toHalf        = toHalf;
+	t.fromHalf      = fromHalf;
+	t.toSnorm16     = toSnorm16;
+	t.fromSnorm16   = fromSnorm16;
+	t.toUnorm8      = toUnorm8;
+	t.fromUnorm8    = fromUnorm8;
+	t.octEncode     = octEncode;
+	t.octDecode     = octDecode;
+	t.toRgb10a2     = toRgb10a2;
+	t.fromRgb10a2   = fromRgb10a2;
+	t.toFloat       = toFloat;
+	t.dmul          = dmul;
+	t.dtransform4   = dtransform4;
+	t.dtranspose    = dtranspose;
+	t.dinverse      = dinverse;
+	t.dnormalise4   = dnormalise4;
+	t.mortonEncode2 = mortonEncode2;
+	t.mortonEncode3 = mortonEncode3;
+	t.mortonDecode2 = mortonDecode2;
+	t.mortonDecode3 = mortonDecode3;
+	t.bounds        = bounds;
+	t.sum           = sum;
+	t.compare       = compare;
+	t.select        = select;
+	t.clamp         = clamp;
+	t.step          = step;
+	t.cullSpheres   = cullSpheres;
+	t.cullAabbs     = cullAabbs;
+	t.toSoa         = toSoa;
+	t.fromSoa       = fromSoa;
+	t.toAosoa       = toAosoa;
+	t.fromAosoa     = fromAosoa;
+	return t;
+}
@@ -0,0 +1,31 @@
+///
+///	AVX2 batch kernels.
+///
+/// Does not use the precompiled header. See kernels.h
+///
+#if !defined(__AVX2__)
+#error "kernels_avx2.cpp must be compiled with /arch:AVX2"
+#endif
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <immintrin.h>
+#include <limits>
+#include "kernels.h"
+#include "simd.h"
+#include "trig.h"
+
+namespace maths::kernels {
+
+namespace avx2 {
+using V = simd::f32x8;
+#define MATHS_MORTON_BMI2
+#include "morton.inl"
+#include "kernels.inl"
+}
+
+Table avx2Table() {
+	return avx2::makeTable(SimdLevel::AVX2);
+}
+
+}
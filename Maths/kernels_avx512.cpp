@@ -0,0 +1,31 @@
+///
+///	AVX512 batch kernels.
+///
+/// Does not use the precompiled header. See kernels.h
+///
+#if !defined(__AVX512F__)
+#error "kernels_avx512.cpp must be compiled with /arch:AVX512"
+#endif
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <immintrin.h>
+#include <limits>
+#include "kernels.h"
+#include "simd.h"
+#include "trig.h"
+
+namespace maths::kernels {
+
+namespace avx512 {
+using V = simd::f32x16;
+#define MATHS_MORTON_BMI2
+#include "morton.inl"
+#include "kernels.inl"
+}
+
+Table avx512Table() {
+	return avx512::makeTable(SimdLevel::AVX512);
+}
+
+}
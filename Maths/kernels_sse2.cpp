@@ -0,0 +1,27 @@
+///
+///	SSE2 batch kernels.
+///
+/// Does not use the precompiled header. See kernels.h
+///
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <immintrin.h>
+#include <limits>
+#include "kernels.h"
+#include "simd.h"
+#include "trig.h"
+
+namespace maths::kernels {
+
+namespace sse2 {
+using V = simd::f32x4;
+#include "morton.inl"
+#include "kernels.inl"
+}
+
+Table sse2Table() {
+	return sse2::makeTable(SimdLevel::SSE2);
+}
+
+}
@@ -0,0 +1,106 @@
+#pragma once
+///
+///	Per element bit masks over spans.
+///
+/// std::vector<uint64_t> mask(maskWords(n));
+/// compare(distances, Compare::LT, radius, mask);
+/// std::vector<uint32_t> visible(countSet(mask));
+/// compact(mask, visible);
+///
+/// Element i is bit i % 64 of mask[i / 64]. The functions that write a
+/// mask clear the unused bits of the last word so that the mask can be
+/// counted and compacted without knowing the element count.
+///
+/// The comparisons, select, clamp and step run in the runtime selected
+/// kernels without branching on the data. For single vectors see the
+/// maskLT() etc. members of vector2/3/4 and the select() functions.
+///
+#include <bit>
+#include <cstdint>
+#include <span>
+#include "kernels.h"
+#include "streams.h"
+
+namespace maths {
+
+/// Number of 64 bit words needed for a mask of n elements
+constexpr std::size_t maskWords(std::size_t n) {
+	return (n + 63) / 64;
+}
+
+/// mask[i] = a[i] <op> b
+inline void compare(std::span<const float> a, Compare op, float b, std::span<uint64_t> mask) {
+	assert(mask.size() >= maskWords(a.size()));
+	kernels::table().compare(a.data(), nullptr, b, op, mask.data(), a.size());
+}
+/// mask[i] = a[i] <op> b[i]
+inline void compare(std::span<const float> a, Compare op, std::span<const float> b, std::span<uint64_t> mask) {
+	assert(a.size() == b.size() && mask.size() >= maskWords(a.size()));
+	kernels::table().compare(a.data(), b.data(), 0, op, mask.data(), a.size());
+}
+
+/// a &= b, a |= b, a &= ~b
+inline void maskAnd(std::span<uint64_t> a, std::span<const uint64_t> b) {
+	assert(a.size() == b.size());
+	for(std::size_t i = 0; i < a.size(); i++) a[i] &= b[i];
+}
+inline void maskOr(std::span<uint64_t> a, std::span<const uint64_t> b) {
+	assert(a.size() == b.size());
+	for(std::size_t i = 0; i < a.size(); i++) a[i] |= b[i];
+}
+inline void maskAndNot(std::span<uint64_t> a, std::span<const uint64_t> b) {
+	assert(a.size() == b.size());
+	for(std::size_t i = 0; i < a.size(); i++) a[i] &= ~b[i];
+}
+
+inline std::size_t countSet(std::span<const uint64_t> mask) {
+	std::size_t count = 0;
+	for(auto w : mask) count += std::popcount(w);
+	return count;
+}
+/// Write the indices of the set bits in increasing order. out must have
+/// room for countSet(mask) indices. Returns the number written
+inline std::size_t compact(std::span<const uint64_t> mask, std::span<uint32_t> out) {
+	std::size_t count = 0;
+	for(std::size_t w = 0; w < mask.size(); w++) {
+		for(uint64_t bits = mask[w]; bits != 0; bits &= bits - 1) {
+			assert(count < out.size());
+			out[count++] = (uint32_t)(w * 64 + std::countr_zero(bits));
+		}
+	}
+	return count;
+}
+
+/// out[i] = mask[i] ? a[i] : b[i]
+inline void selectAll(std::span<const uint64_t> mask, std::span<const float> a, std::span<const float> b, std::span<float> out) {
+	assert(a.size() == b.size() && a.size() == out.size() && mask.size() >= maskWords(a.size()));
+	kernels::table().select(mask.data(), a.data(), b.data(), out.data(), a.size());
+}
+inline void selectAll(std::span<const uint64_t> mask, cfloat3_span a, cfloat3_span b, float3_span out) {
+	selectAll(mask, a.x, b.x, out.x);
+	selectAll(mask, a.y, b.y, out.y);
+	selectAll(mask, a.z, b.z, out.z);
+}
+inline void selectAll(std::span<const uint64_t> mask, cfloat4_span a, cfloat4_span b, float4_span out) {
+	selectAll(mask, a.x, b.x, out.x);
+	selectAll(mask, a.y, b.y, out.y);
+	selectAll(mask, a.z, b.z, out.z);
+	selectAll(mask, a.w, b.w, out.w);
+}
+
+/// out[i] = min(max(in[i], lo), hi)
+inline void clampAll(std::span<const float> in, float lo, float hi, std::span<float> out) {
+	assert(in.size() == out.size());
+	kernels::table().clamp(in.data(), lo, hi, out.data(), in.size());
+}
+/// Clamp to [0, 1]
+inline void saturateAll(std::span<const float> in, std::span<float> out) {
+	clampAll(in, 0, 1, out);
+}
+/// out[i] = in[i] < edge ? 0 : 1
+inline void stepAll(float edge, std::span<const float> in, std::span<float> out) {
+	assert(in.size() == out.size());
+	kernels::table().step(edge, in.data(), out.data(), in.size());
+}
+
+}
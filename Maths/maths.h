@@ -2,7 +2,7 @@
 
 namespace maths {
 
-inline const float PI = 3.141592653589793f;
+inline constexpr float PI = 3.141592653589793f;
 
 inline constexpr float toRadians(float degs) {
 	return degs * PI / 180.0f;
@@ -11,17 +11,38 @@ inline constexpr float toDegrees(float rads) {
 	return rads * 180.0f / PI;
 }
 inline constexpr bool approxEqual(float a, float b) {
-	return a == b || std::abs(a - b) <= 0.0001f;
+	return a == b || (a < b ? b - a : a - b) <= 0.0001f;
 }
 std::vector<unsigned int> factorsOf(unsigned int n);
 
 }
 
+#include "constmath.h"
+#include "hash.h"
+#include "precision.h"
+#include "trig.h"
 #include "vector2.h"
 #include "vector3.h"
 #include "vector4.h"
 #include "matrix4.h"
+#include "matrix3.h"
+#include "affine3.h"
+#include "affine2.h"
+#include "quaternion.h"
 #include "camera.h"
 #include "camera2d.h"
 #include "camera3d.h"
+#include "kernels.h"
 #include "noise.h"
+#include "streams.h"
+#include "expr.h"
+#include "packed.h"
+#include "flat_map.h"
+#include "morton.h"
+#include "parallel.h"
+#include "reduce.h"
+#include "masks.h"
+#include "frustum.h"
+#include "transform.h"
+#include "animation.h"
+#include "hierarchy.h"
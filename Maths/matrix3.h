@@ -0,0 +1,145 @@
+#pragma once
+///
+///	A column-major 3x3 matrix.
+///
+/// c[0] c[1] c[2]
+///   0    3    6
+///   1    4    7
+///   2    5    8
+///
+/// translate, scale and rotate build 2D homogeneous transforms that apply
+/// to float3{x, y, 1}. rotate turns in the same direction as matrix4::rotateZ.
+/// fromMatrix takes the upper 3x3 of a matrix4, eg. for normals.
+///
+
+namespace maths {
+
+template<typename T>
+struct matrix3 final {
+    static_assert(std::is_floating_point<T>::value);
+
+    vector3<T> c[3];
+
+    constexpr vector3<T>& operator[](unsigned int index) {
+        assert(index < 3);
+        return c[index];
+    }
+    constexpr const vector3<T>& operator[](unsigned int index) const {
+        assert(index < 3);
+        return c[index];
+    }
+
+    constexpr static matrix3 columnMajor(std::initializer_list<T> il) {
+        assert(il.size() == 9);
+        const T* v = il.begin();
+        return {
+            vector3<T>(v[0], v[1], v[2]),
+            vector3<T>(v[3], v[4], v[5]),
+            vector3<T>(v[6], v[7], v[8])
+        };
+    }
+    constexpr static matrix3 rowMajor(std::initializer_list<T> il) {
+        assert(il.size() == 9);
+        const T* v = il.begin();
+        return {
+            vector3<T>(v[0], v[3], v[6]),
+            vector3<T>(v[1], v[4], v[7]),
+            vector3<T>(v[2], v[5], v[8])
+        };
+    }
+    constexpr static matrix3 identity() {
+        return {vector3<T>{1, 0, 0}, vector3<T>{0, 1, 0}, vector3<T>{0, 0, 1}};
+    }
+    /// The upper 3x3 of m
+    constexpr static matrix3 fromMatrix(const matrix4<T>& m) {
+        return {
+            vector3<T>{m[0].x, m[0].y, m[0].z},
+            vector3<T>{m[1].x, m[1].y, m[1].z},
+            vector3<T>{m[2].x, m[2].y, m[2].z}
+        };
+    }
+    constexpr static matrix3 translate(const vector2<T>& v) {
+        return {vector3<T>{1, 0, 0}, vector3<T>{0, 1, 0}, vector3<T>{v.x, v.y, 1}};
+    }
+    constexpr static matrix3 scale(const vector2<T>& v) {
+        return {vector3<T>{v.x, 0, 0}, vector3<T>{0, v.y, 0}, vector3<T>{0, 0, 1}};
+    }
+    constexpr static matrix3 rotate(T radians) {
+        T S, C;
+        trig::sincos(radians, S, C);
+        return {vector3<T>{C, S, 0}, vector3<T>{-S, C, 0}, vector3<T>{0, 0, 1}};
+    }
+
+    constexpr bool operator==(const matrix3& o) const {
+        return c[0] == o.c[0] && c[1] == o.c[1] && c[2] == o.c[2];
+    }
+    constexpr bool operator!=(const matrix3& o) const {
+        return !operator==(o);
+    }
+    constexpr bool approx(const matrix3& o) const {
+        return c[0].approx(o.c[0]) && c[1].approx(o.c[1]) && c[2].approx(o.c[2]);
+    }
+
+    constexpr matrix3 operator*(T s) const {
+        return {c[0] * s, c[1] * s, c[2] * s};
+    }
+    /// this * o, ie. apply o then this
+    constexpr matrix3 operator*(const matrix3& o) const {
+        return {operator*(o.c[0]), operator*(o.c[1]), operator*(o.c[2])};
+    }
+    constexpr vector3<T> operator*(const vector3<T>& v) const {
+        return c[0] * v.x + c[1] * v.y + c[2] * v.z;
+    }
+
+    constexpr matrix3 transposed() const {
+        return matrix3::rowMajor({
+            c[0].x, c[0].y, c[0].z,
+            c[1].x, c[1].y, c[1].z,
+            c[2].x, c[2].y, c[2].z
+        });
+    }
+    constexpr T determinant() const {
+        return c[0].tripleProduct(c[1], c[2]);
+    }
+    /// Returns the inverse. If the matrix is singular the adjugate is returned
+    constexpr matrix3 inversed() const {
+        T det = 0;
+        const matrix3 adj = adjugate(det);
+        if(det == 0) det = 1; /// this matrix has no inverse
+        return adj * (1 / det);
+    }
+    /// Sets result to the inverse and returns true, or returns false
+    /// leaving result unchanged if the matrix is singular
+    constexpr bool inversed(matrix3& result) const {
+        T det = 0;
+        const matrix3 adj = adjugate(det);
+        if(det == 0) return false;
+        result = adj * (1 / det);
+        return true;
+    }
+
+    std::string toString() const {
+        char buf[128];
+        sprintf_s(buf, "%5.2f %5.2f %5.2f\n%5.2f %5.2f %5.2f\n%5.2f %5.2f %5.2f",
+                  c[0].x, c[1].x, c[2].x,
+                  c[0].y, c[1].y, c[2].y,
+                  c[0].z, c[1].z, c[2].z);
+        return std::string(buf);
+    }
+private:
+    /// The rows of the adjugate are the cross products of the column pairs
+    constexpr matrix3 adjugate(T& det) const {
+        const vector3<T> r0 = c[1].cross(c[2]), r1 = c[2].cross(c[0]), r2 = c[0].cross(c[1]);
+        det = c[0].dot(r0);
+        return matrix3::rowMajor({
+            r0.x, r0.y, r0.z,
+            r1.x, r1.y, r1.z,
+            r2.x, r2.y, r2.z
+        });
+    }
+};
+
+typedef matrix3<float> float3x3;
+typedef matrix3<double> double3x3;
+
+}
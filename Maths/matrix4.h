@@ -7,10 +7,24 @@
 ///   1    5    9   13  
 ///   2    6   10   14  
 ///   3    7   11   15   
+///
+/// matrix4<float> is 32 byte aligned. Multiplication and transpose use
+/// SSE unless constant evaluated, with the same results as the scalar code.
+/// Only SSE is used here, whatever the translation unit is compiled for, so
+/// that the inline members are the same everywhere. Wider batch work goes
+/// through the runtime selected kernels (see kernels.h).
+///
+/// dmatrix uses two SSE2 registers per column (detail::f64x4). Batches of
+/// dmatrix products, inverses and transposes use the AVX kernels through
+/// multiply(), inversedAll() and transposedAll() in transform.h.
+///
+#include <array>
+#include "simd.h"
+
 namespace maths {
 
 template<typename T>
-struct matrix4 final {
+struct alignas(std::is_same_v<T, float> ? 32 : alignof(vector4<T>)) matrix4 final {
     static_assert(std::is_floating_point<T>::value);
 
     vector4<T> c[4];
@@ -69,8 +83,8 @@ struct matrix4 final {
     }
     constexpr static matrix4 rotateX(T radians) {
         auto m = matrix4::identity();
-        T C = cos(radians);
-        T S = sin(radians);
+        T S, C;
+        trig::sincos(radians, S, C);
         m[1][1] = C;
         m[1][2] = S;
         m[2][1] = -S;
@@ -79,8 +93,8 @@ struct matrix4 final {
     }
     constexpr static matrix4 rotateY(T radians) {
         auto m = matrix4::identity();
-        T C = cos(radians);
-        T S = sin(radians);
+        T S, C;
+        trig::sincos(radians, S, C);
         m[0][0] = C;
         m[0][2] = -S;
         m[2][0] = S;
@@ -89,8 +103,8 @@ struct matrix4 final {
     }
     constexpr static matrix4 rotateZ(T radians) {
         auto m = matrix4::identity();
-        T C = cos(radians);
-        T S = sin(radians);
+        T S, C;
+        trig::sincos(radians, S, C);
         m[0][0] = C;
         m[0][1] = S;
         m[1][0] = -S;
@@ -142,7 +156,7 @@ struct matrix4 final {
         return m;
     }
     constexpr static matrix4 perspectiveFovLH(T fovyRadians, T aspect, T znear, T zfar) {
-        T tanHalfFov = tan(fovyRadians / 2.0f);
+        T tanHalfFov = trig::tan(fovyRadians / 2);
         T yScale = 1.0f / tanHalfFov;
         T xScale = 1.0f / (aspect * tanHalfFov);
 
@@ -154,7 +168,7 @@ struct matrix4 final {
         });
     }
     constexpr static matrix4 perspectiveFovRH(T fovyRadians, T aspect, T znear, T zfar) {
-        T tanHalfFov = tan(fovyRadians / 2.0f);
+        T tanHalfFov = trig::tan(fovyRadians / 2);
         T yScale = 1.0f / tanHalfFov;
         T xScale = 1.0f / (aspect * tanHalfFov);
 
@@ -166,6 +180,16 @@ struct matrix4 final {
         });
     }
 
+    constexpr bool operator==(const matrix4& o) const {
+        return c[0] == o.c[0] && c[1] == o.c[1] && c[2] == o.c[2] && c[3] == o.c[3];
+    }
+    constexpr bool operator!=(const matrix4& o) const {
+        return !operator==(o);
+    }
+    constexpr bool approx(const matrix4& o) const {
+        return c[0].approx(o.c[0]) && c[1].approx(o.c[1]) && c[2].approx(o.c[2]) && c[3].approx(o.c[3]);
+    }
+
     constexpr matrix4 operator-() const {
         return {-c[0], -c[1], -c[2], -c[3]};
     }
@@ -193,6 +217,18 @@ struct matrix4 final {
     }
 
     constexpr matrix4 operator*(const matrix4& o) const {
+        if constexpr(std::is_same_v<T, float>) {
+            if(!std::is_constant_evaluated()) {
+                matrix4 r;
+                mulColumns(o, r);
+                return r;
+            }
+        }
+        if constexpr(std::is_same_v<T, double>) {
+            if(!std::is_constant_evaluated()) {
+                return {mulColumn(o.c[0]), mulColumn(o.c[1]), mulColumn(o.c[2]), mulColumn(o.c[3])};
+            }
+        }
         return {
             c[0] * o.c[0].x + c[1] * o.c[0].y + c[2] * o.c[0].z + c[3] * o.c[0].w,
             c[0] * o.c[1].x + c[1] * o.c[1].y + c[2] * o.c[1].z + c[3] * o.c[1].w,
@@ -201,6 +237,14 @@ struct matrix4 final {
         };
     }
     constexpr vector4<T> operator*(const vector4<T>& v) const {
+        if constexpr(std::is_same_v<T, float>) {
+            if(!std::is_constant_evaluated()) {
+                return vector4<T>{mulColumn(v.m128())};
+            }
+        }
+        if constexpr(std::is_same_v<T, double>) {
+            if(!std::is_constant_evaluated()) return mulColumn(v);
+        }
         return (c[0] * v.x) +
             (c[1] * v.y) +
             (c[2] * v.z) +
@@ -208,6 +252,20 @@ struct matrix4 final {
     }
 
     constexpr matrix4 transposed() const {
+        if constexpr(std::is_same_v<T, float>) {
+            if(!std::is_constant_evaluated()) {
+                simd::f32x4 a = c[0].m128(), b = c[1].m128(), d = c[2].m128(), e = c[3].m128();
+                simd::transpose(a, b, d, e);
+                return {vector4<T>{a.v}, vector4<T>{b.v}, vector4<T>{d.v}, vector4<T>{e.v}};
+            }
+        }
+        if constexpr(std::is_same_v<T, double>) {
+            if(!std::is_constant_evaluated()) {
+                detail::f64x4 a = c[0].f64(), b = c[1].f64(), d = c[2].f64(), e = c[3].f64();
+                detail::f64x4::transpose(a, b, d, e);
+                return {vector4<T>{a}, vector4<T>{b}, vector4<T>{d}, vector4<T>{e}};
+            }
+        }
         return matrix4::rowMajor({
             c[0][0], c[0][1], c[0][2], c[0][3],
             c[1][0], c[1][1], c[1][2], c[1][3],
@@ -217,38 +275,222 @@ struct matrix4 final {
     }
 
     constexpr T determinant() const {
-        return c[0][0] * c[1][1] * c[2][2] * c[3][3] - c[0][0] * c[1][1] * c[3][2] * c[2][3] + c[0][0] * c[2][1] * c[3][2] * c[1][3] - c[0][0] * c[2][1] * c[1][2] * c[3][3] +
-            c[0][0] * c[3][1] * c[1][2] * c[2][3] - c[0][0] * c[3][1] * c[2][2] * c[1][3] - c[1][0] * c[2][1] * c[3][2] * c[0][3] + c[1][0] * c[2][1] * c[0][2] * c[3][3] -
-            c[1][0] * c[3][1] * c[0][2] * c[2][3] + c[1][0] * c[3][1] * c[2][2] * c[0][3] - c[1][0] * c[0][1] * c[2][2] * c[3][3] + c[1][0] * c[0][1] * c[3][2] * c[2][3] +
-            c[2][0] * c[3][1] * c[0][2] * c[1][3] - c[2][0] * c[3][1] * c[1][2] * c[0][3] + c[2][0] * c[0][1] * c[1][2] * c[3][3] - c[2][0] * c[0][1] * c[3][2] * c[1][3] +
-            c[2][0] * c[1][1] * c[3][2] * c[0][3] - c[2][0] * c[1][1] * c[0][2] * c[3][3] - c[3][0] * c[0][1] * c[1][2] * c[2][3] + c[3][0] * c[0][1] * c[2][2] * c[1][3] -
-            c[3][0] * c[1][1] * c[2][2] * c[0][3] + c[3][0] * c[1][1] * c[0][2] * c[2][3] - c[3][0] * c[2][1] * c[0][2] * c[1][3] + c[3][0] * c[2][1] * c[1][2] * c[0][3];
+        const auto s = minors(0, 1), k = minors(2, 3);
+        return s[0] * k[5] - s[1] * k[4] + s[2] * k[3] + s[3] * k[2] - s[4] * k[1] + s[5] * k[0];
     }
 
+    /// Returns the inverse. If the matrix is singular the adjugate is returned
     constexpr matrix4 inversed() const {
-        T det = determinant();
+        matrix4 adj;
+        T det = adjugate(adj);
+        if(det == 0) det = 1; /// this matrix has no inverse
+        return adj * (1 / det);
+    }
+    /// Sets result to the inverse and returns true, or returns false
+    /// leaving result unchanged if the matrix is singular
+    constexpr bool inversed(matrix4& result) const {
+        matrix4 adj;
+        const T det = adjugate(adj);
+        if(det == 0) return false;
+        result = adj * (1 / det);
+        return true;
+    }
+    /// Inverse of an affine matrix ie. one whose last row is [0 0 0 1].
+    /// Inverts the upper 3x3 and transforms the negated translation by it
+    constexpr matrix4 inversedAffine() const {
+        assert(c[0].w == 0 && c[1].w == 0 && c[2].w == 0 && c[3].w == 1);
+        const vector3<T> a{c[0].x, c[0].y, c[0].z}, b{c[1].x, c[1].y, c[1].z}, d{c[2].x, c[2].y, c[2].z};
+        const vector3<T> r0 = b.cross(d), r1 = d.cross(a), r2 = a.cross(b);
+        T det = a.dot(r0);
         if(det == 0) det = 1; /// this matrix has no inverse
-        T d = 1 / det;
-        matrix4 result;
-        result.c[0][0] = d * (c[1][1] * (c[2][2] * c[3][3] - c[3][2] * c[2][3]) + c[2][1] * (c[3][2] * c[1][3] - c[1][2] * c[3][3]) + c[3][1] * (c[1][2] * c[2][3] - c[2][2] * c[1][3]));
-        result.c[0][1] = -d * (c[0][1] * (c[2][2] * c[3][3] - c[3][2] * c[2][3]) + c[2][1] * (c[3][2] * c[0][3] - c[0][2] * c[3][3]) + c[3][1] * (c[0][2] * c[2][3] - c[2][2] * c[0][3]));
-        result.c[0][2] = d * (c[0][1] * (c[1][2] * c[3][3] - c[3][2] * c[1][3]) + c[1][1] * (c[3][2] * c[0][3] - c[0][2] * c[3][3]) + c[3][1] * (c[0][2] * c[1][3] - c[1][2] * c[0][3]));
-        result.c[0][3] = -d * (c[0][1] * (c[1][2] * c[2][3] - c[2][2] * c[1][3]) + c[1][1] * (c[2][2] * c[0][3] - c[0][2] * c[2][3]) + c[2][1] * (c[0][2] * c[1][3] - c[1][2] * c[0][3]));
-        result.c[1][0] = -d * (c[1][0] * (c[2][2] * c[3][3] - c[3][2] * c[2][3]) + c[2][0] * (c[3][2] * c[1][3] - c[1][2] * c[3][3]) + c[3][0] * (c[1][2] * c[2][3] - c[2][2] * c[1][3]));
-        result.c[1][1] = d * (c[0][0] * (c[2][2] * c[3][3] - c[3][2] * c[2][3]) + c[2][0] * (c[3][2] * c[0][3] - c[0][2] * c[3][3]) + c[3][0] * (c[0][2] * c[2][3] - c[2][2] * c[0][3]));
-        result.c[1][2] = -d * (c[0][0] * (c[1][2] * c[3][3] - c[3][2] * c[1][3]) + c[1][0] * (c[3][2] * c[0][3] - c[0][2] * c[3][3]) + c[3][0] * (c[0][2] * c[1][3] - c[1][2] * c[0][3]));
-        result.c[1][3] = d * (c[0][0] * (c[1][2] * c[2][3] - c[2][2] * c[1][3]) + c[1][0] * (c[2][2] * c[0][3] - c[0][2] * c[2][3]) + c[2][0] * (c[0][2] * c[1][3] - c[1][2] * c[0][3]));
-        result.c[2][0] = d * (c[1][0] * (c[2][1] * c[3][3] - c[3][1] * c[2][3]) + c[2][0] * (c[3][1] * c[1][3] - c[1][1] * c[3][3]) + c[3][0] * (c[1][1] * c[2][3] - c[2][1] * c[1][3]));
-        result.c[2][1] = -d * (c[0][0] * (c[2][1] * c[3][3] - c[3][1] * c[2][3]) + c[2][0] * (c[3][1] * c[0][3] - c[0][1] * c[3][3]) + c[3][0] * (c[0][1] * c[2][3] - c[2][1] * c[0][3]));
-        result.c[2][2] = d * (c[0][0] * (c[1][1] * c[3][3] - c[3][1] * c[1][3]) + c[1][0] * (c[3][1] * c[0][3] - c[0][1] * c[3][3]) + c[3][0] * (c[0][1] * c[1][3] - c[1][1] * c[0][3]));
-        result.c[2][3] = -d * (c[0][0] * (c[1][1] * c[2][3] - c[2][1] * c[1][3]) + c[1][0] * (c[2][1] * c[0][3] - c[0][1] * c[2][3]) + c[2][0] * (c[0][1] * c[1][3] - c[1][1] * c[0][3]));
-        result.c[3][0] = -d * (c[1][0] * (c[2][1] * c[3][2] - c[3][1] * c[2][2]) + c[2][0] * (c[3][1] * c[1][2] - c[1][1] * c[3][2]) + c[3][0] * (c[1][1] * c[2][2] - c[2][1] * c[1][2]));
-        result.c[3][1] = d * (c[0][0] * (c[2][1] * c[3][2] - c[3][1] * c[2][2]) + c[2][0] * (c[3][1] * c[0][2] - c[0][1] * c[3][2]) + c[3][0] * (c[0][1] * c[2][2] - c[2][1] * c[0][2]));
-        result.c[3][2] = -d * (c[0][0] * (c[1][1] * c[3][2] - c[3][1] * c[1][2]) + c[1][0] * (c[3][1] * c[0][2] - c[0][1] * c[3][2]) + c[3][0] * (c[0][1] * c[1][2] - c[1][1] * c[0][2]));
-        result.c[3][3] = d * (c[0][0] * (c[1][1] * c[2][2] - c[2][1] * c[1][2]) + c[1][0] * (c[2][1] * c[0][2] - c[0][1] * c[2][2]) + c[2][0] * (c[0][1] * c[1][2] - c[1][1] * c[0][2]));
-        return result;
+        const T id = 1 / det;
+        const auto m = matrix4::rowMajor({
+            r0.x * id, r0.y * id, r0.z * id, 0,
+            r1.x * id, r1.y * id, r1.z * id, 0,
+            r2.x * id, r2.y * id, r2.z * id, 0,
+            0, 0, 0, 1
+        });
+        return m.withTranslation(-c[3]);
+    }
+    /// Inverse of a rotation plus translation with no scale, such as the
+    /// lookAt matrices. Transposes the rotation and negates the translation
+    constexpr matrix4 inversedRigid() const {
+        assert(c[0].w == 0 && c[1].w == 0 && c[2].w == 0 && c[3].w == 1);
+        matrix4 m{c[0], c[1], c[2], vector4<T>{0, 0, 0, 1}};
+        return m.transposed().withTranslation(-c[3]);
+    }
+    /// Inverse of the perspectiveFov matrices, which only have x and y scales
+    /// and a 2x2 zw block [c d; e 0]
+    constexpr matrix4 inversedPerspective() const {
+        assert(c[0].y == 0 && c[0].z == 0 && c[0].w == 0 && c[1].x == 0 && c[1].z == 0 && c[1].w == 0);
+        assert(c[2].x == 0 && c[2].y == 0 && c[3].x == 0 && c[3].y == 0 && c[3].w == 0);
+        const T d = c[3].z, e = c[2].w;
+        matrix4 m;
+        m[0][0] = 1 / c[0].x;
+        m[1][1] = 1 / c[1].y;
+        m[2][3] = 1 / d;
+        m[3][2] = 1 / e;
+        m[3][3] = -c[2].z / (d * e);
+        return m;
+    }
+    /// Inverse of the ortho matrices and any other scale plus translation
+    constexpr matrix4 inversedOrtho() const {
+        assert(c[0].y == 0 && c[0].z == 0 && c[0].w == 0 && c[1].x == 0 && c[1].z == 0 && c[1].w == 0);
+        assert(c[2].x == 0 && c[2].y == 0 && c[2].w == 0 && c[3].w == 1);
+        const vector4<T> s{1 / c[0].x, 1 / c[1].y, 1 / c[2].z, 1};
+        matrix4 m;
+        m[0][0] = s.x;
+        m[1][1] = s.y;
+        m[2][2] = s.z;
+        m[3] = vector4<T>{-c[3].x * s.x, -c[3].y * s.y, -c[3].z * s.z, 1};
+        return m;
+    }
+
+private:
+    /// this with c[3] set to the upper 3x3 * t.xyz and c[3].w = 1
+    constexpr matrix4 withTranslation(const vector4<T>& t) const {
+        matrix4 m = *this;
+        m.c[3] = c[0] * t.x + c[1] * t.y + c[2] * t.z;
+        m.c[3].w = 1;
+        return m;
+    }
+    /// The 6 2x2 determinants of columns i and j:
+    /// rows (0,1) (0,2) (0,3) (1,2) (1,3) (2,3)
+    constexpr std::array<T, 6> minors(unsigned i, unsigned j) const {
+        const auto& a = c[i];
+        const auto& b = c[j];
+        return {
+            a[0] * b[1] - b[0] * a[1],
+            a[0] * b[2] - b[0] * a[2],
+            a[0] * b[3] - b[0] * a[3],
+            a[1] * b[2] - b[1] * a[2],
+            a[1] * b[3] - b[1] * a[3],
+            a[2] * b[3] - b[2] * a[3]
+        };
+    }
+    /// Sets adj to the adjugate (transposed cofactor matrix) using the 12
+    /// 2x2 minors of the column pairs (0,1) and (2,3). Returns the determinant
+    constexpr T adjugate(matrix4& adj) const {
+        if constexpr(std::is_same_v<T, float>) {
+            if(!std::is_constant_evaluated()) {
+                return adjugateSse(adj);
+            }
+        }
+        if constexpr(std::is_same_v<T, double>) {
+            if(!std::is_constant_evaluated()) {
+                return adjugateF64(adj);
+            }
+        }
+        const auto s = minors(0, 1), k = minors(2, 3);
+        adj.c[0] = { c[1][1] * k[5] - c[1][2] * k[4] + c[1][3] * k[3],
+                    -c[0][1] * k[5] + c[0][2] * k[4] - c[0][3] * k[3],
+                     c[3][1] * s[5] - c[3][2] * s[4] + c[3][3] * s[3],
+                    -c[2][1] * s[5] + c[2][2] * s[4] - c[2][3] * s[3]};
+        adj.c[1] = {-c[1][0] * k[5] + c[1][2] * k[2] - c[1][3] * k[1],
+                     c[0][0] * k[5] - c[0][2] * k[2] + c[0][3] * k[1],
+                    -c[3][0] * s[5] + c[3][2] * s[2] - c[3][3] * s[1],
+                     c[2][0] * s[5] - c[2][2] * s[2] + c[2][3] * s[1]};
+        adj.c[2] = { c[1][0] * k[4] - c[1][1] * k[2] + c[1][3] * k[0],
+                    -c[0][0] * k[4] + c[0][1] * k[2] - c[0][3] * k[0],
+                     c[3][0] * s[4] - c[3][1] * s[2] + c[3][3] * s[0],
+                    -c[2][0] * s[4] + c[2][1] * s[2] - c[2][3] * s[0]};
+        adj.c[3] = {-c[1][0] * k[3] + c[1][1] * k[1] - c[1][2] * k[0],
+                     c[0][0] * k[3] - c[0][1] * k[1] + c[0][2] * k[0],
+                    -c[3][0] * s[3] + c[3][1] * s[1] - c[3][2] * s[0],
+                     c[2][0] * s[3] - c[2][1] * s[1] + c[2][2] * s[0]};
+        return s[0] * k[5] - s[1] * k[4] + s[2] * k[3] + s[3] * k[2] - s[4] * k[1] + s[5] * k[0];
+    }
+    /// The same calculation four lanes at a time. Lane l of adj.c[i] uses
+    /// column (1, 0, 3, 2)[l] and the minors of columns (2,3) in lanes 0 and 1
+    /// and of columns (0,1) in lanes 2 and 3
+    float adjugateSse(matrix4& adj) const {
+        const __m128 m0 = c[0].m128(), m1 = c[1].m128(), m2 = c[2].m128(), m3 = c[3].m128();
+        /// e[n] = (m2[n], m2[n], m0[n], m0[n]), f[n] = (m3[n], m3[n], m1[n], m1[n])
+        const __m128 e0 = _mm_shuffle_ps(m2, m0, _MM_SHUFFLE(0, 0, 0, 0));
+        const __m128 e1 = _mm_shuffle_ps(m2, m0, _MM_SHUFFLE(1, 1, 1, 1));
+        const __m128 e2 = _mm_shuffle_ps(m2, m0, _MM_SHUFFLE(2, 2, 2, 2));
+        const __m128 e3 = _mm_shuffle_ps(m2, m0, _MM_SHUFFLE(3, 3, 3, 3));
+        const __m128 f0 = _mm_shuffle_ps(m3, m1, _MM_SHUFFLE(0, 0, 0, 0));
+        const __m128 f1 = _mm_shuffle_ps(m3, m1, _MM_SHUFFLE(1, 1, 1, 1));
+        const __m128 f2 = _mm_shuffle_ps(m3, m1, _MM_SHUFFLE(2, 2, 2, 2));
+        const __m128 f3 = _mm_shuffle_ps(m3, m1, _MM_SHUFFLE(3, 3, 3, 3));
+        const __m128 k0 = _mm_sub_ps(_mm_mul_ps(e0, f1), _mm_mul_ps(f0, e1));
+        const __m128 k1 = _mm_sub_ps(_mm_mul_ps(e0, f2), _mm_mul_ps(f0, e2));
+        const __m128 k2 = _mm_sub_ps(_mm_mul_ps(e0, f3), _mm_mul_ps(f0, e3));
+        const __m128 k3 = _mm_sub_ps(_mm_mul_ps(e1, f2), _mm_mul_ps(f1, e2));
+        const __m128 k4 = _mm_sub_ps(_mm_mul_ps(e1, f3), _mm_mul_ps(f1, e3));
+        const __m128 k5 = _mm_sub_ps(_mm_mul_ps(e2, f3), _mm_mul_ps(f2, e3));
+
+        /// a[n] = row n of the columns (1, 0, 3, 2)
+        simd::f32x4 a0{m1}, a1{m0}, a2{m3}, a3{m2};
+        simd::transpose(a0, a1, a2, a3);
+
+        const __m128 even = _mm_setr_ps(0.0f, -0.0f, 0.0f, -0.0f);
+        const __m128 odd  = _mm_setr_ps(-0.0f, 0.0f, -0.0f, 0.0f);
+        const __m128 r0 = _mm_add_ps(_mm_sub_ps(_mm_mul_ps(a1.v, k5), _mm_mul_ps(a2.v, k4)), _mm_mul_ps(a3.v, k3));
+        const __m128 r1 = _mm_add_ps(_mm_sub_ps(_mm_mul_ps(a0.v, k5), _mm_mul_ps(a2.v, k2)), _mm_mul_ps(a3.v, k1));
+        const __m128 r2 = _mm_add_ps(_mm_sub_ps(_mm_mul_ps(a0.v, k4), _mm_mul_ps(a1.v, k2)), _mm_mul_ps(a3.v, k0));
+        const __m128 r3 = _mm_add_ps(_mm_sub_ps(_mm_mul_ps(a0.v, k3), _mm_mul_ps(a1.v, k1)), _mm_mul_ps(a2.v, k0));
+        const __m128 b0 = _mm_xor_ps(r0, even);
+        const __m128 b1 = _mm_xor_ps(r1, odd);
+        const __m128 b2 = _mm_xor_ps(r2, even);
+        const __m128 b3 = _mm_xor_ps(r3, odd);
+        _mm_store_ps(&adj.c[0].x, b0);
+        _mm_store_ps(&adj.c[1].x, b1);
+        _mm_store_ps(&adj.c[2].x, b2);
+        _mm_store_ps(&adj.c[3].x, b3);
+
+        /// det = c[0] . the first lane of each adjugate column
+        const __m128 col0 = _mm_movelh_ps(_mm_unpacklo_ps(b0, b1), _mm_unpacklo_ps(b2, b3));
+        const __m128 p = _mm_mul_ps(m0, col0);
+        const __m128 h = _mm_add_ps(p, _mm_movehl_ps(p, p));
+        return _mm_cvtss_f32(_mm_add_ss(h, _mm_shuffle_ps(h, h, _MM_SHUFFLE(1, 1, 1, 1))));
+    }
+    /// ((c[0] * v.x + c[1] * v.y) + c[2] * v.z) + c[3] * v.w
+    __m128 mulColumn(__m128 v) const {
+        const __m128 x = _mm_mul_ps(c[0].m128(), _mm_shuffle_ps(v, v, _MM_SHUFFLE(0, 0, 0, 0)));
+        const __m128 y = _mm_mul_ps(c[1].m128(), _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 1, 1, 1)));
+        const __m128 z = _mm_mul_ps(c[2].m128(), _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 2, 2, 2)));
+        const __m128 w = _mm_mul_ps(c[3].m128(), _mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 3, 3, 3)));
+        return _mm_add_ps(_mm_add_ps(_mm_add_ps(x, y), z), w);
+    }
+    /// r.c[i] = this * o.c[i]. Adds in the same order as the scalar code
+    void mulColumns(const matrix4& o, matrix4& r) const {
+        for(int i = 0; i < 4; i++) {
+            _mm_store_ps(&r.c[i].x, mulColumn(o.c[i].m128()));
+        }
     }
+    /// ((c[0] * v.x + c[1] * v.y) + c[2] * v.z) + c[3] * v.w for dmatrix
+    vector4<T> mulColumn(const vector4<T>& v) const requires std::is_same_v<T, double> {
+        using detail::f64x4;
+        const f64x4 r = c[0].f64() * f64x4::set1(v.x) + c[1].f64() * f64x4::set1(v.y) +
+            c[2].f64() * f64x4::set1(v.z) + c[3].f64() * f64x4::set1(v.w);
+        return vector4<T>{r};
+    }
+    /// adjugateSse() for dmatrix. The lanes are gathered with setr rather than shuffles
+    double adjugateF64(matrix4& adj) const requires std::is_same_v<T, double> {
+        using detail::f64x4;
+        f64x4 e[4], f[4], a[4];
+        for(int n = 0; n < 4; n++) {
+            e[n] = f64x4::setr(c[2][n], c[2][n], c[0][n], c[0][n]);
+            f[n] = f64x4::setr(c[3][n], c[3][n], c[1][n], c[1][n]);
+            a[n] = f64x4::setr(c[1][n], c[0][n], c[3][n], c[2][n]);
+        }
+        const f64x4 k0 = e[0] * f[1] - f[0] * e[1];
+        const f64x4 k1 = e[0] * f[2] - f[0] * e[2];
+        const f64x4 k2 = e[0] * f[3] - f[0] * e[3];
+        const f64x4 k3 = e[1] * f[2] - f[1] * e[2];
+        const f64x4 k4 = e[1] * f[3] - f[1] * e[3];
+        const f64x4 k5 = e[2] * f[3] - f[2] * e[3];
 
+        const f64x4 even = f64x4::setr(1, -1, 1, -1), odd = f64x4::setr(-1, 1, -1, 1);
+        adj.c[0] = vector4<T>{(a[1] * k5 - a[2] * k4 + a[3] * k3) * even};
+        adj.c[1] = vector4<T>{(a[0] * k5 - a[2] * k2 + a[3] * k1) * odd};
+        adj.c[2] = vector4<T>{(a[0] * k4 - a[1] * k2 + a[3] * k0) * even};
+        adj.c[3] = vector4<T>{(a[0] * k3 - a[1] * k1 + a[2] * k0) * odd};
+        return c[0].x * adj.c[0].x + c[0].y * adj.c[1].x + c[0].z * adj.c[2].x + c[0].w * adj.c[3].x;
+    }
+public:
     std::string toString() const {
         char buf[256];
         sprintf_s(buf, "%5.2f %5.2f %5.2f %5.2f\n%5.2f %5.2f %5.2f %5.2f\n%5.2f %5.2f %5.2f %5.2f\n%5.2f %5.2f %5.2f %5.2f",
@@ -263,4 +505,21 @@ struct matrix4 final {
 typedef matrix4<float> matrix;
 typedef matrix4<double> dmatrix;
 
+/// float4 * matrix (declared in the float4 specialisation)
+inline constexpr float4 float4::operator*(const matrix& o) const {
+    if(std::is_constant_evaluated()) {
+        return {o[0].x * x + o[0].y * y + o[0].z * z + o[0].w * w,
+            o[1].x * x + o[1].y * y + o[1].z * z + o[1].w * w,
+            o[2].x * x + o[2].y * y + o[2].z * z + o[2].w * w,
+            o[3].x * x + o[3].y * y + o[3].z * z + o[3].w * w};
+    }
+    __m128 v  = m128();
+    __m128 c0 = _mm_mul_ps(o[0].m128(), v);
+    __m128 c1 = _mm_mul_ps(o[1].m128(), v);
+    __m128 c2 = _mm_mul_ps(o[2].m128(), v);
+    __m128 c3 = _mm_mul_ps(o[3].m128(), v);
+    _MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+    return float4{_mm_add_ps(_mm_add_ps(c0, c1), _mm_add_ps(c2, c3))};
+}
+
 }
\ No newline at end of file
@@ -0,0 +1,137 @@
+#pragma once
+///
+///	Morton (Z-order) codes.
+///
+/// uint64_t code = morton::encode<uint64_t>(uint3{x, y, z});
+/// uint3 v = morton::decode3(code);
+///
+/// Bits used per coordinate:
+///
+///           uint32_t  uint64_t
+///   uint2      16        32
+///   uint3      10        21
+///
+/// Higher coordinate bits are ignored. encode() and decode2/3() use shifts
+/// and masks in every translation unit. The span versions produce 64 bit
+/// codes using the runtime selected kernels, which use BMI2 pdep/pext at
+/// the AVX2 level and above.
+///
+/// order() and sort() arrange float3 points along a Z-order curve through
+/// their bounding box using a radix sort of their 63 bit codes.
+///
+#include <cstdint>
+#include <span>
+#include <vector>
+#include "kernels.h"
+
+namespace maths::morton {
+
+#include "morton.inl"
+
+template<typename C = uint32_t>
+C encode(const uint2& v) {
+	static_assert(std::is_same_v<C, uint32_t> || std::is_same_v<C, uint64_t>);
+	return spread2<C>(v.x) | (spread2<C>(v.y) << 1);
+}
+template<typename C = uint32_t>
+C encode(const uint3& v) {
+	static_assert(std::is_same_v<C, uint32_t> || std::is_same_v<C, uint64_t>);
+	return spread3<C>(v.x) | (spread3<C>(v.y) << 1) | (spread3<C>(v.z) << 2);
+}
+template<typename C>
+uint2 decode2(C code) {
+	return {compact2(code), compact2<C>(code >> 1)};
+}
+template<typename C>
+uint3 decode3(C code) {
+	return {compact3(code), compact3<C>(code >> 1), compact3<C>(code >> 2)};
+}
+
+/// out[i] = encode<uint64_t>(in[i])
+inline void encode(std::span<const uint2> in, std::span<uint64_t> out) {
+	assert(in.size() == out.size());
+	kernels::table().mortonEncode2((const uint32_t*)in.data(), out.data(), in.size());
+}
+inline void encode(std::span<const uint3> in, std::span<uint64_t> out) {
+	assert(in.size() == out.size());
+	kernels::table().mortonEncode3((const uint32_t*)in.data(), out.data(), in.size());
+}
+/// out[i] = decode2/3(in[i])
+inline void decode(std::span<const uint64_t> in, std::span<uint2> out) {
+	assert(in.size() == out.size());
+	kernels::table().mortonDecode2(in.data(), (uint32_t*)out.data(), in.size());
+}
+inline void decode(std::span<const uint64_t> in, std::span<uint3> out) {
+	assert(in.size() == out.size());
+	kernels::table().mortonDecode3(in.data(), (uint32_t*)out.data(), in.size());
+}
+
+/// Stable LSD radix sort of keys, 8 bits per pass, applying the same
+/// permutation to values. Passes where every key has the same digit are skipped
+inline void sortByKey(std::vector<uint64_t>& keys, std::vector<uint32_t>& values) {
+	assert(keys.size() == values.size());
+	const std::size_t n = keys.size();
+	std::vector<uint64_t> keys2(n);
+	std::vector<uint32_t> values2(n);
+
+	for(int shift = 0; shift < 64; shift += 8) {
+		std::size_t offsets[256] = {};
+		for(auto k : keys) offsets[(k >> shift) & 0xff]++;
+		if(n == 0 || offsets[(keys[0] >> shift) & 0xff] == n) continue;
+
+		std::size_t total = 0;
+		for(auto& o : offsets) {
+			const std::size_t c = o;
+			o = total;
+			total += c;
+		}
+		for(std::size_t i = 0; i < n; i++) {
+			const std::size_t dest = offsets[(keys[i] >> shift) & 0xff]++;
+			keys2[dest] = keys[i];
+			values2[dest] = values[i];
+		}
+		keys.swap(keys2);
+		values.swap(values2);
+	}
+}
+
+/// Indices of points in Z-order through their bounding box. Each axis
+/// is quantised to 21 bits. Points with equal codes keep their order
+inline std::vector<uint32_t> order(std::span<const float3> points) {
+	const std::size_t n = points.size();
+	std::vector<uint32_t> index(n);
+	if(n == 0) return index;
+
+	float3 lo = points[0], hi = points[0];
+	for(auto& p : points) {
+		lo = lo.min(p);
+		hi = hi.max(p);
+	}
+	const float3 extent = hi - lo;
+	const float scale = (1 << 21) - 1;
+	const float3 s = {
+		extent.x > 0 ? scale / extent.x : 0,
+		extent.y > 0 ? scale / extent.y : 0,
+		extent.z > 0 ? scale / extent.z : 0
+	};
+
+	std::vector<uint3> q(n);
+	for(std::size_t i = 0; i < n; i++) {
+		const float3 f = (points[i] - lo) * s;
+		q[i] = {(uint32_t)std::min(f.x, scale), (uint32_t)std::min(f.y, scale), (uint32_t)std::min(f.z, scale)};
+		index[i] = (uint32_t)i;
+	}
+	std::vector<uint64_t> keys(n);
+	encode(q, keys);
+	sortByKey(keys, index);
+	return index;
+}
+/// Reorder points into Z-order
+inline void sort(std::span<float3> points) {
+	const auto index = order(points);
+	std::vector<float3> sorted(points.size());
+	for(std::size_t i = 0; i < index.size(); i++) sorted[i] = points[index[i]];
+	std::copy(sorted.begin(), sorted.end(), points.begin());
+}
+
+}
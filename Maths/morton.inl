@@ -0,0 +1,101 @@
+///
+///	Morton bit interleaving. Included inside a namespace by morton.h and by
+/// each kernels_<isa>.cpp. pdep/pext (BMI2) are used only if the including
+/// file defines MATHS_MORTON_BMI2, which kernels_avx2.cpp and kernels_avx512.cpp
+/// do. Magic-bit shifts are used otherwise, so the inline functions in
+/// morton.h are the same whatever a translation unit is compiled for.
+///
+/// spread2/3 move the low bits of x to every 2nd/3rd bit of a C.
+/// compact2/3 are the inverse.
+///
+
+template<typename C>
+C spread2(uint32_t x) {
+#if defined(MATHS_MORTON_BMI2)
+	if constexpr(sizeof(C) == 4) return _pdep_u32(x, 0x55555555u);
+	else return _pdep_u64(x, 0x5555555555555555ull);
+#else
+	if constexpr(sizeof(C) == 4) {
+		x &= 0x0000ffff;
+		x = (x | (x << 8)) & 0x00ff00ff;
+		x = (x | (x << 4)) & 0x0f0f0f0f;
+		x = (x | (x << 2)) & 0x33333333;
+		return (x | (x << 1)) & 0x55555555;
+	} else {
+		uint64_t v = x;
+		v = (v | (v << 16)) & 0x0000ffff0000ffffull;
+		v = (v | (v << 8)) & 0x00ff00ff00ff00ffull;
+		v = (v | (v << 4)) & 0x0f0f0f0f0f0f0f0full;
+		v = (v | (v << 2)) & 0x3333333333333333ull;
+		return (v | (v << 1)) & 0x5555555555555555ull;
+	}
+#endif
+}
+template<typename C>
+uint32_t compact2(C x) {
+#if defined(MATHS_MORTON_BMI2)
+	if constexpr(sizeof(C) == 4) return _pext_u32(x, 0x55555555u);
+	else return (uint32_t)_pext_u64(x, 0x5555555555555555ull);
+#else
+	if constexpr(sizeof(C) == 4) {
+		x &= 0x55555555;
+		x = (x | (x >> 1)) & 0x33333333;
+		x = (x | (x >> 2)) & 0x0f0f0f0f;
+		x = (x | (x >> 4)) & 0x00ff00ff;
+		return (x | (x >> 8)) & 0x0000ffff;
+	} else {
+		x &= 0x5555555555555555ull;
+		x = (x | (x >> 1)) & 0x3333333333333333ull;
+		x = (x | (x >> 2)) & 0x0f0f0f0f0f0f0f0full;
+		x = (x | (x >> 4)) & 0x00ff00ff00ff00ffull;
+		x = (x | (x >> 8)) & 0x0000ffff0000ffffull;
+		return (uint32_t)((x | (x >> 16)) & 0xffffffffull);
+	}
+#endif
+}
+template<typename C>
+C spread3(uint32_t x) {
+#if defined(MATHS_MORTON_BMI2)
+	if constexpr(sizeof(C) == 4) return _pdep_u32(x, 0x09249249u);
+	else return _pdep_u64(x, 0x1249249249249249ull);
+#else
+	if constexpr(sizeof(C) == 4) {
+		x &= 0x000003ff;
+		x = (x | (x << 16)) & 0x030000ff;
+		x = (x | (x << 8)) & 0x0300f00f;
+		x = (x | (x << 4)) & 0x030c30c3;
+		return (x | (x << 2)) & 0x09249249;
+	} else {
+		uint64_t v = x & 0x1fffff;
+		v = (v | (v << 32)) & 0x001f00000000ffffull;
+		v = (v | (v << 16)) & 0x001f0000ff0000ffull;
+		v = (v | (v << 8)) & 0x100f00f00f00f00full;
+		v = (v | (v << 4)) & 0x10c30c30c30c30c3ull;
+		return (v | (v << 2)) & 0x1249249249249249ull;
+	}
+#endif
+}
+template<typename C>
+uint32_t compact3(C x) {
+#if defined(MATHS_MORTON_BMI2)
+	if constexpr(sizeof(C) == 4) return _pext_u32(x, 0x09249249u);
+	else return (uint32_t)_pext_u64(x, 0x1249249249249249ull);
+#else
+	if constexpr(sizeof(C) == 4) {
+		x &= 0x09249249;
+		x = (x | (x >> 2)) & 0x030c30c3;
+		x = (x | (x >> 4)) & 0x0300f00f;
+		x = (x | (x >> 8)) & 0x030000ff;
+		return (x | (x >> 16)) & 0x000003ff;
+	} else {
+		x &= 0x1249249249249249ull;
+		x = (x | (x >> 2)) & 0x10c30c30c30c30c3ull;
+		x = (x | (x >> 4)) & 0x100f00f00f00f00full;
+		x = (x | (x >> 8)) & 0x001f0000ff0000ffull;
+		x = (x | (x >> 16)) & 0x001f00000000ffffull;
+		return (uint32_t)((x | (x >> 32)) & 0x1fffff);
+	}
+#endif
+}
+
+#undef MATHS_MORTON_BMI2
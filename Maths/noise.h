@@ -85,19 +85,12 @@ private:
             amplitude      *= persistence;
             totalAmplitude += amplitude;
 
-            for(int i = 0; i < width; i++) {
-                for(int j = 0; j < height; j++) {
-                    perlinNoise[i + j * width] += smoothNoise[octave][i + j * width] * amplitude;
-                }
-            }
+            kernels::table().madd(smoothNoise[octave], amplitude, perlinNoise, (std::size_t)width*height);
         }
 
         /// Normalisation
-        for(int i = 0; i < width; i++) {
-            for(int j = 0; j < height; j++) {
-                perlinNoise[i + j * width] /= totalAmplitude;
-            }
-        }
+        kernels::table().scale(perlinNoise, 1.0f / totalAmplitude, (std::size_t)width*height);
+
         for(auto i = 0; i < octaveCount; i++) {
             delete[] smoothNoise[i];
         }
@@ -0,0 +1,190 @@
+#pragma once
+///
+///	Packed and quantised vector formats for storage.
+///
+/// half, half2, half4  - IEEE 754 binary16
+/// snorm16x4           - 4 x int16 mapping [-1, 1]
+/// unorm8x4            - 4 x uint8 mapping [0, 1], eg. colours
+/// octNormal           - unit float3 octahedral encoded as 2 x snorm16 (4 bytes)
+/// rgb10a2             - 10 bits each of r, g, b and 2 bits of alpha in [0, 1]
+///
+/// half4 h{float4{1, 2, 3, 4}};
+/// float4 f = float4(h);
+///
+/// Conversion to a packed format rounds to nearest and clamps to the
+/// range of the format. pack() and unpack() convert whole spans with the
+/// runtime selected kernels and give the same results as the single
+/// value conversions.
+///
+#include <cstdint>
+#include <span>
+#include "kernels.h"
+#include "simd.h"
+
+namespace maths {
+
+struct half final {
+	uint16_t bits = 0;
+
+	half() = default;
+	explicit half(float f) : bits((uint16_t)_mm_cvtsi128_si32(simd::detail::toHalf(_mm_set_ss(f)))) {}
+
+	explicit operator float() const {
+		return _mm_cvtss_f32(simd::detail::fromHalf(_mm_cvtsi32_si128(bits)));
+	}
+	bool operator==(const half& o) const { return bits == o.bits; }
+	bool operator!=(const half& o) const { return bits != o.bits; }
+};
+struct half2 final {
+	half x, y;
+
+	half2() = default;
+	explicit half2(const float2& v) : x(v.x), y(v.y) {}
+
+	explicit operator float2() const { return {(float)x, (float)y}; }
+};
+struct half4 final {
+	half x, y, z, w;
+
+	half4() = default;
+	explicit half4(const float4& v) : x(v.x), y(v.y), z(v.z), w(v.w) {}
+
+	explicit operator float4() const { return {(float)x, (float)y, (float)z, (float)w}; }
+};
+
+namespace packing {
+inline int16_t snorm16(float f) {
+	return (int16_t)std::lrint(std::fmin(std::fmax(f, -1.0f), 1.0f) * 32767);
+}
+inline float snorm16(int16_t i) {
+	return std::fmax(i / 32767.0f, -1.0f);
+}
+inline uint8_t unorm8(float f) {
+	return (uint8_t)std::lrint(std::fmin(std::fmax(f, 0.0f), 1.0f) * 255);
+}
+inline float unorm8(uint8_t i) {
+	return i / 255.0f;
+}
+inline uint32_t unorm(float f, float scale) {
+	return (uint32_t)std::lrint(std::fmin(std::fmax(f, 0.0f), 1.0f) * scale);
+}
+}
+
+struct snorm16x4 final {
+	int16_t x = 0, y = 0, z = 0, w = 0;
+
+	snorm16x4() = default;
+	explicit snorm16x4(const float4& v) :
+		x(packing::snorm16(v.x)), y(packing::snorm16(v.y)), z(packing::snorm16(v.z)), w(packing::snorm16(v.w)) {}
+
+	explicit operator float4() const {
+		return {packing::snorm16(x), packing::snorm16(y), packing::snorm16(z), packing::snorm16(w)};
+	}
+};
+struct unorm8x4 final {
+	uint8_t x = 0, y = 0, z = 0, w = 0;
+
+	unorm8x4() = default;
+	explicit unorm8x4(const float4& v) :
+		x(packing::unorm8(v.x)), y(packing::unorm8(v.y)), z(packing::unorm8(v.z)), w(packing::unorm8(v.w)) {}
+
+	explicit operator float4() const {
+		return {packing::unorm8(x), packing::unorm8(y), packing::unorm8(z), packing::unorm8(w)};
+	}
+};
+/// A unit vector projected onto an octahedron and unfolded into a square.
+/// Max angular error is about 0.002 degrees. The input must not be zero
+struct octNormal final {
+	int16_t x = 0, y = 0;
+
+	octNormal() = default;
+	explicit octNormal(const float3& n) {
+		const float inv = 1 / (std::fabs(n.x) + std::fabs(n.y) + std::fabs(n.z));
+		float u = n.x * inv, v = n.y * inv;
+		if(n.z < 0) {
+			const float fu = std::copysign(1 - std::fabs(v), u);
+			v = std::copysign(1 - std::fabs(u), v);
+			u = fu;
+		}
+		x = packing::snorm16(u);
+		y = packing::snorm16(v);
+	}
+
+	explicit operator float3() const {
+		float u = packing::snorm16(x), v = packing::snorm16(y);
+		const float w = 1 - std::fabs(u) - std::fabs(v);
+		const float t = std::fmax(-w, 0.0f);
+		u -= std::copysign(t, u);
+		v -= std::copysign(t, v);
+		return float3{u, v, w}.normalised();
+	}
+};
+struct rgb10a2 final {
+	uint32_t bits = 0;
+
+	rgb10a2() = default;
+	explicit rgb10a2(const float4& c) :
+		bits(packing::unorm(c.x, 1023) | packing::unorm(c.y, 1023) << 10 | packing::unorm(c.z, 1023) << 20 | packing::unorm(c.w, 3) << 30) {}
+
+	explicit operator float4() const {
+		return {(bits & 0x3ff) / 1023.0f, ((bits >> 10) & 0x3ff) / 1023.0f, ((bits >> 20) & 0x3ff) / 1023.0f, (bits >> 30) / 3.0f};
+	}
+};
+
+static_assert(sizeof(half2) == 4 && sizeof(half4) == 8);
+static_assert(sizeof(snorm16x4) == 8 && sizeof(unorm8x4) == 4);
+static_assert(sizeof(octNormal) == 4 && sizeof(rgb10a2) == 4);
+
+/// out[i] = packed(in[i])
+inline void pack(std::span<const float2> in, std::span<half2> out) {
+	assert(in.size() == out.size());
+	kernels::table().toHalf((const float*)in.data(), (uint16_t*)out.data(), in.size() * 2);
+}
+inline void pack(std::span<const float4> in, std::span<half4> out) {
+	assert(in.size() == out.size());
+	kernels::table().toHalf((const float*)in.data(), (uint16_t*)out.data(), in.size() * 4);
+}
+inline void pack(std::span<const float4> in, std::span<snorm16x4> out) {
+	assert(in.size() == out.size());
+	kernels::table().toSnorm16((const float*)in.data(), (int16_t*)out.data(), in.size() * 4);
+}
+inline void pack(std::span<const float4> in, std::span<unorm8x4> out) {
+	assert(in.size() == out.size());
+	kernels::table().toUnorm8((const float*)in.data(), (uint8_t*)out.data(), in.size() * 4);
+}
+inline void pack(std::span<const float3> in, std::span<octNormal> out) {
+	assert(in.size() == out.size());
+	kernels::table().octEncode((const float*)in.data(), (int16_t*)out.data(), in.size());
+}
+inline void pack(std::span<const float4> in, std::span<rgb10a2> out) {
+	assert(in.size() == out.size());
+	kernels::table().toRgb10a2((const float*)in.data(), (uint32_t*)out.data(), in.size());
+}
+
+/// out[i] = float(in[i])
+inline void unpack(std::span<const half2> in, std::span<float2> out) {
+	assert(in.size() == out.size());
+	kernels::table().fromHalf((const uint16_t*)in.data(), (float*)out.data(), in.size() * 2);
+}
+inline void unpack(std::span<const half4> in, std::span<float4> out) {
+	assert(in.size() == out.size());
+	kernels::table().fromHalf((const uint16_t*)in.data(), (float*)out.data(), in.size() * 4);
+}
+inline void unpack(std::span<const snorm16x4> in, std::span<float4> out) {
+	assert(in.size() == out.size());
+	kernels::table().fromSnorm16((const int16_t*)in.data(), (float*)out.data(), in.size() * 4);
+}
+inline void unpack(std::span<const unorm8x4> in, std::span<float4> out) {
+	assert(in.size() == out.size());
+	kernels::table().fromUnorm8((const uint8_t*)in.data(), (float*)out.data(), in.size() * 4);
+}
+inline void unpack(std::span<const octNormal> in, std::span<float3> out) {
+	assert(in.size() == out.size());
+	kernels::table().octDecode((const int16_t*)in.data(), (float*)out.data(), in.size());
+}
+inline void unpack(std::span<const rgb10a2> in, std::span<float4> out) {
+	assert(in.size() == out.size());
+	kernels::table().fromRgb10a2((const uint32_t*)in.data(), (float*)out.data(), in.size());
+}
+
+}
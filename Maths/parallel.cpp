@@ -0,0 +1,138 @@
+#include "_pch.h"
+#include "maths.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <thread>
+
+namespace maths::parallel {
+
+namespace {
+
+/// Set while the current thread is running a chunk
+thread_local bool insideJob = false;
+
+class Pool final {
+public:
+	~Pool() {
+		stop();
+	}
+	unsigned threadCount() const {
+		return count;
+	}
+	void setThreadCount(unsigned n) {
+		assert(!insideJob);
+		if(n == 0) n = std::max(1u, std::thread::hardware_concurrency());
+		std::lock_guard<std::mutex> lock(runMutex);
+		if(n == count) return;
+		stop();
+		count = n;
+	}
+	void forEach(std::size_t chunks, const std::function<void(std::size_t)>& fn) {
+		std::unique_lock<std::mutex> run(runMutex, std::try_to_lock);
+		if(chunks < 2 || insideJob || !run.owns_lock() || count < 2) {
+			if(run.owns_lock()) run.unlock();
+			for(std::size_t i = 0; i < chunks; i++) fn(i);
+			return;
+		}
+		if(threads.empty()) start();
+
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			job = &fn;
+			jobChunks = chunks;
+			next = 0;
+			error = nullptr;
+			busy = threads.size();
+			generation++;
+		}
+		wake.notify_all();
+		work();
+
+		std::unique_lock<std::mutex> lock(mutex);
+		done.wait(lock, [this]() { return busy == 0; });
+		job = nullptr;
+		if(error) std::rethrow_exception(error);
+	}
+private:
+	std::mutex runMutex;		/// One job at a time. Guards changes to count and threads
+	std::atomic<unsigned> count{std::max(1u, std::thread::hardware_concurrency())};
+	std::vector<std::thread> threads;
+
+	std::mutex mutex;
+	std::condition_variable wake, done;
+	const std::function<void(std::size_t)>* job = nullptr;
+	std::size_t jobChunks = 0;
+	std::atomic<std::size_t> next{0};
+	std::exception_ptr error;
+	std::size_t busy = 0;
+	uint64_t generation = 0;
+	bool stopping = false;
+
+	/// Workers start at the current generation so that a pool restarted by
+	/// setThreadCount() does not rerun the previous job
+	void start() {
+		stopping = false;
+		for(unsigned i = 1; i < count; i++) {
+			threads.emplace_back([this, g = generation]() { loop(g); });
+		}
+	}
+	void stop() {
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			stopping = true;
+		}
+		wake.notify_all();
+		for(auto& t : threads) t.join();
+		threads.clear();
+	}
+	void loop(uint64_t seen) {
+		std::unique_lock<std::mutex> lock(mutex);
+		for(;;) {
+			wake.wait(lock, [&]() { return stopping || generation != seen; });
+			if(stopping) return;
+			seen = generation;
+			lock.unlock();
+			work();
+			lock.lock();
+			if(--busy == 0) done.notify_one();
+		}
+	}
+	/// Run chunks until there are none left
+	void work() {
+		insideJob = true;
+		for(;;) {
+			const std::size_t i = next.fetch_add(1, std::memory_order_relaxed);
+			if(i >= jobChunks) break;
+			try {
+				(*job)(i);
+			} catch(...) {
+				std::lock_guard<std::mutex> lock(mutex);
+				if(!error) error = std::current_exception();
+				next = jobChunks;
+			}
+		}
+		insideJob = false;
+	}
+};
+
+Pool& pool() {
+	static Pool p;
+	return p;
+}
+
+}
+
+unsigned threadCount() {
+	return pool().threadCount();
+}
+void setThreadCount(unsigned count) {
+	pool().setThreadCount(count);
+}
+void forEach(std::size_t chunks, const std::function<void(std::size_t)>& fn) {
+	pool().forEach(chunks, fn);
+}
+
+}
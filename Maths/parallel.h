@@ -0,0 +1,30 @@
+#pragma once
+///
+///	A small persistent thread pool for the batch functions.
+///
+/// parallel::forEach(chunks, [&](std::size_t chunk) { ... });
+///
+/// fn is called once for every chunk in [0, chunks), spread across the
+/// pool threads and the calling thread, and forEach returns when all of
+/// them have finished. Chunks are handed out in order but may complete in
+/// any order, so callers that need deterministic results should write a
+/// partial result per chunk and combine them afterwards.
+///
+/// The pool is started on first use. Calls made from inside a chunk, or
+/// while another thread is already running a job, run serially on the
+/// calling thread. If fn throws, the first exception is rethrown by
+/// forEach after the remaining chunks have been skipped.
+///
+#include <cstddef>
+#include <functional>
+
+namespace maths::parallel {
+
+/// Number of threads used by forEach, including the calling thread
+unsigned threadCount();
+/// 0 = one per hardware thread. 1 runs everything on the calling thread
+void setThreadCount(unsigned count);
+
+void forEach(std::size_t chunks, const std::function<void(std::size_t)>& fn);
+
+}
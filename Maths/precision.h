@@ -0,0 +1,62 @@
+#pragma once
+///
+///	Compile-time selection of precise or approximate maths.
+///
+/// float3 n = v.normalised<Precision::Fast>();
+///
+/// Precise is the default everywhere and uses the standard library.
+/// Fast uses the approximations in the fast namespace below for float.
+/// Other types always use the precise functions.
+///
+#include <cmath>
+#include <limits>
+#include <emmintrin.h>
+
+namespace maths {
+
+enum class Precision { Precise, Fast };
+
+namespace fast {
+
+/// 1/sqrt(x). rsqrtps plus one Newton-Raphson step. ~22 bits
+inline __m128 rsqrt(__m128 x) {
+	const __m128 r = _mm_rsqrt_ps(x);
+	const __m128 xrr = _mm_mul_ps(_mm_mul_ps(x, r), r);
+	return _mm_mul_ps(_mm_mul_ps(_mm_set1_ps(0.5f), r), _mm_sub_ps(_mm_set1_ps(3.0f), xrr));
+}
+/// 1/x. rcpps plus one Newton-Raphson step. ~22 bits
+inline __m128 rcp(__m128 x) {
+	const __m128 r = _mm_rcp_ps(x);
+	return _mm_mul_ps(r, _mm_sub_ps(_mm_set1_ps(2.0f), _mm_mul_ps(x, r)));
+}
+
+inline float rsqrt(float x) {
+	return _mm_cvtss_f32(rsqrt(_mm_set_ss(x)));
+}
+inline float rcp(float x) {
+	return _mm_cvtss_f32(rcp(_mm_set_ss(x)));
+}
+/// x*rsqrt(x) for normal finite x. rsqrt is 0 or inf for 0, inf and denormals
+/// so those (and negatives and NaN) use std::sqrt
+inline float sqrt(float x) {
+	if(x >= std::numeric_limits<float>::min() && x < std::numeric_limits<float>::infinity()) {
+		return x * rsqrt(x);
+	}
+	return std::sqrt(x);
+}
+/// Abramowitz and Stegun 4.4.45. Max error 6.8e-5 radians.
+/// Input is clamped to [-1, 1]
+inline float acos(float x) {
+	const float a = std::fmin(std::fabs(x), 1.0f);
+	const float r = std::sqrt(1 - a) * (1.5707288f + a * (-0.2121144f + a * (0.0742610f - 0.0187293f * a)));
+	return x < 0 ? PI - r : r;
+}
+
+/// Other types use the precise functions
+template<typename T> T rsqrt(T x) { return (T)(1 / std::sqrt(x)); }
+template<typename T> T rcp(T x) { return 1 / x; }
+template<typename T> T sqrt(T x) { return (T)std::sqrt(x); }
+template<typename T> T acos(T x) { return (T)std::acos(x); }
+
+}
+}
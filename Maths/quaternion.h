@@ -0,0 +1,262 @@
+#pragma once
+///
+///	Rotation quaternions and dual quaternions.
+///
+/// quaternion<T> stores x, y, z (the vector part) and w. The rotation by
+/// radians around a unit axis is {axis * sin(radians/2), cos(radians/2)}
+/// and rotates in the same direction as matrix4::rotateX/Y/Z.
+///
+/// q1 * q2 applies q2 then q1, matching matrix multiplication, and
+/// toMatrix() * v == rotate(v).
+///
+/// dualquaternion<T> holds a rotation (real) and a translation (dual) for
+/// rigid transforms and skinning. It is 8 T in the order real.xyzw dual.xyzw
+/// which is the layout the batch skinning functions in animation.h read.
+///
+/// slerp() and nlerp() take the shortest path and return a unit quaternion.
+///
+#include <span>
+
+namespace maths {
+
+template<typename T>
+struct quaternion final {
+    static_assert(std::is_floating_point<T>::value);
+
+    T x = 0, y = 0, z = 0, w = 1;
+
+    constexpr static quaternion identity() {
+        return {0, 0, 0, 1};
+    }
+    /// axis must be unit length
+    constexpr static quaternion fromAxisAngle(const vector3<T>& axis, T radians) {
+        T s, c;
+        trig::sincos(radians * T(0.5), s, c);
+        return {axis.x * s, axis.y * s, axis.z * s, c};
+    }
+    constexpr static quaternion rotateX(T radians) {
+        return fromAxisAngle({1, 0, 0}, radians);
+    }
+    constexpr static quaternion rotateY(T radians) {
+        return fromAxisAngle({0, 1, 0}, radians);
+    }
+    constexpr static quaternion rotateZ(T radians) {
+        return fromAxisAngle({0, 0, 1}, radians);
+    }
+    constexpr static quaternion fromVector(const vector4<T>& v) {
+        return {v.x, v.y, v.z, v.w};
+    }
+    /// The rotation part of m, which must be orthonormal
+    constexpr static quaternion fromMatrix(const matrix4<T>& m) {
+        /// Largest of w, x, y and z first for accuracy
+        const T m00 = m[0].x, m11 = m[1].y, m22 = m[2].z;
+        const T trace = m00 + m11 + m22;
+        if(trace > 0) {
+            const T s = T(0.5) / sqrt(trace + 1);
+            return {(m[1].z - m[2].y) * s, (m[2].x - m[0].z) * s, (m[0].y - m[1].x) * s, T(0.25) / s};
+        }
+        if(m00 > m11 && m00 > m22) {
+            const T s = 2 * sqrt(1 + m00 - m11 - m22);
+            return {T(0.25) * s, (m[1].x + m[0].y) / s, (m[2].x + m[0].z) / s, (m[1].z - m[2].y) / s};
+        }
+        if(m11 > m22) {
+            const T s = 2 * sqrt(1 + m11 - m00 - m22);
+            return {(m[1].x + m[0].y) / s, T(0.25) * s, (m[2].y + m[1].z) / s, (m[2].x - m[0].z) / s};
+        }
+        const T s = 2 * sqrt(1 + m22 - m00 - m11);
+        return {(m[2].x + m[0].z) / s, (m[2].y + m[1].z) / s, T(0.25) * s, (m[0].y - m[1].x) / s};
+    }
+    constexpr matrix4<T> toMatrix() const {
+        const T xx = x * x, yy = y * y, zz = z * z;
+        const T xy = x * y, xz = x * z, yz = y * z;
+        const T wx = w * x, wy = w * y, wz = w * z;
+        return matrix4<T>::columnMajor({
+            1 - 2 * (yy + zz), 2 * (xy + wz), 2 * (xz - wy), 0,
+            2 * (xy - wz), 1 - 2 * (xx + zz), 2 * (yz + wx), 0,
+            2 * (xz + wy), 2 * (yz - wx), 1 - 2 * (xx + yy), 0,
+            0, 0, 0, 1
+        });
+    }
+
+    constexpr vector3<T> xyz() const { return {x, y, z}; }
+    constexpr vector4<T> xyzw() const { return {x, y, z, w}; }
+
+    constexpr bool operator==(const quaternion& o) const {
+        return x == o.x && y == o.y && z == o.z && w == o.w;
+    }
+    constexpr bool operator!=(const quaternion& o) const {
+        return !operator==(o);
+    }
+    constexpr bool approx(const quaternion& o) const {
+        return xyzw().approx(o.xyzw());
+    }
+
+    constexpr quaternion operator-() const {
+        return {-x, -y, -z, -w};
+    }
+    constexpr quaternion operator+(const quaternion& o) const {
+        return {x + o.x, y + o.y, z + o.z, w + o.w};
+    }
+    constexpr quaternion operator-(const quaternion& o) const {
+        return {x - o.x, y - o.y, z - o.z, w - o.w};
+    }
+    constexpr quaternion operator*(T s) const {
+        return {x * s, y * s, z * s, w * s};
+    }
+    /// this * o, ie. rotate by o then this
+    constexpr quaternion operator*(const quaternion& o) const {
+        return {
+            w * o.x + x * o.w + y * o.z - z * o.y,
+            w * o.y - x * o.z + y * o.w + z * o.x,
+            w * o.z + x * o.y - y * o.x + z * o.w,
+            w * o.w - x * o.x - y * o.y - z * o.z
+        };
+    }
+
+    constexpr T dot(const quaternion& o) const {
+        return x * o.x + y * o.y + z * o.z + w * o.w;
+    }
+    constexpr T length() const {
+        return sqrt(dot(*this));
+    }
+    constexpr quaternion normalised() const {
+        return operator*(1 / length());
+    }
+    constexpr quaternion conjugate() const {
+        return {-x, -y, -z, w};
+    }
+    /// The conjugate divided by the squared length. Unit quaternions can use conjugate()
+    constexpr quaternion inversed() const {
+        return conjugate() * (1 / dot(*this));
+    }
+
+    /// v rotated by this unit quaternion
+    constexpr vector3<T> rotate(const vector3<T>& v) const {
+        const vector3<T> u = xyz();
+        const vector3<T> t = u.cross(v) * 2;
+        return v + t * w + u.cross(t);
+    }
+
+    /// Normalised linear interpolation
+    constexpr quaternion nlerp(const quaternion& o, T t) const {
+        const quaternion b = dot(o) < 0 ? -o : o;
+        return (*this + (b - *this) * t).normalised();
+    }
+    /// Spherical linear interpolation. Falls back to nlerp when the
+    /// quaternions are almost parallel
+    quaternion slerp(const quaternion& o, T t) const {
+        T d = dot(o);
+        const quaternion b = d < 0 ? -o : o;
+        d = std::abs(d);
+        T wa = 1 - t, wb = t;
+        if(d < T(0.9995)) {
+            const T theta = trig::acos(d);
+            const T invSin = 1 / std::sqrt(1 - d * d);
+            wa = trig::sin(wa * theta) * invSin;
+            wb = trig::sin(wb * theta) * invSin;
+        }
+        return (*this * wa + b * wb).normalised();
+    }
+
+    std::string toString() const {
+        char buf[96];
+        sprintf_s(buf, "[%.3f, %.3f, %.3f, %.3f]", x, y, z, w);
+        return std::string(buf);
+    }
+};
+
+template<typename T>
+struct dualquaternion final {
+    static_assert(std::is_floating_point<T>::value);
+
+    quaternion<T> real;
+    quaternion<T> dual{0, 0, 0, 0};
+
+    constexpr static dualquaternion identity() {
+        return {};
+    }
+    /// Rotate by r then translate by t
+    constexpr static dualquaternion fromRotationTranslation(const quaternion<T>& r, const vector3<T>& t) {
+        return {r, quaternion<T>{t.x, t.y, t.z, 0} * r * T(0.5)};
+    }
+    constexpr static dualquaternion translate(const vector3<T>& t) {
+        return fromRotationTranslation(quaternion<T>::identity(), t);
+    }
+    /// m must be a rotation plus translation with no scale
+    constexpr static dualquaternion fromMatrix(const matrix4<T>& m) {
+        return fromRotationTranslation(quaternion<T>::fromMatrix(m), {m[3].x, m[3].y, m[3].z});
+    }
+    constexpr matrix4<T> toMatrix() const {
+        auto m = real.toMatrix();
+        const vector3<T> t = translation();
+        m[3] = {t.x, t.y, t.z, 1};
+        return m;
+    }
+
+    constexpr vector3<T> translation() const {
+        return (real.xyz().cross(dual.xyz()) + dual.xyz() * real.w - real.xyz() * dual.w) * 2;
+    }
+
+    constexpr bool operator==(const dualquaternion& o) const {
+        return real == o.real && dual == o.dual;
+    }
+    constexpr bool operator!=(const dualquaternion& o) const {
+        return !operator==(o);
+    }
+    constexpr bool approx(const dualquaternion& o) const {
+        return real.approx(o.real) && dual.approx(o.dual);
+    }
+
+    constexpr dualquaternion operator+(const dualquaternion& o) const {
+        return {real + o.real, dual + o.dual};
+    }
+    constexpr dualquaternion operator*(T s) const {
+        return {real * s, dual * s};
+    }
+    /// this * o, ie. apply o then this
+    constexpr dualquaternion operator*(const dualquaternion& o) const {
+        return {real * o.real, real * o.dual + dual * o.real};
+    }
+
+    /// Divides by the length of the real part
+    constexpr dualquaternion normalised() const {
+        return operator*(1 / real.length());
+    }
+    /// Inverse of a unit dual quaternion
+    constexpr dualquaternion inversed() const {
+        return {real.conjugate(), dual.conjugate()};
+    }
+
+    constexpr vector3<T> transformPoint(const vector3<T>& p) const {
+        return real.rotate(p) + translation();
+    }
+    /// Ignores the translation
+    constexpr vector3<T> transformDirection(const vector3<T>& d) const {
+        return real.rotate(d);
+    }
+
+    /// Dual quaternion linear blending. Each weight is negated if its
+    /// rotation is in the opposite hemisphere to dqs[0]. The result is normalised
+    constexpr static dualquaternion blend(std::span<const dualquaternion> dqs, std::span<const T> weights) {
+        assert(!dqs.empty() && dqs.size() == weights.size());
+        dualquaternion r{quaternion<T>{0, 0, 0, 0}, quaternion<T>{0, 0, 0, 0}};
+        for(std::size_t i = 0; i < dqs.size(); i++) {
+            const T w = dqs[i].real.dot(dqs[0].real) < 0 ? -weights[i] : weights[i];
+            r = r + dqs[i] * w;
+        }
+        return r.normalised();
+    }
+
+    std::string toString() const {
+        return real.toString() + " " + dual.toString();
+    }
+};
+
+static_assert(sizeof(dualquaternion<float>) == 8 * sizeof(float));
+
+typedef quaternion<float> quat;
+typedef quaternion<double> dquat;
+typedef dualquaternion<float> dualquat;
+typedef dualquaternion<double> ddualquat;
+
+}
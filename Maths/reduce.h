@@ -0,0 +1,176 @@
+#pragma once
+///
+///	Reductions over spans of float3 and float4 points.
+///
+/// aabb3 box = boundsOf(points);
+/// float3 centre = meanOf(points);
+/// std::size_t furthest = argMax(points, direction);
+///
+/// The input is split into fixed chunks of 65536 points which are reduced
+/// in parallel (see parallel.h) with the runtime selected kernels. The
+/// partial results are combined in chunk order so the result does not
+/// depend on the number of threads.
+///
+/// Sums use Kahan summation within each SIMD lane and are combined in
+/// double. argMin and argMax are scalar within a chunk and return the
+/// lowest index on ties, or size() if the span is empty. NaNs are not
+/// supported.
+///
+#include <cstddef>
+#include <limits>
+#include <span>
+#include <vector>
+#include "kernels.h"
+#include "parallel.h"
+
+namespace maths {
+
+/// Axis aligned bounding box. The default box is empty (min > max)
+/// and merging a point or box into it gives that point or box
+template<typename V>
+struct aabb final {
+	V min = broadcast(std::numeric_limits<float>::infinity());
+	V max = broadcast(-std::numeric_limits<float>::infinity());
+
+	aabb() = default;
+	constexpr aabb(const V& min, const V& max) : min(min), max(max) {}
+
+	bool empty() const { return min.anyGT(max); }
+	V centre() const { return (min + max) * 0.5f; }
+	V size() const { return max - min; }
+	bool contains(const V& p) const { return p.allGTE(min) && p.allLTE(max); }
+
+	aabb merged(const V& p) const { return {min.min(p), max.max(p)}; }
+	aabb merged(const aabb& o) const { return {min.min(o.min), max.max(o.max)}; }
+
+	bool operator==(const aabb& o) const { return min == o.min && max == o.max; }
+private:
+	static V broadcast(float f) {
+		V v;
+		for(unsigned i = 0; i < sizeof(V) / sizeof(float); i++) v[i] = f;
+		return v;
+	}
+};
+typedef aabb<float3> aabb3;
+typedef aabb<float4> aabb4;
+
+namespace detail {
+
+constexpr std::size_t REDUCE_CHUNK = 1 << 16;
+
+inline std::size_t reduceChunks(std::size_t n) {
+	return (n + REDUCE_CHUNK - 1) / REDUCE_CHUNK;
+}
+template<typename V>
+aabb<V> boundsOf(std::span<const V> points) {
+	constexpr int S = sizeof(V) / sizeof(float);
+	const std::size_t n = points.size();
+	std::vector<aabb<V>> partial(reduceChunks(n));
+	parallel::forEach(partial.size(), [&](std::size_t c) {
+		const std::size_t begin = c * REDUCE_CHUNK;
+		kernels::table().bounds((const float*)(points.data() + begin), std::min(REDUCE_CHUNK, n - begin), S,
+			(float*)&partial[c].min, (float*)&partial[c].max);
+	});
+	aabb<V> r;
+	for(auto& p : partial) r = r.merged(p);
+	return r;
+}
+template<int S, typename V>
+void sumOf(std::span<const V> points, double* out) {
+	const std::size_t n = points.size();
+	std::vector<double> partial(reduceChunks(n) * S);
+	parallel::forEach(partial.size() / S, [&](std::size_t c) {
+		const std::size_t begin = c * REDUCE_CHUNK;
+		kernels::table().sum((const float*)(points.data() + begin), std::min(REDUCE_CHUNK, n - begin), S, &partial[c * S]);
+	});
+	for(int i = 0; i < S; i++) out[i] = 0;
+	for(std::size_t i = 0; i < partial.size(); i++) out[i % S] += partial[i];
+}
+/// Index of the first element whose key is better than all others
+template<typename Key, typename Better>
+std::size_t argBest(std::size_t n, Key key, Better better) {
+	if(n == 0) return 0;
+	std::vector<std::size_t> best(reduceChunks(n));
+	parallel::forEach(best.size(), [&](std::size_t c) {
+		const std::size_t begin = c * REDUCE_CHUNK, end = std::min(n, begin + REDUCE_CHUNK);
+		std::size_t b = begin;
+		float bk = key(begin);
+		for(std::size_t i = begin + 1; i < end; i++) {
+			const float k = key(i);
+			if(better(k, bk)) {
+				b = i;
+				bk = k;
+			}
+		}
+		best[c] = b;
+	});
+	std::size_t b = best[0];
+	for(auto i : best) {
+		if(better(key(i), key(b))) b = i;
+	}
+	return b;
+}
+
+}
+
+inline aabb3 boundsOf(std::span<const float3> points) {
+	return detail::boundsOf(points);
+}
+inline aabb4 boundsOf(std::span<const float4> points) {
+	return detail::boundsOf(points);
+}
+
+/// Component-wise smallest and largest values
+inline float3 minOf(std::span<const float3> points) { return boundsOf(points).min; }
+inline float4 minOf(std::span<const float4> points) { return boundsOf(points).min; }
+inline float3 maxOf(std::span<const float3> points) { return boundsOf(points).max; }
+inline float4 maxOf(std::span<const float4> points) { return boundsOf(points).max; }
+
+inline float3 sumOf(std::span<const float3> points) {
+	double s[3];
+	detail::sumOf<3>(points, s);
+	return {(float)s[0], (float)s[1], (float)s[2]};
+}
+inline float4 sumOf(std::span<const float4> points) {
+	double s[4];
+	detail::sumOf<4>(points, s);
+	return {(float)s[0], (float)s[1], (float)s[2], (float)s[3]};
+}
+/// The centroid. Zero if points is empty
+inline float3 meanOf(std::span<const float3> points) {
+	if(points.empty()) return {};
+	double s[3];
+	detail::sumOf<3>(points, s);
+	const double n = (double)points.size();
+	return {(float)(s[0] / n), (float)(s[1] / n), (float)(s[2] / n)};
+}
+inline float4 meanOf(std::span<const float4> points) {
+	if(points.empty()) return {};
+	double s[4];
+	detail::sumOf<4>(points, s);
+	const double n = (double)points.size();
+	return {(float)(s[0] / n), (float)(s[1] / n), (float)(s[2] / n), (float)(s[3] / n)};
+}
+
+/// Index of the smallest or largest value
+inline std::size_t argMin(std::span<const float> values) {
+	return detail::argBest(values.size(), [&](std::size_t i) { return values[i]; }, std::less<float>());
+}
+inline std::size_t argMax(std::span<const float> values) {
+	return detail::argBest(values.size(), [&](std::size_t i) { return values[i]; }, std::greater<float>());
+}
+/// Index of the point furthest along -direction or direction (the support point)
+inline std::size_t argMin(std::span<const float3> points, const float3& direction) {
+	return detail::argBest(points.size(), [&](std::size_t i) { return points[i].dot(direction); }, std::less<float>());
+}
+inline std::size_t argMax(std::span<const float3> points, const float3& direction) {
+	return detail::argBest(points.size(), [&](std::size_t i) { return points[i].dot(direction); }, std::greater<float>());
+}
+inline std::size_t argMin(std::span<const float4> points, const float4& direction) {
+	return detail::argBest(points.size(), [&](std::size_t i) { return points[i].dot(direction); }, std::less<float>());
+}
+inline std::size_t argMax(std::span<const float4> points, const float4& direction) {
+	return detail::argBest(points.size(), [&](std::size_t i) { return points[i].dot(direction); }, std::greater<float>());
+}
+
+}
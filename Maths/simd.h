@@ -0,0 +1,487 @@
+#pragma once
+///
+///	Thin wrappers around SIMD registers so that batch kernels can be
+/// written once and instantiated for each register width.
+///
+/// Comparisons return a mask type (V::mask) that can be combined with
+/// & | ~, turned into a lane bitmask with bits() or used with select().
+///
+/// loadI16/U8/Half and storeI16/U8/I32/Half convert width values to and
+/// from the packed storage formats. Stores round to nearest and saturate.
+///
+/// transpose(), deinterleave() and interleave() shuffle 4x4 blocks and
+/// 4 interleaved points of 2, 3 or 4 floats in SSE registers.
+///
+/// f32x1  - 1 float. Arithmetic only, for finishing loop tails with the same code
+/// f32x4  - 4 floats (SSE2)
+/// f32x8  - 8 floats (AVX2 + FMA + F16C). Only available when compiled with /arch:AVX2
+/// f32x16 - 16 floats (AVX-512). Only available when compiled with /arch:AVX512
+/// f64x4  - 4 doubles. One __m256d when compiled with /arch:AVX2, otherwise two __m128d
+///
+/// Everything is declared in an inline namespace named after the instruction
+/// set the translation unit is compiled for. Each kernels_<isa>.cpp object
+/// then has its own copy of any function that is not inlined, rather than
+/// the linker keeping one copy (which may be VEX encoded) for all of them.
+///
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <emmintrin.h>
+#if defined(__AVX2__) || defined(__AVX512F__)
+#include <immintrin.h>
+#endif
+
+#if defined(__AVX512F__)
+#define MATHS_ISA avx512
+#elif defined(__AVX2__)
+#define MATHS_ISA avx2
+#elif defined(__AVX__)
+#define MATHS_ISA avx
+#else
+#define MATHS_ISA sse2
+#endif
+
+namespace maths::simd {
+inline namespace MATHS_ISA {
+
+namespace detail {
+
+/// float to IEEE half with round to nearest even, in the low 16 bits of
+/// each 32 bit lane (sign extended). F. Giesen's SSE2 method
+inline __m128i toHalf(__m128 f) {
+	const __m128 justSign = _mm_and_ps(_mm_set1_ps(-0.0f), f);
+	const __m128 absf = _mm_xor_ps(f, justSign);
+	const __m128i absi = _mm_castps_si128(absf);
+
+	const __m128i isNan = _mm_castps_si128(_mm_cmpunord_ps(absf, absf));
+	const __m128i isRegular = _mm_cmpgt_epi32(_mm_set1_epi32((127 + 16) << 23), absi);
+	const __m128i infOrNan = _mm_or_si128(_mm_and_si128(isNan, _mm_set1_epi32(0x200)), _mm_set1_epi32(0x7c00));
+
+	/// Subnormal results. Adding the magic value rounds the mantissa
+	const __m128i isSub = _mm_cmpgt_epi32(_mm_set1_epi32((127 - 14) << 23), absi);
+	const __m128i magic = _mm_set1_epi32(((127 - 15) + (23 - 10) + 1) << 23);
+	const __m128i sub = _mm_sub_epi32(_mm_castps_si128(_mm_add_ps(absf, _mm_castsi128_ps(magic))), magic);
+
+	/// Normal results. Rebias the exponent and round half to even
+	const __m128i mantOdd = _mm_srai_epi32(_mm_slli_epi32(absi, 31 - 13), 31);
+	const __m128i rounded = _mm_sub_epi32(_mm_add_epi32(absi, _mm_set1_epi32(0xfff - ((127 - 15) << 23))), mantOdd);
+	const __m128i normal = _mm_srli_epi32(rounded, 13);
+
+	const __m128i finite = _mm_or_si128(_mm_and_si128(isSub, sub), _mm_andnot_si128(isSub, normal));
+	const __m128i joined = _mm_or_si128(_mm_and_si128(isRegular, finite), _mm_andnot_si128(isRegular, infOrNan));
+	return _mm_or_si128(joined, _mm_srai_epi32(_mm_castps_si128(justSign), 16));
+}
+/// IEEE half in the low 16 bits of each 32 bit lane to float
+inline __m128 fromHalf(__m128i h) {
+	const __m128i expMant = _mm_and_si128(_mm_set1_epi32(0x7fff), h);
+	const __m128i justSign = _mm_xor_si128(h, expMant);
+	/// Multiplying rebiases the exponent and normalises subnormals
+	const __m128 scaled = _mm_mul_ps(_mm_castsi128_ps(_mm_slli_epi32(expMant, 13)), _mm_castsi128_ps(_mm_set1_epi32((254 - 15) << 23)));
+	const __m128i wasInfNan = _mm_cmpgt_epi32(expMant, _mm_set1_epi32(0x7bff));
+	const __m128 infNanExp = _mm_and_ps(_mm_castsi128_ps(wasInfNan), _mm_castsi128_ps(_mm_set1_epi32(255 << 23)));
+	return _mm_or_ps(scaled, _mm_or_ps(_mm_castsi128_ps(_mm_slli_epi32(justSign, 16)), infNanExp));
+}
+
+}
+
+struct f32x1 final {
+	static constexpr int width = 1;
+	float v;
+
+	f32x1() = default;
+	f32x1(float v) : v(v) {}
+
+	static f32x1 load(const float* p) { return *p; }
+	static f32x1 set1(float f) { return f; }
+	static f32x1 zero() { return 0.0f; }
+
+	void store(float* p) const { *p = v; }
+};
+
+inline f32x1 operator+(f32x1 a, f32x1 b) { return a.v + b.v; }
+inline f32x1 operator-(f32x1 a, f32x1 b) { return a.v - b.v; }
+inline f32x1 operator*(f32x1 a, f32x1 b) { return a.v * b.v; }
+inline f32x1 operator/(f32x1 a, f32x1 b) { return a.v / b.v; }
+inline f32x1 operator-(f32x1 a) { return -a.v; }
+
+inline f32x1 sqrt(f32x1 a) { return _mm_cvtss_f32(_mm_sqrt_ss(_mm_set_ss(a.v))); }
+/// Same operand order as minps/maxps so NaNs behave the same
+inline f32x1 min(f32x1 a, f32x1 b) { return a.v < b.v ? a.v : b.v; }
+inline f32x1 max(f32x1 a, f32x1 b) { return a.v > b.v ? a.v : b.v; }
+/// a*b + c
+inline f32x1 fmadd(f32x1 a, f32x1 b, f32x1 c) { return a.v * b.v + c.v; }
+inline f32x1 abs(f32x1 a) { return _mm_cvtss_f32(_mm_andnot_ps(_mm_set1_ps(-0.0f), _mm_set_ss(a.v))); }
+
+struct m32x4 final {
+	__m128 m;
+
+	/// Lane i is set if bit i of b is set. The inverse of bits()
+	static m32x4 fromBits(int b) {
+		const __m128i bit = _mm_setr_epi32(1, 2, 4, 8);
+		return {_mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(_mm_set1_epi32(b), bit), bit))};
+	}
+};
+inline m32x4 operator&(m32x4 a, m32x4 b) { return {_mm_and_ps(a.m, b.m)}; }
+inline m32x4 operator|(m32x4 a, m32x4 b) { return {_mm_or_ps(a.m, b.m)}; }
+inline m32x4 operator~(m32x4 a) { return {_mm_xor_ps(a.m, _mm_castsi128_ps(_mm_set1_epi32(-1)))}; }
+/// One bit per lane
+inline int bits(m32x4 a) { return _mm_movemask_ps(a.m); }
+
+struct f32x4 final {
+	using mask = m32x4;
+	static constexpr int width = 4;
+	__m128 v;
+
+	f32x4() = default;
+	f32x4(__m128 v) : v(v) {}
+
+	static f32x4 load(const float* p) { return _mm_loadu_ps(p); }
+	static f32x4 set1(float f) { return _mm_set1_ps(f); }
+	static f32x4 zero() { return _mm_setzero_ps(); }
+
+	void store(float* p) const { _mm_storeu_ps(p, v); }
+
+	static f32x4 loadI16(const int16_t* p) {
+		const __m128i i = _mm_loadl_epi64((const __m128i*)p);
+		return _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(i, i), 16));
+	}
+	static f32x4 loadU8(const uint8_t* p) {
+		int32_t bytes;
+		std::memcpy(&bytes, p, 4);
+		const __m128i z = _mm_setzero_si128();
+		return _mm_cvtepi32_ps(_mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(bytes), z), z));
+	}
+	static f32x4 loadHalf(const uint16_t* p) {
+		return detail::fromHalf(_mm_unpacklo_epi16(_mm_loadl_epi64((const __m128i*)p), _mm_setzero_si128()));
+	}
+	/// 4 doubles rounded to float
+	static f32x4 loadF64(const double* p) {
+		return _mm_movelh_ps(_mm_cvtpd_ps(_mm_loadu_pd(p)), _mm_cvtpd_ps(_mm_loadu_pd(p + 2)));
+	}
+	void storeI16(int16_t* p) const {
+		const __m128i i = _mm_cvtps_epi32(v);
+		_mm_storel_epi64((__m128i*)p, _mm_packs_epi32(i, i));
+	}
+	void storeU8(uint8_t* p) const {
+		const __m128i i = _mm_packs_epi32(_mm_cvtps_epi32(v), _mm_setzero_si128());
+		const int32_t bytes = _mm_cvtsi128_si32(_mm_packus_epi16(i, i));
+		std::memcpy(p, &bytes, 4);
+	}
+	void storeI32(int32_t* p) const { _mm_storeu_si128((__m128i*)p, _mm_cvtps_epi32(v)); }
+	void storeHalf(uint16_t* p) const {
+		const __m128i h = detail::toHalf(v);
+		_mm_storel_epi64((__m128i*)p, _mm_packs_epi32(h, h));
+	}
+};
+
+inline f32x4 operator+(f32x4 a, f32x4 b) { return _mm_add_ps(a.v, b.v); }
+inline f32x4 operator-(f32x4 a, f32x4 b) { return _mm_sub_ps(a.v, b.v); }
+inline f32x4 operator*(f32x4 a, f32x4 b) { return _mm_mul_ps(a.v, b.v); }
+inline f32x4 operator/(f32x4 a, f32x4 b) { return _mm_div_ps(a.v, b.v); }
+
+inline f32x4 sqrt(f32x4 a) { return _mm_sqrt_ps(a.v); }
+inline f32x4 min(f32x4 a, f32x4 b) { return _mm_min_ps(a.v, b.v); }
+inline f32x4 max(f32x4 a, f32x4 b) { return _mm_max_ps(a.v, b.v); }
+/// a*b + c
+inline f32x4 fmadd(f32x4 a, f32x4 b, f32x4 c) { return _mm_add_ps(_mm_mul_ps(a.v, b.v), c.v); }
+
+inline f32x4 operator-(f32x4 a) { return _mm_xor_ps(a.v, _mm_set1_ps(-0.0f)); }
+inline f32x4 operator&(f32x4 a, f32x4 b) { return _mm_and_ps(a.v, b.v); }
+inline f32x4 operator|(f32x4 a, f32x4 b) { return _mm_or_ps(a.v, b.v); }
+inline f32x4 operator^(f32x4 a, f32x4 b) { return _mm_xor_ps(a.v, b.v); }
+inline f32x4 abs(f32x4 a) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), a.v); }
+/// The sign bit of a
+inline f32x4 sign(f32x4 a) { return _mm_and_ps(_mm_set1_ps(-0.0f), a.v); }
+/// Round to nearest even. |a| >= 2^23 is already whole (or inf/NaN) and is
+/// returned as is, as cvtps_epi32 only works up to 2^31
+inline f32x4 round(f32x4 a) {
+	const __m128 r = _mm_cvtepi32_ps(_mm_cvtps_epi32(a.v));
+	const __m128 small = _mm_cmplt_ps(abs(a).v, _mm_set1_ps(8388608.0f));
+	return _mm_or_ps(_mm_and_ps(small, r), _mm_andnot_ps(small, a.v));
+}
+
+inline m32x4 operator<(f32x4 a, f32x4 b) { return {_mm_cmplt_ps(a.v, b.v)}; }
+inline m32x4 operator<=(f32x4 a, f32x4 b) { return {_mm_cmple_ps(a.v, b.v)}; }
+inline m32x4 operator>(f32x4 a, f32x4 b) { return {_mm_cmpgt_ps(a.v, b.v)}; }
+inline m32x4 operator>=(f32x4 a, f32x4 b) { return {_mm_cmpge_ps(a.v, b.v)}; }
+inline m32x4 operator==(f32x4 a, f32x4 b) { return {_mm_cmpeq_ps(a.v, b.v)}; }
+inline m32x4 operator!=(f32x4 a, f32x4 b) { return {_mm_cmpneq_ps(a.v, b.v)}; }
+/// m ? a : b
+inline f32x4 select(m32x4 m, f32x4 a, f32x4 b) { return _mm_or_ps(_mm_and_ps(m.m, a.v), _mm_andnot_ps(m.m, b.v)); }
+
+/// In-register transpose of the 4x4 matrix whose rows are a, b, c and d
+inline void transpose(f32x4& a, f32x4& b, f32x4& c, f32x4& d) {
+	const __m128 t0 = _mm_unpacklo_ps(a.v, b.v);
+	const __m128 t1 = _mm_unpackhi_ps(a.v, b.v);
+	const __m128 t2 = _mm_unpacklo_ps(c.v, d.v);
+	const __m128 t3 = _mm_unpackhi_ps(c.v, d.v);
+	a = _mm_movelh_ps(t0, t2);
+	b = _mm_movehl_ps(t2, t0);
+	c = _mm_movelh_ps(t1, t3);
+	d = _mm_movehl_ps(t3, t1);
+}
+/// Split 4 interleaved points of S (2, 3 or 4) floats at p into one register per component
+template<int S>
+void deinterleave(const float* p, f32x4* r) {
+	static_assert(S >= 2 && S <= 4);
+	if constexpr(S == 2) {
+		const __m128 a = _mm_loadu_ps(p), b = _mm_loadu_ps(p + 4);
+		r[0] = _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0));
+		r[1] = _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1));
+	} else if constexpr(S == 3) {
+		/// a = x0 y0 z0 x1, b = y1 z1 x2 y2, c = z2 x3 y3 z3
+		const __m128 a = _mm_loadu_ps(p), b = _mm_loadu_ps(p + 4), c = _mm_loadu_ps(p + 8);
+		const __m128 x = _mm_shuffle_ps(b, c, _MM_SHUFFLE(1, 1, 2, 2));
+		const __m128 y0 = _mm_shuffle_ps(a, b, _MM_SHUFFLE(0, 0, 1, 1));
+		const __m128 y1 = _mm_shuffle_ps(b, c, _MM_SHUFFLE(2, 2, 3, 3));
+		const __m128 z = _mm_shuffle_ps(a, b, _MM_SHUFFLE(1, 1, 2, 2));
+		r[0] = _mm_shuffle_ps(a, x, _MM_SHUFFLE(2, 0, 3, 0));
+		r[1] = _mm_shuffle_ps(y0, y1, _MM_SHUFFLE(2, 0, 2, 0));
+		r[2] = _mm_shuffle_ps(z, c, _MM_SHUFFLE(3, 0, 2, 0));
+	} else {
+		r[0] = _mm_loadu_ps(p);
+		r[1] = _mm_loadu_ps(p + 4);
+		r[2] = _mm_loadu_ps(p + 8);
+		r[3] = _mm_loadu_ps(p + 12);
+		transpose(r[0], r[1], r[2], r[3]);
+	}
+}
+/// The inverse of deinterleave
+template<int S>
+void interleave(const f32x4* r, float* p) {
+	static_assert(S >= 2 && S <= 4);
+	if constexpr(S == 2) {
+		_mm_storeu_ps(p, _mm_unpacklo_ps(r[0].v, r[1].v));
+		_mm_storeu_ps(p + 4, _mm_unpackhi_ps(r[0].v, r[1].v));
+	} else if constexpr(S == 3) {
+		const __m128 x = r[0].v, y = r[1].v, z = r[2].v;
+		const __m128 a0 = _mm_shuffle_ps(x, y, _MM_SHUFFLE(0, 0, 0, 0)), a1 = _mm_shuffle_ps(z, x, _MM_SHUFFLE(1, 1, 0, 0));
+		const __m128 b0 = _mm_shuffle_ps(y, z, _MM_SHUFFLE(1, 1, 1, 1)), b1 = _mm_shuffle_ps(x, y, _MM_SHUFFLE(2, 2, 2, 2));
+		const __m128 c0 = _mm_shuffle_ps(z, x, _MM_SHUFFLE(3, 3, 2, 2)), c1 = _mm_shuffle_ps(y, z, _MM_SHUFFLE(3, 3, 3, 3));
+		_mm_storeu_ps(p, _mm_shuffle_ps(a0, a1, _MM_SHUFFLE(2, 0, 2, 0)));
+		_mm_storeu_ps(p + 4, _mm_shuffle_ps(b0, b1, _MM_SHUFFLE(2, 0, 2, 0)));
+		_mm_storeu_ps(p + 8, _mm_shuffle_ps(c0, c1, _MM_SHUFFLE(2, 0, 2, 0)));
+	} else {
+		f32x4 a = r[0], b = r[1], c = r[2], d = r[3];
+		transpose(a, b, c, d);
+		a.store(p);
+		b.store(p + 4);
+		c.store(p + 8);
+		d.store(p + 12);
+	}
+}
+
+#if defined(__AVX2__)
+
+struct f64x4 final {
+	__m256d v;
+
+	static f64x4 load(const double* p) { return {_mm256_loadu_pd(p)}; }
+	static f64x4 set1(double d) { return {_mm256_set1_pd(d)}; }
+	static f64x4 setr(double a, double b, double c, double d) { return {_mm256_setr_pd(a, b, c, d)}; }
+
+	void store(double* p) const { _mm256_storeu_pd(p, v); }
+};
+inline f64x4 operator+(f64x4 a, f64x4 b) { return {_mm256_add_pd(a.v, b.v)}; }
+inline f64x4 operator-(f64x4 a, f64x4 b) { return {_mm256_sub_pd(a.v, b.v)}; }
+inline f64x4 operator*(f64x4 a, f64x4 b) { return {_mm256_mul_pd(a.v, b.v)}; }
+inline f64x4 operator/(f64x4 a, f64x4 b) { return {_mm256_div_pd(a.v, b.v)}; }
+inline f64x4 sqrt(f64x4 a) { return {_mm256_sqrt_pd(a.v)}; }
+
+/// In-register transpose of the 4x4 matrix whose rows are a, b, c and d
+inline void transpose(f64x4& a, f64x4& b, f64x4& c, f64x4& d) {
+	const __m256d t0 = _mm256_unpacklo_pd(a.v, b.v);
+	const __m256d t1 = _mm256_unpackhi_pd(a.v, b.v);
+	const __m256d t2 = _mm256_unpacklo_pd(c.v, d.v);
+	const __m256d t3 = _mm256_unpackhi_pd(c.v, d.v);
+	a.v = _mm256_permute2f128_pd(t0, t2, 0x20);
+	b.v = _mm256_permute2f128_pd(t1, t3, 0x20);
+	c.v = _mm256_permute2f128_pd(t0, t2, 0x31);
+	d.v = _mm256_permute2f128_pd(t1, t3, 0x31);
+}
+
+#else
+
+struct f64x4 final {
+	__m128d lo, hi;
+
+	static f64x4 load(const double* p) { return {_mm_loadu_pd(p), _mm_loadu_pd(p + 2)}; }
+	static f64x4 set1(double d) { return {_mm_set1_pd(d), _mm_set1_pd(d)}; }
+	static f64x4 setr(double a, double b, double c, double d) { return {_mm_setr_pd(a, b), _mm_setr_pd(c, d)}; }
+
+	void store(double* p) const { _mm_storeu_pd(p, lo); _mm_storeu_pd(p + 2, hi); }
+};
+inline f64x4 operator+(f64x4 a, f64x4 b) { return {_mm_add_pd(a.lo, b.lo), _mm_add_pd(a.hi, b.hi)}; }
+inline f64x4 operator-(f64x4 a, f64x4 b) { return {_mm_sub_pd(a.lo, b.lo), _mm_sub_pd(a.hi, b.hi)}; }
+inline f64x4 operator*(f64x4 a, f64x4 b) { return {_mm_mul_pd(a.lo, b.lo), _mm_mul_pd(a.hi, b.hi)}; }
+inline f64x4 operator/(f64x4 a, f64x4 b) { return {_mm_div_pd(a.lo, b.lo), _mm_div_pd(a.hi, b.hi)}; }
+inline f64x4 sqrt(f64x4 a) { return {_mm_sqrt_pd(a.lo), _mm_sqrt_pd(a.hi)}; }
+
+/// In-register transpose of the 4x4 matrix whose rows are a, b, c and d
+inline void transpose(f64x4& a, f64x4& b, f64x4& c, f64x4& d) {
+	const f64x4 ta = a, tb = b, tc = c;
+	a = {_mm_unpacklo_pd(ta.lo, tb.lo), _mm_unpacklo_pd(tc.lo, d.lo)};
+	b = {_mm_unpackhi_pd(ta.lo, tb.lo), _mm_unpackhi_pd(tc.lo, d.lo)};
+	c = {_mm_unpacklo_pd(ta.hi, tb.hi), _mm_unpacklo_pd(tc.hi, d.hi)};
+	d = {_mm_unpackhi_pd(ta.hi, tb.hi), _mm_unpackhi_pd(tc.hi, d.hi)};
+}
+
+#endif // __AVX2__
+#if defined(__AVX2__)
+
+struct m32x8 final {
+	__m256 m;
+
+	/// Lane i is set if bit i of b is set. The inverse of bits()
+	static m32x8 fromBits(int b) {
+		const __m256i bit = _mm256_setr_epi32(1, 2, 4, 8, 16, 32, 64, 128);
+		return {_mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_and_si256(_mm256_set1_epi32(b), bit), bit))};
+	}
+};
+inline m32x8 operator&(m32x8 a, m32x8 b) { return {_mm256_and_ps(a.m, b.m)}; }
+inline m32x8 operator|(m32x8 a, m32x8 b) { return {_mm256_or_ps(a.m, b.m)}; }
+inline m32x8 operator~(m32x8 a) { return {_mm256_xor_ps(a.m, _mm256_castsi256_ps(_mm256_set1_epi32(-1)))}; }
+/// One bit per lane
+inline int bits(m32x8 a) { return _mm256_movemask_ps(a.m); }
+
+struct f32x8 final {
+	using mask = m32x8;
+	static constexpr int width = 8;
+	__m256 v;
+
+	f32x8() = default;
+	f32x8(__m256 v) : v(v) {}
+
+	static f32x8 load(const float* p) { return _mm256_loadu_ps(p); }
+	static f32x8 set1(float f) { return _mm256_set1_ps(f); }
+	static f32x8 zero() { return _mm256_setzero_ps(); }
+
+	void store(float* p) const { _mm256_storeu_ps(p, v); }
+
+	static f32x8 loadI16(const int16_t* p) { return _mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i*)p))); }
+	static f32x8 loadU8(const uint8_t* p) { return _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)p))); }
+	static f32x8 loadHalf(const uint16_t* p) { return _mm256_cvtph_ps(_mm_loadu_si128((const __m128i*)p)); }
+	static f32x8 loadF64(const double* p) {
+		return _mm256_insertf128_ps(_mm256_castps128_ps256(_mm256_cvtpd_ps(_mm256_loadu_pd(p))), _mm256_cvtpd_ps(_mm256_loadu_pd(p + 4)), 1);
+	}
+	void storeI16(int16_t* p) const {
+		const __m256i i = _mm256_cvtps_epi32(v);
+		_mm_storeu_si128((__m128i*)p, _mm_packs_epi32(_mm256_castsi256_si128(i), _mm256_extracti128_si256(i, 1)));
+	}
+	void storeU8(uint8_t* p) const {
+		const __m256i i = _mm256_cvtps_epi32(v);
+		const __m128i s = _mm_packs_epi32(_mm256_castsi256_si128(i), _mm256_extracti128_si256(i, 1));
+		_mm_storel_epi64((__m128i*)p, _mm_packus_epi16(s, s));
+	}
+	void storeI32(int32_t* p) const { _mm256_storeu_si256((__m256i*)p, _mm256_cvtps_epi32(v)); }
+	void storeHalf(uint16_t* p) const { _mm_storeu_si128((__m128i*)p, _mm256_cvtps_ph(v, _MM_FROUND_TO_NEAREST_INT)); }
+};
+
+inline f32x8 operator+(f32x8 a, f32x8 b) { return _mm256_add_ps(a.v, b.v); }
+inline f32x8 operator-(f32x8 a, f32x8 b) { return _mm256_sub_ps(a.v, b.v); }
+inline f32x8 operator*(f32x8 a, f32x8 b) { return _mm256_mul_ps(a.v, b.v); }
+inline f32x8 operator/(f32x8 a, f32x8 b) { return _mm256_div_ps(a.v, b.v); }
+
+inline f32x8 sqrt(f32x8 a) { return _mm256_sqrt_ps(a.v); }
+inline f32x8 min(f32x8 a, f32x8 b) { return _mm256_min_ps(a.v, b.v); }
+inline f32x8 max(f32x8 a, f32x8 b) { return _mm256_max_ps(a.v, b.v); }
+/// a*b + c
+inline f32x8 fmadd(f32x8 a, f32x8 b, f32x8 c) { return _mm256_fmadd_ps(a.v, b.v, c.v); }
+
+inline f32x8 operator-(f32x8 a) { return _mm256_xor_ps(a.v, _mm256_set1_ps(-0.0f)); }
+inline f32x8 operator&(f32x8 a, f32x8 b) { return _mm256_and_ps(a.v, b.v); }
+inline f32x8 operator|(f32x8 a, f32x8 b) { return _mm256_or_ps(a.v, b.v); }
+inline f32x8 operator^(f32x8 a, f32x8 b) { return _mm256_xor_ps(a.v, b.v); }
+inline f32x8 abs(f32x8 a) { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a.v); }
+/// The sign bit of a
+inline f32x8 sign(f32x8 a) { return _mm256_and_ps(_mm256_set1_ps(-0.0f), a.v); }
+/// Round to the nearest integer
+inline f32x8 round(f32x8 a) { return _mm256_round_ps(a.v, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+
+inline m32x8 operator<(f32x8 a, f32x8 b) { return {_mm256_cmp_ps(a.v, b.v, _CMP_LT_OQ)}; }
+inline m32x8 operator<=(f32x8 a, f32x8 b) { return {_mm256_cmp_ps(a.v, b.v, _CMP_LE_OQ)}; }
+inline m32x8 operator>(f32x8 a, f32x8 b) { return {_mm256_cmp_ps(a.v, b.v, _CMP_GT_OQ)}; }
+inline m32x8 operator>=(f32x8 a, f32x8 b) { return {_mm256_cmp_ps(a.v, b.v, _CMP_GE_OQ)}; }
+inline m32x8 operator==(f32x8 a, f32x8 b) { return {_mm256_cmp_ps(a.v, b.v, _CMP_EQ_OQ)}; }
+inline m32x8 operator!=(f32x8 a, f32x8 b) { return {_mm256_cmp_ps(a.v, b.v, _CMP_NEQ_UQ)}; }
+/// m ? a : b
+inline f32x8 select(m32x8 m, f32x8 a, f32x8 b) { return _mm256_blendv_ps(b.v, a.v, m.m); }
+
+#endif // __AVX2__
+#if defined(__AVX512F__)
+
+struct m32x16 final {
+	__mmask16 m;
+
+	/// Lane i is set if bit i of b is set. The inverse of bits()
+	static m32x16 fromBits(int b) { return {(__mmask16)b}; }
+};
+inline m32x16 operator&(m32x16 a, m32x16 b) { return {(__mmask16)(a.m & b.m)}; }
+inline m32x16 operator|(m32x16 a, m32x16 b) { return {(__mmask16)(a.m | b.m)}; }
+inline m32x16 operator~(m32x16 a) { return {(__mmask16)~a.m}; }
+/// One bit per lane
+inline int bits(m32x16 a) { return a.m; }
+
+struct f32x16 final {
+	using mask = m32x16;
+	static constexpr int width = 16;
+	__m512 v;
+
+	f32x16() = default;
+	f32x16(__m512 v) : v(v) {}
+
+	static f32x16 load(const float* p) { return _mm512_loadu_ps(p); }
+	static f32x16 set1(float f) { return _mm512_set1_ps(f); }
+	static f32x16 zero() { return _mm512_setzero_ps(); }
+
+	void store(float* p) const { _mm512_storeu_ps(p, v); }
+
+	static f32x16 loadI16(const int16_t* p) { return _mm512_cvtepi32_ps(_mm512_cvtepi16_epi32(_mm256_loadu_si256((const __m256i*)p))); }
+	static f32x16 loadU8(const uint8_t* p) { return _mm512_cvtepi32_ps(_mm512_cvtepu8_epi32(_mm_loadu_si128((const __m128i*)p))); }
+	static f32x16 loadHalf(const uint16_t* p) { return _mm512_cvtph_ps(_mm256_loadu_si256((const __m256i*)p)); }
+	static f32x16 loadF64(const double* p) {
+		return _mm512_insertf32x8(_mm512_castps256_ps512(_mm512_cvtpd_ps(_mm512_loadu_pd(p))), _mm512_cvtpd_ps(_mm512_loadu_pd(p + 8)), 1);
+	}
+	void storeI16(int16_t* p) const { _mm256_storeu_si256((__m256i*)p, _mm512_cvtsepi32_epi16(_mm512_cvtps_epi32(v))); }
+	void storeU8(uint8_t* p) const {
+		const __m512i i = _mm512_max_epi32(_mm512_cvtps_epi32(v), _mm512_setzero_si512());
+		_mm_storeu_si128((__m128i*)p, _mm512_cvtusepi32_epi8(i));
+	}
+	void storeI32(int32_t* p) const { _mm512_storeu_si512(p, _mm512_cvtps_epi32(v)); }
+	void storeHalf(uint16_t* p) const { _mm256_storeu_si256((__m256i*)p, _mm512_cvtps_ph(v, _MM_FROUND_TO_NEAREST_INT)); }
+};
+
+inline f32x16 operator+(f32x16 a, f32x16 b) { return _mm512_add_ps(a.v, b.v); }
+inline f32x16 operator-(f32x16 a, f32x16 b) { return _mm512_sub_ps(a.v, b.v); }
+inline f32x16 operator*(f32x16 a, f32x16 b) { return _mm512_mul_ps(a.v, b.v); }
+inline f32x16 operator/(f32x16 a, f32x16 b) { return _mm512_div_ps(a.v, b.v); }
+
+inline f32x16 sqrt(f32x16 a) { return _mm512_sqrt_ps(a.v); }
+inline f32x16 min(f32x16 a, f32x16 b) { return _mm512_min_ps(a.v, b.v); }
+inline f32x16 max(f32x16 a, f32x16 b) { return _mm512_max_ps(a.v, b.v); }
+/// a*b + c
+inline f32x16 fmadd(f32x16 a, f32x16 b, f32x16 c) { return _mm512_fmadd_ps(a.v, b.v, c.v); }
+
+inline f32x16 operator-(f32x16 a) { return _mm512_xor_ps(a.v, _mm512_set1_ps(-0.0f)); }
+inline f32x16 operator&(f32x16 a, f32x16 b) { return _mm512_and_ps(a.v, b.v); }
+inline f32x16 operator|(f32x16 a, f32x16 b) { return _mm512_or_ps(a.v, b.v); }
+inline f32x16 operator^(f32x16 a, f32x16 b) { return _mm512_xor_ps(a.v, b.v); }
+inline f32x16 abs(f32x16 a) { return _mm512_abs_ps(a.v); }
+/// The sign bit of a
+inline f32x16 sign(f32x16 a) { return _mm512_and_ps(_mm512_set1_ps(-0.0f), a.v); }
+/// Round to the nearest integer
+inline f32x16 round(f32x16 a) { return _mm512_roundscale_ps(a.v, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+
+inline m32x16 operator<(f32x16 a, f32x16 b) { return {_mm512_cmp_ps_mask(a.v, b.v, _CMP_LT_OQ)}; }
+inline m32x16 operator<=(f32x16 a, f32x16 b) { return {_mm512_cmp_ps_mask(a.v, b.v, _CMP_LE_OQ)}; }
+inline m32x16 operator>(f32x16 a, f32x16 b) { return {_mm512_cmp_ps_mask(a.v, b.v, _CMP_GT_OQ)}; }
+inline m32x16 operator>=(f32x16 a, f32x16 b) { return {_mm512_cmp_ps_mask(a.v, b.v, _CMP_GE_OQ)}; }
+inline m32x16 operator==(f32x16 a, f32x16 b) { return {_mm512_cmp_ps_mask(a.v, b.v, _CMP_EQ_OQ)}; }
+inline m32x16 operator!=(f32x16 a, f32x16 b) { return {_mm512_cmp_ps_mask(a.v, b.v, _CMP_NEQ_UQ)}; }
+/// m ? a : b
+inline f32x16 select(m32x16 m, f32x16 a, f32x16 b) { return _mm512_mask_blend_ps(m.m, b.v, a.v); }
+
+#endif // __AVX512F__
+
+}
+}
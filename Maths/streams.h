@@ -0,0 +1,342 @@
+#pragma once
+///
+///	Structure-of-arrays storage for float3 and float4 plus batch
+/// functions that operate on whole streams at a time.
+///
+/// float3_stream s{points};
+/// lengthAll(s, lengths);
+///
+/// The batch functions call the runtime selected kernels in kernels.h.
+/// Each kernel processes 2 SIMD registers (8, 16 or 32 floats) per
+/// iteration and finishes the tail with scalar code.
+///
+/// deinterleave(), interleave() and the stream constructors and toArray()
+/// shuffle 4 points at a time between the interleaved and planar layouts.
+/// toAosoa() and fromAosoa() convert to and from blocks of 4 or 8 points.
+///
+#include <algorithm>
+#include <span>
+#include <vector>
+#include "kernels.h"
+
+namespace maths {
+
+template<typename F>
+struct stream2_span final {
+	std::span<F> x, y;
+
+	stream2_span() = default;
+	stream2_span(std::span<F> x, std::span<F> y) : x(x), y(y) {
+		assert(x.size() == y.size());
+	}
+	/// Allow non-const -> const
+	template<typename S>
+	stream2_span(const stream2_span<S>& o) : x(o.x), y(o.y) {}
+
+	std::size_t size() const { return x.size(); }
+
+	stream2_span subspan(std::size_t offset, std::size_t count) const {
+		return {x.subspan(offset, count), y.subspan(offset, count)};
+	}
+};
+template<typename F>
+struct stream3_span final {
+	std::span<F> x, y, z;
+
+	stream3_span() = default;
+	stream3_span(std::span<F> x, std::span<F> y, std::span<F> z) : x(x), y(y), z(z) {
+		assert(x.size() == y.size() && x.size() == z.size());
+	}
+	/// Allow non-const -> const
+	template<typename S>
+	stream3_span(const stream3_span<S>& o) : x(o.x), y(o.y), z(o.z) {}
+
+	std::size_t size() const { return x.size(); }
+
+	stream3_span subspan(std::size_t offset, std::size_t count) const {
+		return {x.subspan(offset, count), y.subspan(offset, count), z.subspan(offset, count)};
+	}
+};
+template<typename F>
+struct stream4_span final {
+	std::span<F> x, y, z, w;
+
+	stream4_span() = default;
+	stream4_span(std::span<F> x, std::span<F> y, std::span<F> z, std::span<F> w) : x(x), y(y), z(z), w(w) {
+		assert(x.size() == y.size() && x.size() == z.size() && x.size() == w.size());
+	}
+	/// Allow non-const -> const
+	template<typename S>
+	stream4_span(const stream4_span<S>& o) : x(o.x), y(o.y), z(o.z), w(o.w) {}
+
+	std::size_t size() const { return x.size(); }
+
+	stream4_span subspan(std::size_t offset, std::size_t count) const {
+		return {x.subspan(offset, count), y.subspan(offset, count), z.subspan(offset, count), w.subspan(offset, count)};
+	}
+};
+
+typedef stream2_span<float> float2_span;
+typedef stream2_span<const float> cfloat2_span;
+typedef stream3_span<float> float3_span;
+typedef stream3_span<const float> cfloat3_span;
+typedef stream4_span<float> float4_span;
+typedef stream4_span<const float> cfloat4_span;
+
+struct float2_stream final {
+	std::vector<float> x, y;
+
+	float2_stream() = default;
+	explicit float2_stream(std::size_t n) : x(n), y(n) {}
+	explicit float2_stream(std::span<const float2> v) {
+		resize(v.size());
+		kernels::table().toSoa((const float*)v.data(), 2, {{x.data(), y.data(), nullptr, nullptr}}, v.size());
+	}
+
+	operator float2_span() { return {x, y}; }
+	operator cfloat2_span() const { return {x, y}; }
+
+	std::size_t size() const { return x.size(); }
+	bool empty() const { return x.empty(); }
+
+	void resize(std::size_t n) { x.resize(n); y.resize(n); }
+	void reserve(std::size_t n) { x.reserve(n); y.reserve(n); }
+	void clear() { x.clear(); y.clear(); }
+	void push_back(const float2& v) { x.push_back(v.x); y.push_back(v.y); }
+
+	float2 get(std::size_t i) const { return {x[i], y[i]}; }
+	void set(std::size_t i, const float2& v) { x[i] = v.x; y[i] = v.y; }
+
+	/// Write the stream back out as an array of float2
+	void toArray(std::span<float2> out) const {
+		assert(out.size() == size());
+		kernels::table().fromSoa({{x.data(), y.data(), nullptr, nullptr}}, 2, (float*)out.data(), size());
+	}
+
+	/// Evaluate an expression from expr.h in a single pass
+	template<typename E> requires (E::components == 2)
+	float2_stream& operator=(const E& e) {
+		resize(e.size());
+		evaluate(e, float2_span(*this));
+		return *this;
+	}
+};
+
+struct float3_stream final {
+	std::vector<float> x, y, z;
+
+	float3_stream() = default;
+	explicit float3_stream(std::size_t n) : x(n), y(n), z(n) {}
+	explicit float3_stream(std::span<const float3> v) {
+		resize(v.size());
+		kernels::table().toSoa((const float*)v.data(), 3, {{x.data(), y.data(), z.data(), nullptr}}, v.size());
+	}
+
+	operator float3_span() { return {x, y, z}; }
+	operator cfloat3_span() const { return {x, y, z}; }
+
+	std::size_t size() const { return x.size(); }
+	bool empty() const { return x.empty(); }
+
+	void resize(std::size_t n) { x.resize(n); y.resize(n); z.resize(n); }
+	void reserve(std::size_t n) { x.reserve(n); y.reserve(n); z.reserve(n); }
+	void clear() { x.clear(); y.clear(); z.clear(); }
+	void push_back(const float3& v) { x.push_back(v.x); y.push_back(v.y); z.push_back(v.z); }
+
+	float3 get(std::size_t i) const { return {x[i], y[i], z[i]}; }
+	void set(std::size_t i, const float3& v) { x[i] = v.x; y[i] = v.y; z[i] = v.z; }
+
+	/// Write the stream back out as an array of float3
+	void toArray(std::span<float3> out) const {
+		assert(out.size() == size());
+		kernels::table().fromSoa({{x.data(), y.data(), z.data(), nullptr}}, 3, (float*)out.data(), size());
+	}
+
+	/// Evaluate an expression from expr.h in a single pass
+	template<typename E> requires (E::components == 3)
+	float3_stream& operator=(const E& e) {
+		resize(e.size());
+		evaluate(e, float3_span(*this));
+		return *this;
+	}
+};
+
+struct float4_stream final {
+	std::vector<float> x, y, z, w;
+
+	float4_stream() = default;
+	explicit float4_stream(std::size_t n) : x(n), y(n), z(n), w(n) {}
+	explicit float4_stream(std::span<const float4> v) {
+		resize(v.size());
+		kernels::table().toSoa((const float*)v.data(), 4, {{x.data(), y.data(), z.data(), w.data()}}, v.size());
+	}
+
+	operator float4_span() { return {x, y, z, w}; }
+	operator cfloat4_span() const { return {x, y, z, w}; }
+
+	std::size_t size() const { return x.size(); }
+	bool empty() const { return x.empty(); }
+
+	void resize(std::size_t n) { x.resize(n); y.resize(n); z.resize(n); w.resize(n); }
+	void reserve(std::size_t n) { x.reserve(n); y.reserve(n); z.reserve(n); w.reserve(n); }
+	void clear() { x.clear(); y.clear(); z.clear(); w.clear(); }
+	void push_back(const float4& v) { x.push_back(v.x); y.push_back(v.y); z.push_back(v.z); w.push_back(v.w); }
+
+	float4 get(std::size_t i) const { return {x[i], y[i], z[i], w[i]}; }
+	void set(std::size_t i, const float4& v) { x[i] = v.x; y[i] = v.y; z[i] = v.z; w[i] = v.w; }
+
+	/// Write the stream back out as an array of float4
+	void toArray(std::span<float4> out) const {
+		assert(out.size() == size());
+		kernels::table().fromSoa({{x.data(), y.data(), z.data(), w.data()}}, 4, (float*)out.data(), size());
+	}
+
+	/// Evaluate an expression from expr.h in a single pass
+	template<typename E> requires (E::components == 4)
+	float4_stream& operator=(const E& e) {
+		resize(e.size());
+		evaluate(e, float4_span(*this));
+		return *this;
+	}
+};
+
+namespace kernels {
+inline csoa ptrs(cfloat2_span s) { return {{s.x.data(), s.y.data(), nullptr, nullptr}}; }
+inline soa ptrs(float2_span s) { return {{s.x.data(), s.y.data(), nullptr, nullptr}}; }
+inline csoa ptrs(cfloat3_span s) { return {{s.x.data(), s.y.data(), s.z.data(), nullptr}}; }
+inline csoa ptrs(cfloat4_span s) { return {{s.x.data(), s.y.data(), s.z.data(), s.w.data()}}; }
+inline soa ptrs(float3_span s) { return {{s.x.data(), s.y.data(), s.z.data(), nullptr}}; }
+inline soa ptrs(float4_span s) { return {{s.x.data(), s.y.data(), s.z.data(), s.w.data()}}; }
+}
+
+/// out[i] = a[i].dot(b[i])
+inline void dot(cfloat3_span a, cfloat3_span b, std::span<float> out) {
+	assert(a.size() == out.size() && b.size() == out.size());
+	kernels::table().dot3(kernels::ptrs(a), kernels::ptrs(b), out.data(), out.size());
+}
+inline void dot(cfloat4_span a, cfloat4_span b, std::span<float> out) {
+	assert(a.size() == out.size() && b.size() == out.size());
+	kernels::table().dot4(kernels::ptrs(a), kernels::ptrs(b), out.data(), out.size());
+}
+/// out[i] = a[i].cross(b[i])
+inline void cross(cfloat3_span a, cfloat3_span b, float3_span out) {
+	assert(a.size() == out.size() && b.size() == out.size());
+	kernels::table().cross3(kernels::ptrs(a), kernels::ptrs(b), kernels::ptrs(out), out.size());
+}
+/// out[i] = v[i].length()
+inline void lengthAll(cfloat3_span v, std::span<float> out) {
+	assert(v.size() == out.size());
+	kernels::table().length3(kernels::ptrs(v), out.data(), out.size());
+}
+inline void lengthAll(cfloat4_span v, std::span<float> out) {
+	assert(v.size() == out.size());
+	kernels::table().length4(kernels::ptrs(v), out.data(), out.size());
+}
+/// v[i].normalise()
+inline void normaliseAll(float3_span v) {
+	kernels::table().normalise3(kernels::ptrs(v), v.size());
+}
+inline void normaliseAll(float4_span v) {
+	kernels::table().normalise4(kernels::ptrs(v), v.size());
+}
+/// out[i] = a[i] + (b[i]-a[i])*t
+inline void lerpAll(cfloat3_span a, cfloat3_span b, float t, float3_span out) {
+	assert(a.size() == out.size() && b.size() == out.size());
+	kernels::table().lerp(a.x.data(), b.x.data(), t, out.x.data(), out.size());
+	kernels::table().lerp(a.y.data(), b.y.data(), t, out.y.data(), out.size());
+	kernels::table().lerp(a.z.data(), b.z.data(), t, out.z.data(), out.size());
+}
+inline void lerpAll(cfloat4_span a, cfloat4_span b, float t, float4_span out) {
+	assert(a.size() == out.size() && b.size() == out.size());
+	kernels::table().lerp(a.x.data(), b.x.data(), t, out.x.data(), out.size());
+	kernels::table().lerp(a.y.data(), b.y.data(), t, out.y.data(), out.size());
+	kernels::table().lerp(a.z.data(), b.z.data(), t, out.z.data(), out.size());
+	kernels::table().lerp(a.w.data(), b.w.data(), t, out.w.data(), out.size());
+}
+
+/// out[i] = v[i].rotatedAroundX(radians[i]). out may be v
+inline void rotateAroundX(cfloat3_span v, std::span<const float> radians, float3_span out) {
+	assert(v.size() == out.size() && radians.size() == out.size());
+	if(out.x.data() != v.x.data()) std::copy(v.x.begin(), v.x.end(), out.x.begin());
+	kernels::table().rotate(v.y.data(), v.z.data(), radians.data(), out.y.data(), out.z.data(), out.size());
+}
+/// out[i] = v[i].rotatedAroundY(radians[i]). out may be v
+inline void rotateAroundY(cfloat3_span v, std::span<const float> radians, float3_span out) {
+	assert(v.size() == out.size() && radians.size() == out.size());
+	if(out.y.data() != v.y.data()) std::copy(v.y.begin(), v.y.end(), out.y.begin());
+	kernels::table().rotate(v.z.data(), v.x.data(), radians.data(), out.z.data(), out.x.data(), out.size());
+}
+/// out[i] = v[i].rotatedAroundZ(radians[i]). out may be v
+inline void rotateAroundZ(cfloat3_span v, std::span<const float> radians, float3_span out) {
+	assert(v.size() == out.size() && radians.size() == out.size());
+	if(out.z.data() != v.z.data()) std::copy(v.z.begin(), v.z.end(), out.z.begin());
+	kernels::table().rotate(v.x.data(), v.y.data(), radians.data(), out.x.data(), out.y.data(), out.size());
+}
+
+/// out[i] = m * v[i]
+inline void transform(const matrix& m, cfloat4_span v, float4_span out) {
+	assert(v.size() == out.size());
+	kernels::table().transform4(&m[0].x, kernels::ptrs(v), kernels::ptrs(out), out.size());
+}
+
+/// Interleaved points to planar streams and back
+inline void deinterleave(std::span<const float2> in, float2_span out) {
+	assert(in.size() == out.size());
+	kernels::table().toSoa((const float*)in.data(), 2, kernels::ptrs(out), in.size());
+}
+inline void deinterleave(std::span<const float3> in, float3_span out) {
+	assert(in.size() == out.size());
+	kernels::table().toSoa((const float*)in.data(), 3, kernels::ptrs(out), in.size());
+}
+inline void deinterleave(std::span<const float4> in, float4_span out) {
+	assert(in.size() == out.size());
+	kernels::table().toSoa((const float*)in.data(), 4, kernels::ptrs(out), in.size());
+}
+inline void interleave(cfloat2_span in, std::span<float2> out) {
+	assert(in.size() == out.size());
+	kernels::table().fromSoa(kernels::ptrs(in), 2, (float*)out.data(), in.size());
+}
+inline void interleave(cfloat3_span in, std::span<float3> out) {
+	assert(in.size() == out.size());
+	kernels::table().fromSoa(kernels::ptrs(in), 3, (float*)out.data(), in.size());
+}
+inline void interleave(cfloat4_span in, std::span<float4> out) {
+	assert(in.size() == out.size());
+	kernels::table().fromSoa(kernels::ptrs(in), 4, (float*)out.data(), in.size());
+}
+
+///
+/// Array of structures of arrays. Points are stored in blocks of 4 or 8,
+/// each holding block x values, then block y values and so on, so that a
+/// block of each component can be loaded straight into a register.
+///
+/// std::vector<float> blocks(aosoaSize(points.size(), 3, 8));
+/// toAosoa(points, 8, blocks);
+///
+/// The last block is padded with zeros.
+///
+constexpr std::size_t aosoaSize(std::size_t n, int components, int block) {
+	return (n + block - 1) / block * block * components;
+}
+namespace detail {
+template<typename V>
+void toAosoa(std::span<const V> in, int block, std::span<float> out) {
+	constexpr int S = sizeof(V) / sizeof(float);
+	assert((block == 4 || block == 8) && out.size() >= aosoaSize(in.size(), S, block));
+	kernels::table().toAosoa((const float*)in.data(), S, block, out.data(), in.size());
+}
+template<typename V>
+void fromAosoa(std::span<const float> in, int block, std::span<V> out) {
+	constexpr int S = sizeof(V) / sizeof(float);
+	assert((block == 4 || block == 8) && in.size() >= aosoaSize(out.size(), S, block));
+	kernels::table().fromAosoa(in.data(), S, block, (float*)out.data(), out.size());
+}
+}
+inline void toAosoa(std::span<const float2> in, int block, std::span<float> out) { detail::toAosoa(in, block, out); }
+inline void toAosoa(std::span<const float3> in, int block, std::span<float> out) { detail::toAosoa(in, block, out); }
+inline void toAosoa(std::span<const float4> in, int block, std::span<float> out) { detail::toAosoa(in, block, out); }
+inline void fromAosoa(std::span<const float> in, int block, std::span<float2> out) { detail::fromAosoa(in, block, out); }
+inline void fromAosoa(std::span<const float> in, int block, std::span<float3> out) { detail::fromAosoa(in, block, out); }
+inline void fromAosoa(std::span<const float> in, int block, std::span<float4> out) { detail::fromAosoa(in, block, out); }
+
+}
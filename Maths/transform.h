@@ -0,0 +1,229 @@
+#pragma once
+///
+///	Batch transforms of float3 points and directions by a matrix.
+///
+/// transformPoints(m, points, out);     /// (m * float4{p, 1}).xyz
+/// transformDirections(m, dirs, out);   /// (m * float4{d, 0}).xyz
+/// projectPoints(viewProj, points, clip);  /// float4 clip coordinates
+/// projectPoints(viewProj, points, ndc);   /// float3 after the w divide
+///
+/// transformPoints and transformDirections ignore the bottom row of m so
+/// use projectPoints for projection matrices.
+///
+/// The float2x3 overloads transform float2 points and directions by a 2D
+/// affine transform, eg. sprites by Camera2D::VP2().
+///
+/// instanceMVPs(camera, models, mvps) writes camera.VP() * models[i] for
+/// every instance, optionally with the normal matrix of each model (the
+/// inverse transpose of its upper 3x3, as 3 float4 columns with w = 0 like
+/// a std140 mat3). The normal matrix of a model whose upper 3x3 is singular
+/// is all zeros. The InstanceLayout overload writes straight into an
+/// interleaved per-instance buffer such as a mapped GPU upload buffer.
+///
+/// multiply(a, b, out) and transform(dm, in, out) are dmatrix * dmatrix and
+/// dmatrix * double4 over spans, and inversedAll, transposedAll and
+/// normaliseAll are dmatrix::inversed(), transposed() and double4::normalised().
+/// They use 256 bit AVX registers when the AVX2 kernels are selected and
+/// give the same results as the dmatrix and double4 members, which are SSE2.
+///
+/// toFloat(dmatrices, origin, matrices) converts double precision
+/// transforms for rendering relative to origin (usually the camera
+/// position), subtracting it in double before rounding to float.
+///
+/// The runtime selected kernels transform 4, 8 or 16 points at a time.
+/// Inputs larger than one chunk of 16384 points are split across the
+/// threads in parallel.h. in and out may be the same span for the float3
+/// versions but must not otherwise overlap.
+///
+#include <cstddef>
+#include <span>
+#include "kernels.h"
+#include "parallel.h"
+
+namespace maths {
+
+namespace detail {
+
+constexpr std::size_t TRANSFORM_CHUNK = 1 << 14;
+constexpr std::size_t MVP_CHUNK = 1 << 12;
+constexpr std::size_t DMUL_CHUNK = 1 << 12;
+
+template<typename Out>
+void transform3(const matrix& m, std::span<const float3> in, std::span<Out> out, float w, bool divide) {
+	assert(in.size() == out.size());
+	constexpr int S = sizeof(Out) / sizeof(float);
+	const std::size_t n = in.size();
+	parallel::forEach((n + TRANSFORM_CHUNK - 1) / TRANSFORM_CHUNK, [&](std::size_t c) {
+		const std::size_t begin = c * TRANSFORM_CHUNK;
+		kernels::table().transform3(&m[0].x, (const float*)(in.data() + begin), w, divide,
+			(float*)(out.data() + begin), S, std::min(TRANSFORM_CHUNK, n - begin));
+	});
+}
+inline void mvp(const matrix& vp, std::span<const matrix> models, float* out, std::size_t outStride,
+				float* normals, std::size_t normalStride)
+{
+	const std::size_t n = models.size();
+	parallel::forEach((n + MVP_CHUNK - 1) / MVP_CHUNK, [&](std::size_t c) {
+		const std::size_t begin = c * MVP_CHUNK;
+		kernels::table().mvp(&vp[0].x, &models[begin][0].x, out + begin * outStride, outStride,
+			normals ? normals + begin * normalStride : nullptr, normalStride, std::min(MVP_CHUNK, n - begin));
+	});
+}
+/// fn(begin, count) for each chunk of n dmatrices or double4s, in parallel
+template<typename F>
+void forEachDmatrixChunk(std::size_t n, F fn) {
+	parallel::forEach((n + DMUL_CHUNK - 1) / DMUL_CHUNK, [&](std::size_t c) {
+		const std::size_t begin = c * DMUL_CHUNK;
+		fn(begin, std::min(DMUL_CHUNK, n - begin));
+	});
+}
+inline void dmul(const dmatrix* a, std::size_t aStride, std::span<const dmatrix> b, std::span<dmatrix> out) {
+	assert(b.size() == out.size());
+	forEachDmatrixChunk(b.size(), [&](std::size_t begin, std::size_t count) {
+		kernels::table().dmul((const double*)a + begin * aStride, aStride, (const double*)(b.data() + begin),
+			(double*)(out.data() + begin), count);
+	});
+}
+inline void transform2(const float2x3& a, std::span<const float2> in, std::span<float2> out, float w) {
+	assert(in.size() == out.size());
+	const std::size_t n = in.size();
+	parallel::forEach((n + TRANSFORM_CHUNK - 1) / TRANSFORM_CHUNK, [&](std::size_t c) {
+		const std::size_t begin = c * TRANSFORM_CHUNK;
+		kernels::table().transform2(&a.r[0].x, (const float*)(in.data() + begin), w,
+			(float*)(out.data() + begin), std::min(TRANSFORM_CHUNK, n - begin));
+	});
+}
+
+}
+
+inline void transformPoints(const matrix& m, std::span<const float3> in, std::span<float3> out) {
+	detail::transform3(m, in, out, 1, false);
+}
+inline void transformDirections(const matrix& m, std::span<const float3> in, std::span<float3> out) {
+	detail::transform3(m, in, out, 0, false);
+}
+/// Clip space coordinates m * float4{p, 1}
+inline void projectPoints(const matrix& m, std::span<const float3> in, std::span<float4> clip) {
+	detail::transform3(m, in, clip, 1, false);
+}
+/// Normalised device coordinates: clip.xyz / clip.w
+inline void projectPoints(const matrix& m, std::span<const float3> in, std::span<float3> ndc) {
+	detail::transform3(m, in, ndc, 1, true);
+}
+
+/// a.transformPoint(in[i])
+inline void transformPoints(const float2x3& a, std::span<const float2> in, std::span<float2> out) {
+	detail::transform2(a, in, out, 1);
+}
+/// a.transformDirection(in[i])
+inline void transformDirections(const float2x3& a, std::span<const float2> in, std::span<float2> out) {
+	detail::transform2(a, in, out, 0);
+}
+
+/// Byte offsets within one instance of a caller's buffer. normal is NONE
+/// to skip the normal matrices. All must be multiples of 4
+struct InstanceLayout final {
+	static constexpr std::size_t NONE = ~std::size_t(0);
+
+	std::size_t stride = sizeof(matrix);
+	std::size_t mvp = 0;
+	std::size_t normal = NONE;
+};
+
+/// mvps[i] = vp * models[i]
+inline void instanceMVPs(const matrix& vp, std::span<const matrix> models, std::span<matrix> mvps) {
+	assert(models.size() == mvps.size());
+	detail::mvp(vp, models, (float*)mvps.data(), 16, nullptr, 0);
+}
+/// Also writes normals[i * 3 + c] = column c of the normal matrix of models[i]
+inline void instanceMVPs(const matrix& vp, std::span<const matrix> models, std::span<matrix> mvps, std::span<float4> normals) {
+	assert(models.size() == mvps.size() && normals.size() == models.size() * 3);
+	detail::mvp(vp, models, (float*)mvps.data(), 16, (float*)normals.data(), 12);
+}
+/// Writes instance i at buffer + i * layout.stride
+inline void instanceMVPs(const matrix& vp, std::span<const matrix> models, void* buffer, const InstanceLayout& layout) {
+	assert(layout.stride % 4 == 0 && layout.mvp % 4 == 0 && (layout.normal == InstanceLayout::NONE || layout.normal % 4 == 0));
+	std::byte* b = (std::byte*)buffer;
+	detail::mvp(vp, models, (float*)(b + layout.mvp), layout.stride / 4,
+		layout.normal == InstanceLayout::NONE ? nullptr : (float*)(b + layout.normal), layout.stride / 4);
+}
+inline void instanceMVPs(Camera& camera, std::span<const matrix> models, std::span<matrix> mvps) {
+	instanceMVPs(camera.VP(), models, mvps);
+}
+inline void instanceMVPs(Camera& camera, std::span<const matrix> models, std::span<matrix> mvps, std::span<float4> normals) {
+	instanceMVPs(camera.VP(), models, mvps, normals);
+}
+inline void instanceMVPs(Camera& camera, std::span<const matrix> models, void* buffer, const InstanceLayout& layout) {
+	instanceMVPs(camera.VP(), models, buffer, layout);
+}
+
+/// out[i] = a[i] * b[i]. out may be a or b
+inline void multiply(std::span<const dmatrix> a, std::span<const dmatrix> b, std::span<dmatrix> out) {
+	assert(a.size() == b.size());
+	detail::dmul(a.data(), 16, b, out);
+}
+/// out[i] = a * b[i]. out may be b but must not contain a
+inline void multiply(const dmatrix& a, std::span<const dmatrix> b, std::span<dmatrix> out) {
+	detail::dmul(&a, 0, b, out);
+}
+/// out[i] = m * in[i]. out may be in
+inline void transform(const dmatrix& m, std::span<const double4> in, std::span<double4> out) {
+	assert(in.size() == out.size());
+	const std::size_t n = in.size();
+	parallel::forEach((n + detail::TRANSFORM_CHUNK - 1) / detail::TRANSFORM_CHUNK, [&](std::size_t c) {
+		const std::size_t begin = c * detail::TRANSFORM_CHUNK;
+		kernels::table().dtransform4(&m[0].x, (const double*)(in.data() + begin), (double*)(out.data() + begin),
+			std::min(detail::TRANSFORM_CHUNK, n - begin));
+	});
+}
+/// out[i] = in[i].inversed(). out may be in
+inline void inversedAll(std::span<const dmatrix> in, std::span<dmatrix> out) {
+	assert(in.size() == out.size());
+	detail::forEachDmatrixChunk(in.size(), [&](std::size_t begin, std::size_t count) {
+		kernels::table().dinverse((const double*)(in.data() + begin), (double*)(out.data() + begin), count);
+	});
+}
+/// out[i] = in[i].transposed(). out may be in
+inline void transposedAll(std::span<const dmatrix> in, std::span<dmatrix> out) {
+	assert(in.size() == out.size());
+	detail::forEachDmatrixChunk(in.size(), [&](std::size_t begin, std::size_t count) {
+		kernels::table().dtranspose((const double*)(in.data() + begin), (double*)(out.data() + begin), count);
+	});
+}
+/// v[i] = v[i].normalised()
+inline void normaliseAll(std::span<double4> v) {
+	detail::forEachDmatrixChunk(v.size(), [&](std::size_t begin, std::size_t count) {
+		kernels::table().dnormalise4((double*)(v.data() + begin), count);
+	});
+}
+
+/// out[i] = in[i] rounded to float
+inline void toFloat(std::span<const dmatrix> in, std::span<matrix> out) {
+	assert(in.size() == out.size());
+	kernels::table().toFloat((const double*)in.data(), (float*)out.data(), in.size() * 16);
+}
+inline void toFloat(std::span<const double4> in, std::span<float4> out) {
+	assert(in.size() == out.size());
+	kernels::table().toFloat((const double*)in.data(), (float*)out.data(), in.size() * 4);
+}
+inline void toFloat(std::span<const double3> in, std::span<float3> out) {
+	assert(in.size() == out.size());
+	kernels::table().toFloat((const double*)in.data(), (float*)out.data(), in.size() * 3);
+}
+/// out[i] = translate(-origin) * in[i] rounded to float
+inline void toFloat(std::span<const dmatrix> in, const double3& origin, std::span<matrix> out) {
+	assert(in.size() == out.size());
+	constexpr std::size_t BLOCK = 64;
+	const double4 o{origin.x, origin.y, origin.z, 0};
+	dmatrix rel[BLOCK];
+	for(std::size_t i = 0; i < in.size(); i += BLOCK) {
+		const std::size_t count = std::min(BLOCK, in.size() - i);
+		for(std::size_t k = 0; k < count; k++) {
+			const dmatrix& m = in[i + k];
+			for(int c = 0; c < 4; c++) rel[k].c[c] = m.c[c] - o * m.c[c].w;
+		}
+		toFloat(std::span<const dmatrix>(rel, count), out.subspan(i, count));
+	}
+}
+
+}
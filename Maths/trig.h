@@ -0,0 +1,271 @@
+#pragma once
+///
+///	Polynomial trigonometry for float in scalar and SIMD form.
+///
+/// The SIMD versions are templates over the register wrappers in simd.h
+/// (f32x4, f32x8, f32x16) so the batch kernels can use them at every width.
+/// The scalar float versions use the 4 wide code. The double overloads
+/// call the standard library. The scalar sincos, sin, cos and tan are
+/// constexpr and use the versions in constmath.h when constant evaluated.
+///
+/// Measured maximum error against the correctly rounded result (atan, asin
+/// and acos over every float):
+///
+///   sin, cos, sincos   2 ulp        |x| <= pi
+///                      1e-7 abs     |x| <= 8192  (near the zeros the ulp error is larger)
+///                      1e-6 abs     |x| <= 65536
+///                      1 ulp        |x| >  65536 (lanes use the standard library in double)
+///   tan                4 ulp        |x| <= 1.5
+///   atan, acos         2 ulp
+///   asin               3 ulp
+///   atan2              4 ulp
+///
+/// atan2(0, 0) returns 0 and atan2(+-inf, +-inf) returns +-pi/4 or +-3pi/4.
+///
+#include <cmath>
+#include <limits>
+#include <type_traits>
+#include "constmath.h"
+#include "simd.h"
+
+namespace maths::trig {
+/// See simd.h
+inline namespace MATHS_ISA {
+
+namespace detail {
+
+constexpr float PI_2 = 1.57079632679489661923f;
+constexpr float PI_4 = 0.78539816339744830962f;
+/// pi/2 - PI_2 and pi/4 - PI_4
+constexpr float PI_2_LO = (float)(1.57079632679489661923 - (double)PI_2);
+constexpr float PI_4_LO = (float)(0.78539816339744830962 - (double)PI_4);
+/// The Cody-Waite reduction in sincos is exact while q*1.5703125 is, ie.
+/// q < 2^16. Larger, inf and NaN lanes call the standard library instead
+constexpr float REDUCTION_LIMIT = 65536;
+
+/// t is a whole number. Mask of lanes where t is odd
+template<typename V>
+typename V::mask isOdd(V t) {
+	const V h = t * V::set1(0.5f);
+	return h != round(h);
+}
+template<typename V>
+V negateIf(typename V::mask m, V v) {
+	return select(m, -v, v);
+}
+/// atan of x in [-1, 1] after reduction. p(z) from Cephes atanf
+template<typename V>
+V atanPoly(V x) {
+	const V z = x * x;
+	V p = fmadd(V::set1(8.05374449538e-2f), z, V::set1(-1.38776856032e-1f));
+	p = fmadd(p, z, V::set1(1.99777106478e-1f));
+	p = fmadd(p, z, V::set1(-3.33329491539e-1f));
+	return fmadd(p * z, x, x);
+}
+/// asin of x in [0, 0.5]. p(z) from Cephes asinf
+template<typename V>
+V asinPoly(V x, V z) {
+	V p = fmadd(V::set1(4.2163199048e-2f), z, V::set1(2.4181311049e-2f));
+	p = fmadd(p, z, V::set1(4.5470025998e-2f));
+	p = fmadd(p, z, V::set1(7.4953002686e-2f));
+	p = fmadd(p, z, V::set1(1.6666752422e-1f));
+	return fmadd(p * z, x, x);
+}
+/// sincos of the lanes of x in far using std::sin and std::cos in double
+template<typename V>
+void sincosFar(V x, typename V::mask far, V& s, V& c) {
+	float xs[V::width], ss[V::width], cs[V::width];
+	x.store(xs);
+	s.store(ss);
+	c.store(cs);
+	const int lanes = bits(far);
+	for(int i = 0; i < V::width; i++) {
+		if(lanes & (1 << i)) {
+			ss[i] = (float)std::sin((double)xs[i]);
+			cs[i] = (float)std::cos((double)xs[i]);
+		}
+	}
+	s = V::load(ss);
+	c = V::load(cs);
+}
+
+}
+
+/// Sine and cosine of x in one call
+template<typename V>
+void sincos(V x, V& s, V& c) {
+	/// Reduce to r in [-pi/4, pi/4] where x = q*pi/2 + r.
+	/// pi/2 is split into 3 parts so that q*part is exact (Cody-Waite)
+	const V q = round(x * V::set1(0.63661977236758134f));
+	V r = fmadd(q, V::set1(-1.5703125f), x);
+	r = fmadd(q, V::set1(-4.837512969970703125e-4f), r);
+	r = fmadd(q, V::set1(-7.54978995489188216e-8f), r);
+
+	const V z = r * r;
+
+	/// Cephes sinf / cosf polynomials
+	V ps = fmadd(V::set1(-1.9515295891e-4f), z, V::set1(8.3321608736e-3f));
+	ps = fmadd(ps, z, V::set1(-1.6666654611e-1f));
+	ps = fmadd(ps * z, r, r);
+
+	V pc = fmadd(V::set1(2.443315711809948e-5f), z, V::set1(-1.388731625493765e-3f));
+	pc = fmadd(pc, z, V::set1(4.166664568298827e-2f));
+	pc = fmadd(pc * z, z, fmadd(V::set1(-0.5f), z, V::set1(1)));
+
+	/// Quadrant n = q mod 4
+	///   sin = [ s,  c, -s, -c][n]
+	///   cos = [ c, -s, -c,  s][n]
+	const auto odd = detail::isOdd(q);
+	const V half = select(odd, q - V::set1(1), q) * V::set1(0.5f);
+	const V halfPlus = select(odd, q + V::set1(1), q) * V::set1(0.5f);
+	const auto sinNeg = detail::isOdd(half);
+	const auto cosNeg = detail::isOdd(halfPlus);
+
+	s = detail::negateIf(sinNeg, select(odd, pc, ps));
+	c = detail::negateIf(cosNeg, select(odd, ps, pc));
+
+	const auto far = ~(abs(x) <= V::set1(detail::REDUCTION_LIMIT));
+	if(bits(far)) detail::sincosFar(x, far, s, c);
+}
+template<typename V>
+V sin(V x) {
+	V s, c;
+	sincos(x, s, c);
+	return s;
+}
+template<typename V>
+V cos(V x) {
+	V s, c;
+	sincos(x, s, c);
+	return c;
+}
+template<typename V>
+V tan(V x) {
+	V s, c;
+	sincos(x, s, c);
+	return s / c;
+}
+template<typename V>
+V atan(V x) {
+	const V a = abs(x);
+	const auto big = a > V::set1(2.414213562373095f);	/// tan(3pi/8)
+	const auto mid = a > V::set1(0.4142135623730950f);	/// tan(pi/8)
+
+	const V r = select(big, V::set1(-1) / a, select(mid, (a - V::set1(1)) / (a + V::set1(1)), a));
+	const V offset = select(big, V::set1(detail::PI_2), select(mid, V::set1(detail::PI_4), V::zero()));
+	/// The rounding error of the float offset is added to the polynomial first
+	const V offsetLo = select(big, V::set1(detail::PI_2_LO), select(mid, V::set1(detail::PI_4_LO), V::zero()));
+
+	return (offset + (detail::atanPoly(r) + offsetLo)) ^ sign(x);
+}
+template<typename V>
+V atan2(V y, V x) {
+	const V pi = V::set1(2 * detail::PI_2);
+	/// y / x is NaN if both are infinite. Use +-1 / +-1 instead
+	const V inf = V::set1(std::numeric_limits<float>::infinity());
+	const auto bothInf = (abs(x) == inf) & (abs(y) == inf);
+	x = select(bothInf, V::set1(1) ^ sign(x), x);
+	y = select(bothInf, V::set1(1) ^ sign(y), y);
+	V r = atan(y / x);
+	/// Left half plane
+	r = select(x < V::zero(), r + (pi ^ sign(y)), r);
+	/// On the y axis
+	const V axis = select(y == V::zero(), V::zero(), V::set1(detail::PI_2) ^ sign(y));
+	return select(x == V::zero(), axis, r);
+}
+template<typename V>
+V asin(V x) {
+	const V a = abs(x);
+	const auto big = a > V::set1(0.5f);
+	/// asin(a) = pi/2 - 2*asin(sqrt((1-a)/2)) for a > 0.5
+	const V z = select(big, (V::set1(1) - a) * V::set1(0.5f), a * a);
+	const V t = select(big, sqrt(z), a);
+	const V p = detail::asinPoly(t, z);
+	const V r = select(big, V::set1(detail::PI_2) - (p + p), p);
+	return r ^ sign(x);
+}
+template<typename V>
+V acos(V x) {
+	const V a = abs(x);
+	const auto big = a > V::set1(0.5f);
+	const V z = select(big, (V::set1(1) - a) * V::set1(0.5f), a * a);
+	const V t = select(big, sqrt(z), a);
+	const V p = detail::asinPoly(t, z);
+	/// |x| <= 0.5 : pi/2 - asin(x)
+	///  x >  0.5 : 2*asin(sqrt((1-x)/2))
+	///  x < -0.5 : pi - 2*asin(sqrt((1+x)/2))
+	const V small = V::set1(detail::PI_2) - (p ^ sign(x));
+	const V twice = p + p;
+	return select(big, select(x < V::zero(), V::set1(2 * detail::PI_2) - twice, twice), small);
+}
+
+namespace detail {
+inline void sincos4(float x, float& s, float& c) {
+	simd::f32x4 vs, vc;
+	sincos(simd::f32x4{_mm_set1_ps(x)}, vs, vc);
+	s = _mm_cvtss_f32(vs.v);
+	c = _mm_cvtss_f32(vc.v);
+}
+}
+
+/// Scalar float versions. sincos, sin, cos and tan use cx:: when constant evaluated
+constexpr void sincos(float x, float& s, float& c) {
+	if(std::is_constant_evaluated()) cx::sincos(x, s, c);
+	else detail::sincos4(x, s, c);
+}
+constexpr float sin(float x) {
+	if(std::is_constant_evaluated()) return cx::sin(x);
+	return _mm_cvtss_f32(sin(simd::f32x4{_mm_set1_ps(x)}).v);
+}
+constexpr float cos(float x) {
+	if(std::is_constant_evaluated()) return cx::cos(x);
+	return _mm_cvtss_f32(cos(simd::f32x4{_mm_set1_ps(x)}).v);
+}
+constexpr float tan(float x) {
+	if(std::is_constant_evaluated()) return cx::tan(x);
+	return _mm_cvtss_f32(tan(simd::f32x4{_mm_set1_ps(x)}).v);
+}
+inline float atan(float x) { return _mm_cvtss_f32(atan(simd::f32x4{_mm_set1_ps(x)}).v); }
+inline float atan2(float y, float x) { return _mm_cvtss_f32(atan2(simd::f32x4{_mm_set1_ps(y)}, simd::f32x4{_mm_set1_ps(x)}).v); }
+inline float asin(float x) { return _mm_cvtss_f32(asin(simd::f32x4{_mm_set1_ps(x)}).v); }
+inline float acos(float x) { return _mm_cvtss_f32(acos(simd::f32x4{_mm_set1_ps(x)}).v); }
+
+/// Scalar double versions
+constexpr void sincos(double x, double& s, double& c) {
+	if(std::is_constant_evaluated()) {
+		cx::sincos(x, s, c);
+	} else {
+		s = std::sin(x);
+		c = std::cos(x);
+	}
+}
+constexpr double sin(double x) {
+	if(std::is_constant_evaluated()) return cx::sin(x);
+	return std::sin(x);
+}
+constexpr double cos(double x) {
+	if(std::is_constant_evaluated()) return cx::cos(x);
+	return std::cos(x);
+}
+constexpr double tan(double x) {
+	if(std::is_constant_evaluated()) return cx::tan(x);
+	return std::tan(x);
+}
+inline double atan(double x) { return std::atan(x); }
+inline double atan2(double y, double x) { return std::atan2(y, x); }
+inline double asin(double x) { return std::asin(x); }
+inline double acos(double x) { return std::acos(x); }
+
+/// Other scalar types
+template<typename T> requires std::is_arithmetic_v<T>
+constexpr void sincos(T x, T& s, T& c) {
+	double ds = 0, dc = 0;
+	sincos((double)x, ds, dc);
+	s = (T)ds;
+	c = (T)dc;
+}
+template<typename T> requires std::is_arithmetic_v<T>
+constexpr T tan(T x) { return (T)tan((double)x); }
+
+}
+}
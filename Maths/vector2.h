@@ -22,10 +22,7 @@ struct vector2 final {
     /// unordered_map<float2,value,float2::HashFunc> mymap;
     struct HashFunc {
         std::size_t operator()(const vector2& k) const {
-            std::size_t a = 5381;
-            a  = ((a << 7))  + (std::size_t)k.x;
-            a ^= ((a << 13)) + (std::size_t)k.y;
-            return a;
+            return hash::values(k.x, k.y);
         }
     };
 
@@ -129,24 +126,38 @@ struct vector2 final {
         return !(this < o);
     }
 
-    constexpr bool anyEQ(T v) const { return x==v || y==v; }
-	constexpr bool anyLT(T v) const { return x<v || y<v; }
-	constexpr bool anyLTE(T v) const { return x <= v || y <= v; }
-	constexpr bool anyGT(T v) const { return x>v || y>v; }
-	constexpr bool anyGTE(T v) const { return x >= v || y >= v; }
-	constexpr bool anyLT(const vector2& v) const { return x<v.x || y<v.y; }
-	constexpr bool anyLTE(const vector2& v) const { return x <= v.x || y <= v.y; }
-	constexpr bool anyGT(const vector2& v) const { return x>v.x || y>v.y; }
-	constexpr bool anyGTE(const vector2& v) const { return x >= v.x || y >= v.y; }
-
-	constexpr bool allLT(T v) const { return x<v && y<v; }
-	constexpr bool allLTE(T v) const { return x <= v && y <= v; }
-	constexpr bool allGT(T v) const { return x>v && y>v; }
-	constexpr bool allGTE(T v) const { return x >= v && y >= v; }
-	constexpr bool allLT(const vector2& v) const { return x<v.x && y<v.y; }
-	constexpr bool allLTE(const vector2& v) const { return x <= v.x && y <= v.y; }
-	constexpr bool allGT(const vector2& v) const { return x>v.x && y>v.y; }
-	constexpr bool allGTE(const vector2& v) const { return x >= v.x && y >= v.y; }
+	/// Per component comparisons. Bit i of the result is set if component i passes
+	constexpr unsigned maskEQ(T v) const { return unsigned(x == v) | unsigned(y == v) << 1; }
+	constexpr unsigned maskNEQ(T v) const { return unsigned(x != v) | unsigned(y != v) << 1; }
+	constexpr unsigned maskLT(T v) const { return unsigned(x < v) | unsigned(y < v) << 1; }
+	constexpr unsigned maskLTE(T v) const { return unsigned(x <= v) | unsigned(y <= v) << 1; }
+	constexpr unsigned maskGT(T v) const { return unsigned(x > v) | unsigned(y > v) << 1; }
+	constexpr unsigned maskGTE(T v) const { return unsigned(x >= v) | unsigned(y >= v) << 1; }
+	constexpr unsigned maskEQ(const vector2& v) const { return unsigned(x == v.x) | unsigned(y == v.y) << 1; }
+	constexpr unsigned maskNEQ(const vector2& v) const { return unsigned(x != v.x) | unsigned(y != v.y) << 1; }
+	constexpr unsigned maskLT(const vector2& v) const { return unsigned(x < v.x) | unsigned(y < v.y) << 1; }
+	constexpr unsigned maskLTE(const vector2& v) const { return unsigned(x <= v.x) | unsigned(y <= v.y) << 1; }
+	constexpr unsigned maskGT(const vector2& v) const { return unsigned(x > v.x) | unsigned(y > v.y) << 1; }
+	constexpr unsigned maskGTE(const vector2& v) const { return unsigned(x >= v.x) | unsigned(y >= v.y) << 1; }
+
+	constexpr bool anyEQ(T v) const { return maskEQ(v) != 0; }
+	constexpr bool anyLT(T v) const { return maskLT(v) != 0; }
+	constexpr bool anyLTE(T v) const { return maskLTE(v) != 0; }
+	constexpr bool anyGT(T v) const { return maskGT(v) != 0; }
+	constexpr bool anyGTE(T v) const { return maskGTE(v) != 0; }
+	constexpr bool anyLT(const vector2& v) const { return maskLT(v) != 0; }
+	constexpr bool anyLTE(const vector2& v) const { return maskLTE(v) != 0; }
+	constexpr bool anyGT(const vector2& v) const { return maskGT(v) != 0; }
+	constexpr bool anyGTE(const vector2& v) const { return maskGTE(v) != 0; }
+
+	constexpr bool allLT(T v) const { return maskLT(v) == 0x3; }
+	constexpr bool allLTE(T v) const { return maskLTE(v) == 0x3; }
+	constexpr bool allGT(T v) const { return maskGT(v) == 0x3; }
+	constexpr bool allGTE(T v) const { return maskGTE(v) == 0x3; }
+	constexpr bool allLT(const vector2& v) const { return maskLT(v) == 0x3; }
+	constexpr bool allLTE(const vector2& v) const { return maskLTE(v) == 0x3; }
+	constexpr bool allGT(const vector2& v) const { return maskGT(v) == 0x3; }
+	constexpr bool allGTE(const vector2& v) const { return maskGTE(v) == 0x3; }
 
 	constexpr T hadd() const { return x + y; }
 	constexpr T hmul() const { return x * y; }
@@ -158,41 +169,75 @@ struct vector2 final {
 		return { (T)::ceil(x), (T)::ceil(y) };
 	}
 
-	T min() const { return x<y ? x : y; }
-	T max() const { return x>y ? x : y; }
+	constexpr T min() const { return x<y ? x : y; }
+	constexpr T max() const { return x>y ? x : y; }
 
-	vector2 min(const vector2& o) const {
+	constexpr vector2 min(const vector2& o) const {
 		return {x<o.x ? x : o.x, y<o.y ? y : o.y };
 	}
-	vector2 max(const vector2& o) const {
+	constexpr vector2 max(const vector2& o) const {
 		return {x>o.x ? x : o.x, y>o.y ? y : o.y};
 	}
+	constexpr vector2 clamp(const vector2& lo, const vector2& hi) const {
+		return max(lo).min(hi);
+	}
+	constexpr vector2 clamp(T lo, T hi) const {
+		return clamp(vector2{lo, lo}, vector2{hi, hi});
+	}
+	/// Clamp to [0, 1]
+	constexpr vector2 saturate() const {
+		return clamp(T(0), T(1));
+	}
+	/// 0 where the component is less than edge, otherwise 1
+	constexpr vector2 step(const vector2& edge) const {
+		return {T(x >= edge.x), T(y >= edge.y)};
+	}
+	constexpr vector2 step(T edge) const {
+		return {T(x >= edge), T(y >= edge)};
+	}
 
-	T dot(const vector2& o) const {
+	constexpr T dot(const vector2& o) const {
 		return {x*o.x + y*o.y};
 	}
 
-	T length() const {
-		return sqrt(lengthSquared());
-	}
-	T lengthSquared() const {
+	template<Precision P = Precision::Precise>
+	constexpr T length() const {
+		if constexpr(P == Precision::Fast) {
+			return fast::sqrt(lengthSquared());
+		} else {
+			return sqrt(lengthSquared());
+		}
+	}
+	constexpr T lengthSquared() const {
 		return x*x + y*y;
 	}
-	T invLength() const {
-		return 1 / length();
+	template<Precision P = Precision::Precise>
+	constexpr T invLength() const {
+		if constexpr(P == Precision::Fast) {
+			return fast::rsqrt(lengthSquared());
+		} else {
+			return 1 / length();
+		}
 	}
 
-	auto& normalise() {
-		operator*=(invLength());
+	template<Precision P = Precision::Precise>
+	constexpr auto& normalise() {
+		operator*=(invLength<P>());
 		return *this;
 	}
-	vector2 normalised() const {
-		return operator*(invLength());
+	template<Precision P = Precision::Precise>
+	constexpr vector2 normalised() const {
+		return operator*(invLength<P>());
 	}
 
 	/// Returns 1/this
-	vector2 reciprocal() const {
-		return  {1 / x, 1 / y};
+	template<Precision P = Precision::Precise>
+	constexpr vector2 reciprocal() const {
+		if constexpr(P == Precision::Fast) {
+			return {fast::rcp(x), fast::rcp(y)};
+		} else {
+			return {1 / x, 1 / y};
+		}
 	}
 
 	vector2 abs() const {
@@ -201,15 +246,20 @@ struct vector2 final {
 
 	/// Return the angle between this and vector v in radians.
 	/// rad = acos(|v1|.|v2|)
+	template<Precision P = Precision::Precise>
 	T angleTo(const vector2& v) const {
-		return (T)acos(normalised().dot(v.normalised()));
+		if constexpr(P == Precision::Fast) {
+			return fast::acos(dot(v) * fast::rsqrt(lengthSquared()) * fast::rsqrt(v.lengthSquared()));
+		} else {
+			return (T)acos(normalised().dot(v.normalised()));
+		}
 	}
 
 	/// returns a new vector2 which is perpendicular to this one (pointing to the left)
-	vector2 left() const {
+	constexpr vector2 left() const {
 		return {-y, x};
 	}
-	vector2 right() const {
+	constexpr vector2 right() const {
 		return {y,-x};
 	}
 
@@ -240,6 +290,12 @@ struct vector2 final {
     }
 };
 
+/// Component i is taken from a if bit i of mask is set, otherwise from b
+template<typename T>
+constexpr vector2<T> select(unsigned mask, const vector2<T>& a, const vector2<T>& b) {
+	return {(mask & 1) ? a.x : b.x, (mask & 2) ? a.y : b.y};
+}
+
 typedef vector2<int> int2;
 typedef vector2<unsigned int> uint2;
 typedef vector2<float> float2;
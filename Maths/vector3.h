@@ -33,21 +33,19 @@ struct vector3 final {
     /// unordered_map<int3,value,int3::HashFunc> mymap;
     struct HashFunc {
         std::size_t operator()(const vector3& k) const {
-            std::size_t a = 5381;
-            a  = ((a << 7))  + (std::size_t)k.x;
-            a ^= ((a << 13)) + (std::size_t)k.y;
-            a  = ((a << 19)) + (std::size_t)k.z;
-            return a;
+            return hash::values(k.x, k.y, k.z);
         }
     };
 
 	constexpr T& operator[](unsigned int index) {
 		assert(index<3);
+		if(std::is_constant_evaluated()) return index == 0 ? x : index == 1 ? y : z;
 		T* p = (&x) + index;
 		return *p;
 	}
 	constexpr T operator[](unsigned int index) const {
 		assert(index<3);
+		if(std::is_constant_evaluated()) return index == 0 ? x : index == 1 ? y : z;
 		const T* p = (&x) + index;
 		return *p;
 	}
@@ -144,24 +142,38 @@ struct vector3 final {
         return !(this < o);
     }
 
-    constexpr bool anyEQ(T v) const { return x==v || y==v || z==v; }
-	constexpr bool anyLT(T v) const { return x<v || y<v || z<v; }
-	constexpr bool anyLTE(T v) const { return x <= v || y <= v || z <= v; }
-	constexpr bool anyGT(T v) const { return x>v || y>v || z>v; }
-	constexpr bool anyGTE(T v) const { return x >= v || y >= v || z>= v; }
-	constexpr bool anyLT(const vector3& v) const { return x<v.x || y<v.y || z<v.z; }
-	constexpr bool anyLTE(const vector3& v) const { return x <= v.x || y <= v.y || z<= v.z; }
-	constexpr bool anyGT(const vector3& v) const { return x>v.x || y>v.y || z>v.z; }
-	constexpr bool anyGTE(const vector3& v) const { return x >= v.x || y >= v.y || z >= v.z; }
-
-	constexpr bool allLT(T v) const { return x<v && y<v && z<v; }
-	constexpr bool allLTE(T v) const { return x <= v && y <= v && z <= v; }
-	constexpr bool allGT(T v) const { return x>v && y>v && z>v; }
-	constexpr bool allGTE(T v) const { return x >= v && y >= v && z >= v; }
-	constexpr bool allLT(const vector3& v) const { return x<v.x && y<v.y && z<v.z; }
-	constexpr bool allLTE(const vector3& v) const { return x <= v.x && y <= v.y && z <= v.z; }
-	constexpr bool allGT(const vector3& v) const { return x>v.x && y>v.y && z>v.z; }
-	constexpr bool allGTE(const vector3& v) const { return x >= v.x && y >= v.y && z >= v.z; }
+	/// Per component comparisons. Bit i of the result is set if component i passes
+	constexpr unsigned maskEQ(T v) const { return unsigned(x == v) | unsigned(y == v) << 1 | unsigned(z == v) << 2; }
+	constexpr unsigned maskNEQ(T v) const { return unsigned(x != v) | unsigned(y != v) << 1 | unsigned(z != v) << 2; }
+	constexpr unsigned maskLT(T v) const { return unsigned(x < v) | unsigned(y < v) << 1 | unsigned(z < v) << 2; }
+	constexpr unsigned maskLTE(T v) const { return unsigned(x <= v) | unsigned(y <= v) << 1 | unsigned(z <= v) << 2; }
+	constexpr unsigned maskGT(T v) const { return unsigned(x > v) | unsigned(y > v) << 1 | unsigned(z > v) << 2; }
+	constexpr unsigned maskGTE(T v) const { return unsigned(x >= v) | unsigned(y >= v) << 1 | unsigned(z >= v) << 2; }
+	constexpr unsigned maskEQ(const vector3& v) const { return unsigned(x == v.x) | unsigned(y == v.y) << 1 | unsigned(z == v.z) << 2; }
+	constexpr unsigned maskNEQ(const vector3& v) const { return unsigned(x != v.x) | unsigned(y != v.y) << 1 | unsigned(z != v.z) << 2; }
+	constexpr unsigned maskLT(const vector3& v) const { return unsigned(x < v.x) | unsigned(y < v.y) << 1 | unsigned(z < v.z) << 2; }
+	constexpr unsigned maskLTE(const vector3& v) const { return unsigned(x <= v.x) | unsigned(y <= v.y) << 1 | unsigned(z <= v.z) << 2; }
+	constexpr unsigned maskGT(const vector3& v) const { return unsigned(x > v.x) | unsigned(y > v.y) << 1 | unsigned(z > v.z) << 2; }
+	constexpr unsigned maskGTE(const vector3& v) const { return unsigned(x >= v.x) | unsigned(y >= v.y) << 1 | unsigned(z >= v.z) << 2; }
+
+	constexpr bool anyEQ(T v) const { return maskEQ(v) != 0; }
+	constexpr bool anyLT(T v) const { return maskLT(v) != 0; }
+	constexpr bool anyLTE(T v) const { return maskLTE(v) != 0; }
+	constexpr bool anyGT(T v) const { return maskGT(v) != 0; }
+	constexpr bool anyGTE(T v) const { return maskGTE(v) != 0; }
+	constexpr bool anyLT(const vector3& v) const { return maskLT(v) != 0; }
+	constexpr bool anyLTE(const vector3& v) const { return maskLTE(v) != 0; }
+	constexpr bool anyGT(const vector3& v) const { return maskGT(v) != 0; }
+	constexpr bool anyGTE(const vector3& v) const { return maskGTE(v) != 0; }
+
+	constexpr bool allLT(T v) const { return maskLT(v) == 0x7; }
+	constexpr bool allLTE(T v) const { return maskLTE(v) == 0x7; }
+	constexpr bool allGT(T v) const { return maskGT(v) == 0x7; }
+	constexpr bool allGTE(T v) const { return maskGTE(v) == 0x7; }
+	constexpr bool allLT(const vector3& v) const { return maskLT(v) == 0x7; }
+	constexpr bool allLTE(const vector3& v) const { return maskLTE(v) == 0x7; }
+	constexpr bool allGT(const vector3& v) const { return maskGT(v) == 0x7; }
+	constexpr bool allGTE(const vector3& v) const { return maskGTE(v) == 0x7; }
 
 	constexpr T hadd() const { return x + y + z; }
 	constexpr T hmul() const { return x * y * z; }
@@ -173,51 +185,85 @@ struct vector3 final {
 		return {(T)::ceil(x), (T)::ceil(y), (T)::ceil(z)};
 	}
 
-	T min() const { return std::min({x, y, z}); }
-	T max() const { return std::max({x, y, z}); }
+	constexpr T min() const { return std::min({x, y, z}); }
+	constexpr T max() const { return std::max({x, y, z}); }
 
-	vector3 min(const vector3& o) const {
+	constexpr vector3 min(const vector3& o) const {
 		return {std::min(x, o.x), std::min(y, o.y), std::min(z, o.z)};
 	}
-	vector3 max(const vector3& o) const {
+	constexpr vector3 max(const vector3& o) const {
 		return {std::max(x, o.x), std::max(y, o.y), std::max(z, o.z)};
 	}
+	constexpr vector3 clamp(const vector3& lo, const vector3& hi) const {
+		return max(lo).min(hi);
+	}
+	constexpr vector3 clamp(T lo, T hi) const {
+		return clamp(vector3{lo, lo, lo}, vector3{hi, hi, hi});
+	}
+	/// Clamp to [0, 1]
+	constexpr vector3 saturate() const {
+		return clamp(T(0), T(1));
+	}
+	/// 0 where the component is less than edge, otherwise 1
+	constexpr vector3 step(const vector3& edge) const {
+		return {T(x >= edge.x), T(y >= edge.y), T(z >= edge.z)};
+	}
+	constexpr vector3 step(T edge) const {
+		return {T(x >= edge), T(y >= edge), T(z >= edge)};
+	}
 
-	T dot(const vector3& o) const {
+	constexpr T dot(const vector3& o) const {
 		return {x*o.x + y*o.y + z*o.z};
 	}
-	T length() const {
-		return sqrt(lengthSquared());
+	template<Precision P = Precision::Precise>
+	constexpr T length() const {
+		if constexpr(P == Precision::Fast) {
+			return fast::sqrt(lengthSquared());
+		} else {
+			return sqrt(lengthSquared());
+		}
 	}
-	T lengthSquared() const {
+	constexpr T lengthSquared() const {
 		return x * x + y * y + z * z;
 	}
-	T invLength() const {
-		return 1 / length();
+	template<Precision P = Precision::Precise>
+	constexpr T invLength() const {
+		if constexpr(P == Precision::Fast) {
+			return fast::rsqrt(lengthSquared());
+		} else {
+			return 1 / length();
+		}
 	}
 
-	auto& normalise() {
-		operator*=(invLength());
+	template<Precision P = Precision::Precise>
+	constexpr auto& normalise() {
+		operator*=(invLength<P>());
 		return *this;
 	}
-	vector3 normalised() const {
-		return operator*(invLength());
+	template<Precision P = Precision::Precise>
+	constexpr vector3 normalised() const {
+		return operator*(invLength<P>());
 	}
 
 	/// Returns 1/this
-	vector3 reciprocal() const {
-		return  {1 / x, 1 / y, 1 / z};
+	template<Precision P = Precision::Precise>
+	constexpr vector3 reciprocal() const {
+		if constexpr(P == Precision::Fast) {
+			return {fast::rcp(x), fast::rcp(y), fast::rcp(z)};
+		} else {
+			return {1 / x, 1 / y, 1 / z};
+		}
 	}
 
 	/// U.cross(V).length == U.length * V.length * sin(a)
 	/// where a is the angle between U amd V
-	vector3 cross(const vector3& rhs) const {
+	constexpr vector3 cross(const vector3& rhs) const {
 		return {y*rhs.z - z*rhs.y,
 				z*rhs.x - x*rhs.z,
 				x*rhs.y - y*rhs.x};
 	}
 	/// Scalar triple product (this cross a) dot b
-	T tripleProduct(const vector3& a, const vector3& b) const {
+	constexpr T tripleProduct(const vector3& a, const vector3& b) const {
 		return cross(a).dot(b);
 	}
 
@@ -236,20 +282,29 @@ struct vector3 final {
 
 	/// Return the angle between this and vector v in radians.
 	/// v1.v2 / (|v1|.|v2|)
+	template<Precision P = Precision::Precise>
 	T angleTo(const vector3& v) const {
-		return (T)acos((dot(v) / (length() * v.length())));
+		if constexpr(P == Precision::Fast) {
+			return fast::acos(dot(v) * fast::rsqrt(lengthSquared()) * fast::rsqrt(v.lengthSquared()));
+		} else {
+			return (T)acos((dot(v) / (length() * v.length())));
+		}
 	}
 
+	/// sin and cos are taken in double for integer T so they are not truncated
+	using Real = std::conditional_t<std::is_floating_point<T>::value, T, double>;
+
 	/// Rotate by radians toward vector v
 	void rotateTowards(const vector3& v, T radians) {
 		this = rotatedTowards(v, radians);
 	}
 	/// Returns new vector3 rotated by radians toward vector v
-	vector3 rotatedTowards(const vector3& v, T radians) const {
+	constexpr vector3 rotatedTowards(const vector3& v, T radians) const {
 		auto v1 = left(v);
 		auto v2 = cross(v1);
-		auto v3 = normalised() * (T)cos(radians) +
-			   v2.normalised() * (T)sin(radians);
+		Real s, c;
+		trig::sincos((Real)radians, s, c);
+		auto v3 = normalised() * (T)c + v2.normalised() * (T)s;
 		return v3 * length();
 	}
 
@@ -257,39 +312,39 @@ struct vector3 final {
 	///  same origin ie (0,0,0).
 	///  If result is positive then point is in front of
 	///  the plane else it is behind it.
-	T distanceFromPlane(const vector3& v1, const vector3& v2) const {
+	constexpr T distanceFromPlane(const vector3& v1, const vector3& v2) const {
 		const auto normal = v2.cross(v1).normalised();
 		return normal.dot(*this);
 	}
 
-	vector3 rotatedAroundX(T radians) const {
-		auto c = cos(radians);
-		auto s = sin(radians);
+	constexpr vector3 rotatedAroundX(T radians) const {
+		Real s, c;
+		trig::sincos((Real)radians, s, c);
 		auto yy = y;
 		auto zz = z;
 		return {x, (T)(yy*c - zz * s), (T)(yy*s + zz * c)};
 	}
-	vector3 rotatedAroundY(T radians) const {
-		auto c = cos(radians);
-		auto s = sin(radians);
+	constexpr vector3 rotatedAroundY(T radians) const {
+		Real s, c;
+		trig::sincos((Real)radians, s, c);
 		auto xx = x;
 		auto zz = z;
 		return {(T)(xx*c + zz * s), y, (T)(-xx * s + zz * c)};
 	}
-	vector3 rotatedAroundZ(T radians) const {
-		auto c = cos(radians);
-		auto s = sin(radians);
+	constexpr vector3 rotatedAroundZ(T radians) const {
+		Real s, c;
+		trig::sincos((Real)radians, s, c);
 		auto xx = x;
 		auto yy = y;
 		return {(T)(xx*c - yy * s), (T)(xx*s + yy * c), z};
 	}
 
 	/// Returns a new vector3 which is perpendicular to this and a.
-	vector3 left(const vector3& a) const {
+	constexpr vector3 left(const vector3& a) const {
 		return -cross(a);
 	}
 	/// Returns a new vector3 which is perpendicular to this and a (opposite to left).
-	vector3 right(const vector3& a) const {
+	constexpr vector3 right(const vector3& a) const {
 		return cross(a);
 	}
 
@@ -320,6 +375,12 @@ struct vector3 final {
 	}
 };
 
+/// Component i is taken from a if bit i of mask is set, otherwise from b
+template<typename T>
+constexpr vector3<T> select(unsigned mask, const vector3<T>& a, const vector3<T>& b) {
+	return {(mask & 1) ? a.x : b.x, (mask & 2) ? a.y : b.y, (mask & 4) ? a.z : b.z};
+}
+
 typedef vector3<int> int3;
 typedef vector3<unsigned int> uint3;
 typedef vector3<float> float3;
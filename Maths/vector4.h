@@ -4,13 +4,63 @@
 /// Add more types as needed.
 ///
 #include <algorithm>
+#include <type_traits>
+#include <emmintrin.h>
 
 namespace maths {
 
 template<typename T> struct matrix4;
 
+namespace detail {
+///
+/// 4 doubles in two SSE2 registers. Used by double4 and dmatrix when not
+/// constant evaluated. hadd() adds (x + z) + (y + w).
+///
+/// This is always SSE2, whatever the translation unit is compiled for, so
+/// that double4 and dmatrix are the same in every translation unit. The
+/// 256 bit AVX versions are the batch multiply(), transform(), inversedAll(),
+/// transposedAll() and normaliseAll() in transform.h, which use the runtime
+/// selected kernels.
+///
+struct f64x4 final {
+	__m128d lo, hi;
+
+	static f64x4 load(const double* p) { return {_mm_load_pd(p), _mm_load_pd(p + 2)}; }
+	static f64x4 set1(double d) { return {_mm_set1_pd(d), _mm_set1_pd(d)}; }
+	static f64x4 setr(double a, double b, double c, double d) { return {_mm_setr_pd(a, b), _mm_setr_pd(c, d)}; }
+	void store(double* p) const { _mm_store_pd(p, lo); _mm_store_pd(p + 2, hi); }
+
+	f64x4 operator-() const { return {_mm_xor_pd(lo, _mm_set1_pd(-0.0)), _mm_xor_pd(hi, _mm_set1_pd(-0.0))}; }
+	f64x4 operator+(f64x4 o) const { return {_mm_add_pd(lo, o.lo), _mm_add_pd(hi, o.hi)}; }
+	f64x4 operator-(f64x4 o) const { return {_mm_sub_pd(lo, o.lo), _mm_sub_pd(hi, o.hi)}; }
+	f64x4 operator*(f64x4 o) const { return {_mm_mul_pd(lo, o.lo), _mm_mul_pd(hi, o.hi)}; }
+	f64x4 operator/(f64x4 o) const { return {_mm_div_pd(lo, o.lo), _mm_div_pd(hi, o.hi)}; }
+	f64x4 min(f64x4 o) const { return {_mm_min_pd(lo, o.lo), _mm_min_pd(hi, o.hi)}; }
+	f64x4 max(f64x4 o) const { return {_mm_max_pd(lo, o.lo), _mm_max_pd(hi, o.hi)}; }
+	f64x4 sqrt() const { return {_mm_sqrt_pd(lo), _mm_sqrt_pd(hi)}; }
+	f64x4 abs() const { return {_mm_andnot_pd(_mm_set1_pd(-0.0), lo), _mm_andnot_pd(_mm_set1_pd(-0.0), hi)}; }
+	/// Bit i is set if lane i equals lane i of o
+	unsigned maskEQ(f64x4 o) const {
+		return (unsigned)(_mm_movemask_pd(_mm_cmpeq_pd(lo, o.lo)) | _mm_movemask_pd(_mm_cmpeq_pd(hi, o.hi)) << 2);
+	}
+	double hadd() const {
+		const __m128d t = _mm_add_pd(lo, hi);
+		return _mm_cvtsd_f64(_mm_add_sd(t, _mm_unpackhi_pd(t, t)));
+	}
+	/// In-register transpose of the 4x4 matrix whose rows are a, b, c and d
+	static void transpose(f64x4& a, f64x4& b, f64x4& c, f64x4& d) {
+		const f64x4 ta = a, tb = b;
+		a = {_mm_unpacklo_pd(ta.lo, tb.lo), _mm_unpacklo_pd(c.lo, d.lo)};
+		b = {_mm_unpackhi_pd(ta.lo, tb.lo), _mm_unpackhi_pd(c.lo, d.lo)};
+		const f64x4 tc = c;
+		c = {_mm_unpacklo_pd(ta.hi, tb.hi), _mm_unpacklo_pd(tc.hi, d.hi)};
+		d = {_mm_unpackhi_pd(ta.hi, tb.hi), _mm_unpackhi_pd(tc.hi, d.hi)};
+	}
+};
+}
+
 template<typename T>
-struct vector4 final {
+struct alignas(std::is_same_v<T, double> ? 16 : alignof(T)) vector4 final {
 	static_assert(std::is_arithmetic<T>::value);
 
 	T x = 0, y = 0, z = 0, w = 0;
@@ -19,55 +69,81 @@ struct vector4 final {
 	/// Copy constructors
     template<typename S>
 	constexpr vector4(const vector4<S>& i) : x(T(i.x)), y(T(i.y)), z(T(i.z)), w(T(i.w)) {}
+	explicit vector4(detail::f64x4 v) requires std::is_same_v<T, double> { v.store(&x); }
+	detail::f64x4 f64() const requires std::is_same_v<T, double> { return detail::f64x4::load(&x); }
 
     /// unordered_map<float4,value,float4::HashFunc> mymap;
     struct HashFunc {
         std::size_t operator()(const vector4& k) const {
-            std::size_t a = 5381;
-            a  = ((a << 7))  + (std::size_t)k.x;
-            a ^= ((a << 13)) + (std::size_t)k.y;
-            a  = ((a << 19)) + (std::size_t)k.z;
-            a ^= ((a << 23)) + (std::size_t)k.w;
-            return a;
+            return hash::values(k.x, k.y, k.z, k.w);
         }
     };
 
 	constexpr T& operator[](unsigned int index) { 
 		assert(index<4);
+		if(std::is_constant_evaluated()) return index == 0 ? x : index == 1 ? y : index == 2 ? z : w;
 		T* p = (&x)+index;
 		return *p; 
 	}
 	constexpr T operator[](unsigned int index) const {
 		assert(index<4);
+		if(std::is_constant_evaluated()) return index == 0 ? x : index == 1 ? y : index == 2 ? z : w;
 		const T* p = (&x) + index;
 		return *p;
 	}
 
 	constexpr vector4 operator-() const {
+		if constexpr(std::is_same_v<T, double>) {
+			if(!std::is_constant_evaluated()) return vector4{-f64()};
+		}
 		return {-x, -y, -z, -w};
 	}
 	constexpr vector4 operator+(T o) const {
+		if constexpr(std::is_same_v<T, double>) {
+			if(!std::is_constant_evaluated()) return vector4{f64() + detail::f64x4::set1(o)};
+		}
 		return {x + o, y + o, z + o, w + o};
 	}
 	constexpr vector4 operator+(const vector4& o) const {
+		if constexpr(std::is_same_v<T, double>) {
+			if(!std::is_constant_evaluated()) return vector4{f64() + o.f64()};
+		}
 		return {x + o.x, y + o.y, z + o.z, w + o.w};
 	}
 	constexpr vector4 operator-(T o) const {
+		if constexpr(std::is_same_v<T, double>) {
+			if(!std::is_constant_evaluated()) return vector4{f64() - detail::f64x4::set1(o)};
+		}
 		return {x - o, y - o, z - o, w - o};
 	}
 	constexpr vector4 operator-(const vector4& o) const {
+		if constexpr(std::is_same_v<T, double>) {
+			if(!std::is_constant_evaluated()) return vector4{f64() - o.f64()};
+		}
 		return {x - o.x, y - o.y, z - o.z, w - o.w};
 	}
 	constexpr vector4 operator*(T o) const {
+		if constexpr(std::is_same_v<T, double>) {
+			if(!std::is_constant_evaluated()) return vector4{f64() * detail::f64x4::set1(o)};
+		}
 		return {x*o, y*o, z*o, w*o};
 	}
 	constexpr vector4 operator*(const vector4& o) const {
+		if constexpr(std::is_same_v<T, double>) {
+			if(!std::is_constant_evaluated()) return vector4{f64() * o.f64()};
+		}
 		return {x*o.x, y*o.y, z*o.z, w*o.w};
 	}
 	constexpr vector4 operator/(T o) const {
+		if constexpr(std::is_same_v<T, double>) {
+			if(!std::is_constant_evaluated()) return vector4{f64() / detail::f64x4::set1(o)};
+		}
 		return {x / o, y / o, z / o, w / o};
 	}
 	constexpr vector4 operator/(const vector4& o) const {
+		if constexpr(std::is_same_v<T, double>) {
+			if(!std::is_constant_evaluated()) return vector4{f64() / o.f64()};
+		}
 		return {x / o.x, y / o.y, z / o.z, w / o.w};
 	}
 
@@ -78,43 +154,22 @@ struct vector4 final {
 			o[3].x * x + o[3].y * y + o[3].z * z + o[3].w * w};
 	}
 
-	constexpr vector4& operator+=(T o) {
-		x += o; y += o; z += o; w += o;
-		return *this;
-	}
-	constexpr vector4& operator+=(const vector4& o) {
-		x += o.x; y += o.y; z += o.z; w += o.w;
-		return *this;
-	}
-	constexpr vector4& operator-=(T o) {
-		x -= o; y -= o; z -= o; w -= o;
-		return *this;
-	}
-	constexpr vector4& operator-=(const vector4& o) {
-		x -= o.x; y -= o.y; z -= o.z; w -= o.w;
-		return *this;
-	}
-	constexpr vector4& operator*=(T o) {
-		x *= o; y *= o; z *= o; w *= o;
-		return *this;
-	}
-	constexpr vector4& operator*=(const vector4& o) {
-		x *= o.x; y *= o.y; z *= o.z; w *= o.w;
-		return *this;
-	}
-	constexpr vector4& operator/=(T o) {
-		x /= o; y /= o; z /= o; w /= o;
-		return *this;
-	}
-	constexpr vector4& operator/=(const vector4& o) {
-		x /= o.x; y /= o.y; z /= o.z; w /= o.w;
-		return *this;
-	}
+	constexpr vector4& operator+=(T o) { return *this = operator+(o); }
+	constexpr vector4& operator+=(const vector4& o) { return *this = operator+(o); }
+	constexpr vector4& operator-=(T o) { return *this = operator-(o); }
+	constexpr vector4& operator-=(const vector4& o) { return *this = operator-(o); }
+	constexpr vector4& operator*=(T o) { return *this = operator*(o); }
+	constexpr vector4& operator*=(const vector4& o) { return *this = operator*(o); }
+	constexpr vector4& operator/=(T o) { return *this = operator/(o); }
+	constexpr vector4& operator/=(const vector4& o) { return *this = operator/(o); }
 
 	constexpr bool operator==(const T o) const {
 		return x == o && y == o && z == o && w==o;
 	}
 	constexpr bool operator==(const vector4& o) const {
+		if constexpr(std::is_same_v<T, double>) {
+			if(!std::is_constant_evaluated()) return f64().maskEQ(o.f64()) == 0xf;
+		}
 		return x == o.x && y == o.y && z == o.z && w==o.w;
 	}
 	constexpr bool operator!=(const T o) const {
@@ -144,24 +199,38 @@ struct vector4 final {
         return !(this < o);
     }
 
-    constexpr bool anyEQ(T v) const { return x==v || y==v || z==v || w==v; }
-	constexpr bool anyLT(T v) const { return x<v || y<v || z<v || w<v; }
-	constexpr bool anyLTE(T v) const { return x <= v || y <= v || z <= v || w <= v; }
-	constexpr bool anyGT(T v) const { return x>v || y>v || z>v || w>v; }
-	constexpr bool anyGTE(T v) const { return x >= v || y >= v || z >= v || w >= v; }
-	constexpr bool anyLT(const vector4& v) const { return x<v.x || y<v.y || z<v.z || w<v.w; }
-	constexpr bool anyLTE(const vector4& v) const { return x <= v.x || y <= v.y || z <= v.z || w <= v.w; }
-	constexpr bool anyGT(const vector4& v) const { return x>v.x || y>v.y || z>v.z || w>v.w; }
-	constexpr bool anyGTE(const vector4& v) const { return x >= v.x || y >= v.y || z >= v.z || w >= v.w; }
-
-	constexpr bool allLT(T v) const { return x<v && y<v && z<v && w<v; }
-	constexpr bool allLTE(T v) const { return x <= v && y <= v && z <= v && w <= v; }
-	constexpr bool allGT(T v) const { return x>v && y>v && z>v && w>v; }
-	constexpr bool allGTE(T v) const { return x >= v && y >= v && z >= v && w >= v; }
-	constexpr bool allLT(const vector4& v) const { return x<v.x && y<v.y && z<v.z && w<v.w; }
-	constexpr bool allLTE(const vector4& v) const { return x <= v.x && y <= v.y && z <= v.z && w <= v.w; }
-	constexpr bool allGT(const vector4& v) const { return x>v.x && y>v.y && z>v.z && w>v.w; }
-	constexpr bool allGTE(const vector4& v) const { return x >= v.x && y >= v.y && z >= v.z && w >= v.w; }
+	/// Per component comparisons. Bit i of the result is set if component i passes
+	constexpr unsigned maskEQ(T v) const { return unsigned(x == v) | unsigned(y == v) << 1 | unsigned(z == v) << 2 | unsigned(w == v) << 3; }
+	constexpr unsigned maskNEQ(T v) const { return unsigned(x != v) | unsigned(y != v) << 1 | unsigned(z != v) << 2 | unsigned(w != v) << 3; }
+	constexpr unsigned maskLT(T v) const { return unsigned(x < v) | unsigned(y < v) << 1 | unsigned(z < v) << 2 | unsigned(w < v) << 3; }
+	constexpr unsigned maskLTE(T v) const { return unsigned(x <= v) | unsigned(y <= v) << 1 | unsigned(z <= v) << 2 | unsigned(w <= v) << 3; }
+	constexpr unsigned maskGT(T v) const { return unsigned(x > v) | unsigned(y > v) << 1 | unsigned(z > v) << 2 | unsigned(w > v) << 3; }
+	constexpr unsigned maskGTE(T v) const { return unsigned(x >= v) | unsigned(y >= v) << 1 | unsigned(z >= v) << 2 | unsigned(w >= v) << 3; }
+	constexpr unsigned maskEQ(const vector4& v) const { return unsigned(x == v.x) | unsigned(y == v.y) << 1 | unsigned(z == v.z) << 2 | unsigned(w == v.w) << 3; }
+	constexpr unsigned maskNEQ(const vector4& v) const { return unsigned(x != v.x) | unsigned(y != v.y) << 1 | unsigned(z != v.z) << 2 | unsigned(w != v.w) << 3; }
+	constexpr unsigned maskLT(const vector4& v) const { return unsigned(x < v.x) | unsigned(y < v.y) << 1 | unsigned(z < v.z) << 2 | unsigned(w < v.w) << 3; }
+	constexpr unsigned maskLTE(const vector4& v) const { return unsigned(x <= v.x) | unsigned(y <= v.y) << 1 | unsigned(z <= v.z) << 2 | unsigned(w <= v.w) << 3; }
+	constexpr unsigned maskGT(const vector4& v) const { return unsigned(x > v.x) | unsigned(y > v.y) << 1 | unsigned(z > v.z) << 2 | unsigned(w > v.w) << 3; }
+	constexpr unsigned maskGTE(const vector4& v) const { return unsigned(x >= v.x) | unsigned(y >= v.y) << 1 | unsigned(z >= v.z) << 2 | unsigned(w >= v.w) << 3; }
+
+	constexpr bool anyEQ(T v) const { return maskEQ(v) != 0; }
+	constexpr bool anyLT(T v) const { return maskLT(v) != 0; }
+	constexpr bool anyLTE(T v) const { return maskLTE(v) != 0; }
+	constexpr bool anyGT(T v) const { return maskGT(v) != 0; }
+	constexpr bool anyGTE(T v) const { return maskGTE(v) != 0; }
+	constexpr bool anyLT(const vector4& v) const { return maskLT(v) != 0; }
+	constexpr bool anyLTE(const vector4& v) const { return maskLTE(v) != 0; }
+	constexpr bool anyGT(const vector4& v) const { return maskGT(v) != 0; }
+	constexpr bool anyGTE(const vector4& v) const { return maskGTE(v) != 0; }
+
+	constexpr bool allLT(T v) const { return maskLT(v) == 0xf; }
+	constexpr bool allLTE(T v) const { return maskLTE(v) == 0xf; }
+	constexpr bool allGT(T v) const { return maskGT(v) == 0xf; }
+	constexpr bool allGTE(T v) const { return maskGTE(v) == 0xf; }
+	constexpr bool allLT(const vector4& v) const { return maskLT(v) == 0xf; }
+	constexpr bool allLTE(const vector4& v) const { return maskLTE(v) == 0xf; }
+	constexpr bool allGT(const vector4& v) const { return maskGT(v) == 0xf; }
+	constexpr bool allGTE(const vector4& v) const { return maskGTE(v) == 0xf; }
 
 	constexpr T hadd() const { return x + y + z + w; }
 	constexpr T hmul() const { return x * y * z * w; }
@@ -173,43 +242,95 @@ struct vector4 final {
 		return {(T)::ceil(x), (T)::ceil(y), (T)::ceil(z), (T)::ceil(w)};
 	}
 
-	T min() const { return std::min({x, y, z, w}); }
-	T max() const { return std::max({x, y, z, w}); }
+	constexpr T min() const { return std::min({x, y, z, w}); }
+	constexpr T max() const { return std::max({x, y, z, w}); }
 
-	vector4 min(const vector4& o) const {
+	constexpr vector4 min(const vector4& o) const {
+		if constexpr(std::is_same_v<T, double>) {
+			if(!std::is_constant_evaluated()) return vector4{f64().min(o.f64())};
+		}
 		return {std::min(x, o.x), std::min(y, o.y), std::min(z, o.z), std::min(w, o.w)};
 	}
-	vector4 max(const vector4& o) const {
+	constexpr vector4 max(const vector4& o) const {
+		if constexpr(std::is_same_v<T, double>) {
+			if(!std::is_constant_evaluated()) return vector4{f64().max(o.f64())};
+		}
 		return {std::max(x, o.x), std::max(y, o.y), std::max(z, o.z), std::max(w, o.w)};
 	}
+	constexpr vector4 clamp(const vector4& lo, const vector4& hi) const {
+		return max(lo).min(hi);
+	}
+	constexpr vector4 clamp(T lo, T hi) const {
+		return clamp(vector4{lo, lo, lo, lo}, vector4{hi, hi, hi, hi});
+	}
+	/// Clamp to [0, 1]
+	constexpr vector4 saturate() const {
+		return clamp(T(0), T(1));
+	}
+	/// 0 where the component is less than edge, otherwise 1
+	constexpr vector4 step(const vector4& edge) const {
+		return {T(x >= edge.x), T(y >= edge.y), T(z >= edge.z), T(w >= edge.w)};
+	}
+	constexpr vector4 step(T edge) const {
+		return {T(x >= edge), T(y >= edge), T(z >= edge), T(w >= edge)};
+	}
 
-	T dot(const vector4& o) const {
+	constexpr T dot(const vector4& o) const {
+		if constexpr(std::is_same_v<T, double>) {
+			if(!std::is_constant_evaluated()) return (f64() * o.f64()).hadd();
+		}
 		return {x*o.x + y*o.y + z*o.z + w*o.w};
 	}
-	T length() const {
-		return sqrt(lengthSquared());
-	}
-	T lengthSquared() const {
+	template<Precision P = Precision::Precise>
+	constexpr T length() const {
+		if constexpr(P == Precision::Fast) {
+			return fast::sqrt(lengthSquared());
+		} else {
+			return sqrt(lengthSquared());
+		}
+	}
+	constexpr T lengthSquared() const {
+		if constexpr(std::is_same_v<T, double>) {
+			if(!std::is_constant_evaluated()) return (f64() * f64()).hadd();
+		}
 		return x*x + y*y + z*z + w*w;
 	}
-	T invLength() const {
-		return 1 / length();
+	template<Precision P = Precision::Precise>
+	constexpr T invLength() const {
+		if constexpr(P == Precision::Fast) {
+			return fast::rsqrt(lengthSquared());
+		} else {
+			return 1 / length();
+		}
 	}
 
-	auto& normalise() {
-		operator*=(invLength());
+	template<Precision P = Precision::Precise>
+	constexpr auto& normalise() {
+		operator*=(invLength<P>());
 		return *this;
 	}
-	vector4 normalised() const {
-		return operator*(invLength());
+	template<Precision P = Precision::Precise>
+	constexpr vector4 normalised() const {
+		if constexpr(std::is_same_v<T, double> && P == Precision::Precise) {
+			if(!std::is_constant_evaluated()) return vector4{f64() / detail::f64x4::set1(dot(*this)).sqrt()};
+		}
+		return operator*(invLength<P>());
 	}
 
 	/// Returns 1/this
-	vector4 reciprocal() const {
-		return {1 / x, 1 / y, 1 / z, 1 / w};
+	template<Precision P = Precision::Precise>
+	constexpr vector4 reciprocal() const {
+		if constexpr(P == Precision::Fast) {
+			return {fast::rcp(x), fast::rcp(y), fast::rcp(z), fast::rcp(w)};
+		} else {
+			return {1 / x, 1 / y, 1 / z, 1 / w};
+		}
 	}
 
 	vector4 abs() const {
+		if constexpr(std::is_same_v<T, double>) {
+			return vector4{f64().abs()};
+		}
 		return {std::abs(x), std::abs(y), std::abs(z), std::abs(w)};
 	}
 
@@ -240,6 +361,304 @@ struct vector4 final {
     }
 };
 
+///
+/// SSE specialisation of float4.
+///
+/// Same public API as vector4<T> but 16 byte aligned so that the
+/// x,y,z,w members can be loaded directly into an __m128.
+/// Constant evaluated calls fall back to the scalar code.
+///
+template<>
+struct alignas(16) vector4<float> final {
+	float x = 0, y = 0, z = 0, w = 0;
+	vector4() = default;
+	constexpr vector4(float x, float y, float z, float w) : x(x), y(y), z(z), w(w) {}
+	/// Copy constructors
+	template<typename S>
+	constexpr vector4(const vector4<S>& i) : x(float(i.x)), y(float(i.y)), z(float(i.z)), w(float(i.w)) {}
+	explicit vector4(__m128 m) { _mm_store_ps(&x, m); }
+
+	__m128 m128() const { return _mm_load_ps(&x); }
+
+	/// unordered_map<float4,value,float4::HashFunc> mymap;
+	struct HashFunc {
+		std::size_t operator()(const vector4& k) const {
+			return hash::values(k.x, k.y, k.z, k.w);
+		}
+	};
+
+	constexpr float& operator[](unsigned int index) {
+		assert(index<4);
+		if(std::is_constant_evaluated()) return index == 0 ? x : index == 1 ? y : index == 2 ? z : w;
+		float* p = (&x) + index;
+		return *p;
+	}
+	constexpr float operator[](unsigned int index) const {
+		assert(index<4);
+		if(std::is_constant_evaluated()) return index == 0 ? x : index == 1 ? y : index == 2 ? z : w;
+		const float* p = (&x) + index;
+		return *p;
+	}
+
+	constexpr vector4 operator-() const {
+		if(std::is_constant_evaluated()) return {-x, -y, -z, -w};
+		return vector4{_mm_xor_ps(m128(), _mm_set1_ps(-0.0f))};
+	}
+	constexpr vector4 operator+(float o) const {
+		if(std::is_constant_evaluated()) return {x + o, y + o, z + o, w + o};
+		return vector4{_mm_add_ps(m128(), _mm_set1_ps(o))};
+	}
+	constexpr vector4 operator+(const vector4& o) const {
+		if(std::is_constant_evaluated()) return {x + o.x, y + o.y, z + o.z, w + o.w};
+		return vector4{_mm_add_ps(m128(), o.m128())};
+	}
+	constexpr vector4 operator-(float o) const {
+		if(std::is_constant_evaluated()) return {x - o, y - o, z - o, w - o};
+		return vector4{_mm_sub_ps(m128(), _mm_set1_ps(o))};
+	}
+	constexpr vector4 operator-(const vector4& o) const {
+		if(std::is_constant_evaluated()) return {x - o.x, y - o.y, z - o.z, w - o.w};
+		return vector4{_mm_sub_ps(m128(), o.m128())};
+	}
+	constexpr vector4 operator*(float o) const {
+		if(std::is_constant_evaluated()) return {x*o, y*o, z*o, w*o};
+		return vector4{_mm_mul_ps(m128(), _mm_set1_ps(o))};
+	}
+	constexpr vector4 operator*(const vector4& o) const {
+		if(std::is_constant_evaluated()) return {x*o.x, y*o.y, z*o.z, w*o.w};
+		return vector4{_mm_mul_ps(m128(), o.m128())};
+	}
+	constexpr vector4 operator/(float o) const {
+		if(std::is_constant_evaluated()) return {x / o, y / o, z / o, w / o};
+		return vector4{_mm_div_ps(m128(), _mm_set1_ps(o))};
+	}
+	constexpr vector4 operator/(const vector4& o) const {
+		if(std::is_constant_evaluated()) return {x / o.x, y / o.y, z / o.z, w / o.w};
+		return vector4{_mm_div_ps(m128(), o.m128())};
+	}
+
+	/// Defined in matrix4.h
+	constexpr vector4 operator*(const matrix4<float>& o) const;
+
+	constexpr vector4& operator+=(float o) { return *this = operator+(o); }
+	constexpr vector4& operator+=(const vector4& o) { return *this = operator+(o); }
+	constexpr vector4& operator-=(float o) { return *this = operator-(o); }
+	constexpr vector4& operator-=(const vector4& o) { return *this = operator-(o); }
+	constexpr vector4& operator*=(float o) { return *this = operator*(o); }
+	constexpr vector4& operator*=(const vector4& o) { return *this = operator*(o); }
+	constexpr vector4& operator/=(float o) { return *this = operator/(o); }
+	constexpr vector4& operator/=(const vector4& o) { return *this = operator/(o); }
+
+	constexpr bool operator==(const float o) const {
+		if(std::is_constant_evaluated()) return x == o && y == o && z == o && w == o;
+		return _mm_movemask_ps(_mm_cmpeq_ps(m128(), _mm_set1_ps(o))) == 0xf;
+	}
+	constexpr bool operator==(const vector4& o) const {
+		if(std::is_constant_evaluated()) return x == o.x && y == o.y && z == o.z && w == o.w;
+		return _mm_movemask_ps(_mm_cmpeq_ps(m128(), o.m128())) == 0xf;
+	}
+	constexpr bool operator!=(const float o) const {
+		return !operator==(o);
+	}
+	constexpr bool operator!=(const vector4& o) const {
+		return !operator==(o);
+	}
+	constexpr bool approx(const vector4& o) const {
+		return approxEqual(x, o.x) && approxEqual(y, o.y) &&
+			   approxEqual(z, o.z) && approxEqual(w, o.w);
+	}
+	/// For std::set and other containers that use comparison
+	constexpr bool operator<(const vector4& o) const {
+		if(x<o.x) return true;
+		if(x == o.x && y<o.y) return true;
+		if(x == o.x && y == o.y && z < o.z) return true;
+		return x==o.x && y==o.y && z==o.z && w<o.w;
+	}
+	constexpr bool operator<=(const vector4& o) const {
+		return !(o < *this);
+	}
+	constexpr bool operator>(const vector4& o) const {
+		return o < *this;
+	}
+	constexpr bool operator>=(const vector4& o) const {
+		return !(*this < o);
+	}
+
+	/// Per component comparisons. Bit i of the result is set if component i passes
+	unsigned maskEQ(float v) const { return _mm_movemask_ps(_mm_cmpeq_ps(m128(), _mm_set1_ps(v))); }
+	unsigned maskNEQ(float v) const { return _mm_movemask_ps(_mm_cmpneq_ps(m128(), _mm_set1_ps(v))); }
+	unsigned maskLT(float v) const { return _mm_movemask_ps(_mm_cmplt_ps(m128(), _mm_set1_ps(v))); }
+	unsigned maskLTE(float v) const { return _mm_movemask_ps(_mm_cmple_ps(m128(), _mm_set1_ps(v))); }
+	unsigned maskGT(float v) const { return _mm_movemask_ps(_mm_cmpgt_ps(m128(), _mm_set1_ps(v))); }
+	unsigned maskGTE(float v) const { return _mm_movemask_ps(_mm_cmpge_ps(m128(), _mm_set1_ps(v))); }
+	unsigned maskEQ(const vector4& v) const { return _mm_movemask_ps(_mm_cmpeq_ps(m128(), v.m128())); }
+	unsigned maskNEQ(const vector4& v) const { return _mm_movemask_ps(_mm_cmpneq_ps(m128(), v.m128())); }
+	unsigned maskLT(const vector4& v) const { return _mm_movemask_ps(_mm_cmplt_ps(m128(), v.m128())); }
+	unsigned maskLTE(const vector4& v) const { return _mm_movemask_ps(_mm_cmple_ps(m128(), v.m128())); }
+	unsigned maskGT(const vector4& v) const { return _mm_movemask_ps(_mm_cmpgt_ps(m128(), v.m128())); }
+	unsigned maskGTE(const vector4& v) const { return _mm_movemask_ps(_mm_cmpge_ps(m128(), v.m128())); }
+
+	bool anyEQ(float v) const { return _mm_movemask_ps(_mm_cmpeq_ps(m128(), _mm_set1_ps(v))) != 0; }
+	bool anyLT(float v) const { return _mm_movemask_ps(_mm_cmplt_ps(m128(), _mm_set1_ps(v))) != 0; }
+	bool anyLTE(float v) const { return _mm_movemask_ps(_mm_cmple_ps(m128(), _mm_set1_ps(v))) != 0; }
+	bool anyGT(float v) const { return _mm_movemask_ps(_mm_cmpgt_ps(m128(), _mm_set1_ps(v))) != 0; }
+	bool anyGTE(float v) const { return _mm_movemask_ps(_mm_cmpge_ps(m128(), _mm_set1_ps(v))) != 0; }
+	bool anyLT(const vector4& v) const { return _mm_movemask_ps(_mm_cmplt_ps(m128(), v.m128())) != 0; }
+	bool anyLTE(const vector4& v) const { return _mm_movemask_ps(_mm_cmple_ps(m128(), v.m128())) != 0; }
+	bool anyGT(const vector4& v) const { return _mm_movemask_ps(_mm_cmpgt_ps(m128(), v.m128())) != 0; }
+	bool anyGTE(const vector4& v) const { return _mm_movemask_ps(_mm_cmpge_ps(m128(), v.m128())) != 0; }
+
+	bool allLT(float v) const { return _mm_movemask_ps(_mm_cmplt_ps(m128(), _mm_set1_ps(v))) == 0xf; }
+	bool allLTE(float v) const { return _mm_movemask_ps(_mm_cmple_ps(m128(), _mm_set1_ps(v))) == 0xf; }
+	bool allGT(float v) const { return _mm_movemask_ps(_mm_cmpgt_ps(m128(), _mm_set1_ps(v))) == 0xf; }
+	bool allGTE(float v) const { return _mm_movemask_ps(_mm_cmpge_ps(m128(), _mm_set1_ps(v))) == 0xf; }
+	bool allLT(const vector4& v) const { return _mm_movemask_ps(_mm_cmplt_ps(m128(), v.m128())) == 0xf; }
+	bool allLTE(const vector4& v) const { return _mm_movemask_ps(_mm_cmple_ps(m128(), v.m128())) == 0xf; }
+	bool allGT(const vector4& v) const { return _mm_movemask_ps(_mm_cmpgt_ps(m128(), v.m128())) == 0xf; }
+	bool allGTE(const vector4& v) const { return _mm_movemask_ps(_mm_cmpge_ps(m128(), v.m128())) == 0xf; }
+
+	float hadd() const { return _mm_cvtss_f32(hsum(m128())); }
+	float hmul() const {
+		__m128 v = m128();
+		__m128 t = _mm_mul_ps(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 3, 0, 1)));
+		return _mm_cvtss_f32(_mm_mul_ss(t, _mm_movehl_ps(t, t)));
+	}
+
+	vector4 floor() const {
+		return {::floorf(x), ::floorf(y), ::floorf(z), ::floorf(w)};
+	}
+	vector4 ceil() const {
+		return {::ceilf(x), ::ceilf(y), ::ceilf(z), ::ceilf(w)};
+	}
+
+	float min() const {
+		__m128 v = m128();
+		__m128 t = _mm_min_ps(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 3, 0, 1)));
+		return _mm_cvtss_f32(_mm_min_ss(t, _mm_movehl_ps(t, t)));
+	}
+	float max() const {
+		__m128 v = m128();
+		__m128 t = _mm_max_ps(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 3, 0, 1)));
+		return _mm_cvtss_f32(_mm_max_ss(t, _mm_movehl_ps(t, t)));
+	}
+
+	vector4 min(const vector4& o) const {
+		return vector4{_mm_min_ps(m128(), o.m128())};
+	}
+	vector4 max(const vector4& o) const {
+		return vector4{_mm_max_ps(m128(), o.m128())};
+	}
+	vector4 clamp(const vector4& lo, const vector4& hi) const {
+		return vector4{_mm_min_ps(_mm_max_ps(m128(), lo.m128()), hi.m128())};
+	}
+	vector4 clamp(float lo, float hi) const {
+		return vector4{_mm_min_ps(_mm_max_ps(m128(), _mm_set1_ps(lo)), _mm_set1_ps(hi))};
+	}
+	/// Clamp to [0, 1]
+	vector4 saturate() const {
+		return clamp(0.0f, 1.0f);
+	}
+	/// 0 where the component is less than edge, otherwise 1
+	vector4 step(const vector4& edge) const {
+		return vector4{_mm_and_ps(_mm_cmpge_ps(m128(), edge.m128()), _mm_set1_ps(1.0f))};
+	}
+	vector4 step(float edge) const {
+		return vector4{_mm_and_ps(_mm_cmpge_ps(m128(), _mm_set1_ps(edge)), _mm_set1_ps(1.0f))};
+	}
+
+	constexpr float dot(const vector4& o) const {
+		if(std::is_constant_evaluated()) return x*o.x + y*o.y + z*o.z + w*o.w;
+		return _mm_cvtss_f32(hsum(_mm_mul_ps(m128(), o.m128())));
+	}
+	template<Precision P = Precision::Precise>
+	constexpr float length() const {
+		if(std::is_constant_evaluated()) return maths::sqrt(lengthSquared());
+		if constexpr(P == Precision::Fast) {
+			return fast::sqrt(lengthSquared());
+		} else {
+			return _mm_cvtss_f32(_mm_sqrt_ss(lengthSquared4()));
+		}
+	}
+	constexpr float lengthSquared() const {
+		if(std::is_constant_evaluated()) return dot(*this);
+		return _mm_cvtss_f32(lengthSquared4());
+	}
+	template<Precision P = Precision::Precise>
+	constexpr float invLength() const {
+		if(std::is_constant_evaluated()) return 1 / length();
+		if constexpr(P == Precision::Fast) {
+			return fast::rsqrt(lengthSquared());
+		} else {
+			return 1 / length();
+		}
+	}
+
+	template<Precision P = Precision::Precise>
+	constexpr auto& normalise() {
+		return *this = normalised<P>();
+	}
+	template<Precision P = Precision::Precise>
+	constexpr vector4 normalised() const {
+		if(std::is_constant_evaluated()) return operator/(length());
+		__m128 lsq = _mm_shuffle_ps(lengthSquared4(), lengthSquared4(), 0);
+		if constexpr(P == Precision::Fast) {
+			return vector4{_mm_mul_ps(m128(), fast::rsqrt(lsq))};
+		} else {
+			return vector4{_mm_div_ps(m128(), _mm_sqrt_ps(lsq))};
+		}
+	}
+
+	/// Returns 1/this
+	template<Precision P = Precision::Precise>
+	vector4 reciprocal() const {
+		if constexpr(P == Precision::Fast) {
+			return vector4{fast::rcp(m128())};
+		} else {
+			return vector4{_mm_div_ps(_mm_set1_ps(1), m128())};
+		}
+	}
+
+	vector4 abs() const {
+		return vector4{_mm_andnot_ps(_mm_set1_ps(-0.0f), m128())};
+	}
+
+	std::string toString(const char* fmt = nullptr) const {
+		char buf[64];
+		const char* format = fmt ? fmt : "%.3f";
+
+		char fmtbuf[64];
+		sprintf_s(fmtbuf, "[%s, %s, %s, %s]", format, format, format, format);
+
+		sprintf_s(buf, fmtbuf, x, y, z, w);
+		return std::string(buf);
+	}
+private:
+	/// Sum of all 4 lanes in the lowest lane
+	static __m128 hsum(__m128 v) {
+		__m128 t = _mm_add_ps(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 3, 0, 1)));
+		return _mm_add_ss(t, _mm_movehl_ps(t, t));
+	}
+	__m128 lengthSquared4() const {
+		__m128 v = m128();
+		return hsum(_mm_mul_ps(v, v));
+	}
+};
+static_assert(sizeof(vector4<float>) == 16 && alignof(vector4<float>) == 16);
+
+/// Component i is taken from a if bit i of mask is set, otherwise from b
+template<typename T>
+constexpr vector4<T> select(unsigned mask, const vector4<T>& a, const vector4<T>& b) {
+	return {(mask & 1) ? a.x : b.x, (mask & 2) ? a.y : b.y, (mask & 4) ? a.z : b.z, (mask & 8) ? a.w : b.w};
+}
+inline vector4<float> select(unsigned mask, const vector4<float>& a, const vector4<float>& b) {
+	const __m128i bit = _mm_setr_epi32(1, 2, 4, 8);
+	const __m128 m = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(_mm_set1_epi32((int)mask), bit), bit));
+	return vector4<float>{_mm_or_ps(_mm_and_ps(m, a.m128()), _mm_andnot_ps(m, b.m128()))};
+}
+
+/// f64x4::load and store are aligned
+static_assert(sizeof(vector4<double>) == 32 && alignof(vector4<double>) == 16);
+
 typedef vector4<int> int4;
 typedef vector4<unsigned int> uint4;
 typedef vector4<float> float4;
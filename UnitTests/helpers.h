@@ -0,0 +1,55 @@
+#pragma once
+///
+///	Helpers shared by the unit tests.
+///
+#include "CppUnitTest.h"
+#include "../Maths/maths.h"
+
+namespace UnitTests {
+
+/// Runs fn once for every level supported by this CPU
+template<typename F>
+void forEachLevel(F fn) {
+	using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+	const maths::SimdLevel original = maths::simdLevel();
+	for(int i = 0; i <= (int)maths::detectedSimdLevel(); i++) {
+		maths::setSimdLevel((maths::SimdLevel)i);
+		Assert::IsTrue(maths::simdLevel() == (maths::SimdLevel)i);
+		fn();
+	}
+	maths::setSimdLevel(original);
+}
+/// Bit i of a mask written by the batch tests
+inline bool bit(const std::vector<uint64_t>& mask, std::size_t i) {
+	return (mask[i / 64] >> (i % 64)) & 1;
+}
+
+/// n points in a line. Use a count that is not a multiple of the widest
+/// register so that the unrolled loops and the tails are exercised
+inline std::vector<maths::float3> points3(std::size_t n, float offset) {
+	std::vector<maths::float3> v;
+	for(std::size_t i = 0; i < n; i++) {
+		const float f = (float)i;
+		v.push_back({f + offset, f * 0.5f - offset, 3 - f * offset});
+	}
+	return v;
+}
+/// As points3 with w = 2*offset + i
+inline std::vector<maths::float4> points4(std::size_t n, float offset) {
+	std::vector<maths::float4> v;
+	for(auto& p : points3(n, offset)) v.push_back({p.x, p.y, p.z, offset * 2 + (float)v.size()});
+	return v;
+}
+inline maths::float3_stream stream3(std::size_t n, float offset) {
+	return maths::float3_stream{points3(n, offset)};
+}
+/// n points uniformly distributed in the box lo..hi
+inline std::vector<maths::float3> randomPoints3(std::size_t n, unsigned seed, maths::float3 lo, maths::float3 hi) {
+	std::mt19937 rng(seed);
+	std::uniform_real_distribution<float> x(lo.x, hi.x), y(lo.y, hi.y), z(lo.z, hi.z);
+	std::vector<maths::float3> v(n);
+	for(auto& p : v) p = {x(rng), y(rng), z(rng)};
+	return v;
+}
+
+}
@@ -0,0 +1,71 @@
+#include "_pch.h"
+#include "CppUnitTest.h"
+#include "../Maths/maths.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace maths;
+
+namespace UnitTests {
+
+static const float3x3 M = float3x3::translate({1, -2}) * float3x3::rotate(0.3f) * float3x3::scale({2, 0.5f});
+
+TEST_CLASS(test_affine2) {
+public:
+
+	TEST_METHOD(size) {
+		Assert::IsTrue(sizeof(float2x3) == 24);
+		Assert::IsTrue(sizeof(double2x3) == 48);
+	}
+	TEST_METHOD(matrix_conversion) {
+		const auto a = float2x3::fromMatrix(M);
+		Assert::IsTrue(a.toMatrix3() == M);
+		Assert::IsTrue(a.translation() == float2{1, -2});
+		Assert::IsTrue(float2x3::identity().toMatrix() == matrix::identity());
+		Assert::IsTrue(float2x3::rotate(0.7f).toMatrix().approx(matrix::rotateZ(0.7f)));
+		Assert::IsTrue(float2x3::translate({1, 2}).toMatrix() == matrix::translate({1, 2, 0}));
+		Assert::IsTrue(float2x3::scale({1, 2}).toMatrix() == matrix::scale({1, 2, 1}));
+	}
+	TEST_METHOD(compose) {
+		const auto a = float2x3::translate({1, -2}) * float2x3::rotate(0.3f);
+		const auto b = float2x3::scale({2, 0.5f});
+		Assert::IsTrue((a * b).toMatrix3().approx(M));
+		Assert::IsTrue((a * float2x3::identity()) == a);
+
+		constexpr auto c = double2x3::translate({1, 2}) * double2x3::scale({2, 2});
+		static_assert(c.transformPoint({1, 1}) == double2{3, 4});
+		static_assert(c.transformDirection({1, 1}) == double2{2, 2});
+	}
+	TEST_METHOD(transform) {
+		const auto a = float2x3::fromMatrix(M);
+		for(float i = -2; i < 2; i += 0.5f) {
+			const float2 p{i, 1 - i};
+			const float3 mp = M * float3{p.x, p.y, 1};
+			const float3 md = M * float3{p.x, p.y, 0};
+			Assert::IsTrue(a.transformPoint(p).approx(float2{mp.x, mp.y}));
+			Assert::IsTrue(a.transformDirection(p).approx(float2{md.x, md.y}));
+		}
+	}
+	TEST_METHOD(inversed) {
+		const auto a = float2x3::fromMatrix(M);
+		Assert::IsTrue(approxEqual(a.determinant(), M.determinant()));
+		Assert::IsTrue(a.inversed().toMatrix3().approx(M.inversed()));
+		Assert::IsTrue((a * a.inversed()).approx(float2x3::identity()));
+	}
+	TEST_METHOD(camera2d) {
+		Camera2D camera;
+		camera.init({800, 600});
+		camera.moveBy({-30, 45}).setZoom(1.5f, 0.1f, 10);
+		for(int i = 0; i < 2; i++) {
+			/// The 4x4 matrices the camera used to multiply
+			const matrix vp = camera.P() * camera.V();
+			Assert::IsTrue(camera.VP().approx(vp));
+			for(float x = -100; x < 900; x += 150) {
+				const float4 e = vp * float4{x, x * 0.5f, 0, 1};
+				Assert::IsTrue(camera.VP2().transformPoint({x, x * 0.5f}).approx(float2{e.x, e.y}));
+			}
+			camera.zoomIn(0.2f).moveTo({10, 20});
+		}
+	}
+};
+
+}
@@ -0,0 +1,67 @@
+#include "_pch.h"
+#include "CppUnitTest.h"
+#include "../Maths/maths.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace maths;
+
+namespace UnitTests {
+
+static const matrix M = matrix::translate({1, -2, 3}) * matrix::rotateX(0.3f) * matrix::rotateZ(1.1f) * matrix::scale({2, 0.5f, 4});
+
+TEST_CLASS(test_affine3) {
+public:
+
+	TEST_METHOD(size) {
+		Assert::IsTrue(sizeof(affine) == 48);
+		Assert::IsTrue(sizeof(daffine) == 96);
+	}
+	TEST_METHOD(matrix_conversion) {
+		const auto a = affine::fromMatrix(M);
+		Assert::IsTrue(a.toMatrix() == M);
+		Assert::IsTrue(affine::identity().toMatrix() == matrix::identity());
+		Assert::IsTrue(a.translation() == float3{1, -2, 3});
+	}
+	TEST_METHOD(factories) {
+		Assert::IsTrue(affine::translate({1, 2, 3}).toMatrix() == matrix::translate({1, 2, 3}));
+		Assert::IsTrue(affine::scale({1, 2, 3}).toMatrix() == matrix::scale({1, 2, 3}));
+		Assert::IsTrue(affine::rotateX(0.7f).toMatrix() == matrix::rotateX(0.7f));
+		Assert::IsTrue(affine::rotateY(0.7f).toMatrix() == matrix::rotateY(0.7f));
+		Assert::IsTrue(affine::rotateZ(0.7f).toMatrix() == matrix::rotateZ(0.7f));
+		const float3 eye{3, 5, 10}, target{0, 1, 0}, up{0, 1, 0};
+		Assert::IsTrue(affine::lookAtRH(eye, target, up).toMatrix() == matrix::lookAtRH(eye, target, up));
+		Assert::IsTrue(affine::lookAtLH(eye, target, up).toMatrix() == matrix::lookAtLH(eye, target, up));
+	}
+	TEST_METHOD(compose) {
+		const auto a = affine::translate({1, -2, 3}) * affine::rotateX(0.3f);
+		const auto b = affine::rotateZ(1.1f) * affine::scale({2, 0.5f, 4});
+		Assert::IsTrue((a * b).toMatrix().approx(M));
+		Assert::IsTrue((a * affine::identity()) == a);
+		Assert::IsTrue((affine::identity() * b) == b);
+
+		constexpr auto c = daffine::translate({1, 2, 3}) * daffine::scale({2, 2, 2});
+		static_assert(c.transformPoint({1, 1, 1}) == double3{3, 4, 5});
+	}
+	TEST_METHOD(transform) {
+		const auto a = affine::fromMatrix(M);
+		for(float i = -2; i < 2; i += 0.5f) {
+			const float3 p{i, 1 - i, i * 2};
+			const float4 mp = M * float4{p.x, p.y, p.z, 1};
+			const float4 md = M * float4{p.x, p.y, p.z, 0};
+			Assert::IsTrue(a.transformPoint(p).approx(float3{mp.x, mp.y, mp.z}));
+			Assert::IsTrue(a.transformDirection(p).approx(float3{md.x, md.y, md.z}));
+		}
+	}
+	TEST_METHOD(inversed) {
+		const auto a = affine::fromMatrix(M);
+		Assert::IsTrue(approxEqual(a.determinant(), M.determinant()));
+		Assert::IsTrue(a.inversed().toMatrix().approx(M.inversed()));
+		Assert::IsTrue((a * a.inversed()).approx(affine::identity()));
+
+		const auto view = affine::lookAtRH({3, 5, 10}, {0, 1, 0}, {0, 1, 0});
+		Assert::IsTrue(view.inversedRigid().approx(view.inversed()));
+		Assert::IsTrue(view.inversedRigid().toMatrix().approx(view.toMatrix().inversedRigid()));
+	}
+};
+
+}
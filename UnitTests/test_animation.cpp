@@ -0,0 +1,90 @@
+#include "_pch.h"
+#include "CppUnitTest.h"
+#include "../Maths/maths.h"
+#include "helpers.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace maths;
+using std::vector;
+
+namespace UnitTests {
+
+static quat randomQuat(std::mt19937& rng) {
+	std::uniform_real_distribution<float> d(-1, 1);
+	return quat{d(rng), d(rng), d(rng), d(rng)}.normalised();
+}
+
+TEST_CLASS(test_animation) {
+public:
+
+	TEST_METHOD(slerp_all) {
+		std::mt19937 rng(3);
+		/// An odd SIMD tail
+		const std::size_t n = 37;
+		float4_stream a(n), b(n);
+		for(std::size_t i = 0; i < n; i++) {
+			a.set(i, randomQuat(rng).xyzw());
+			b.set(i, randomQuat(rng).xyzw());
+		}
+		/// Almost parallel
+		b.set(5, a.get(5));
+		forEachLevel([&]() {
+			for(float t : {0.0f, 0.3f, 1.0f}) {
+				float4_stream out(n);
+				slerpAll(a, b, t, out);
+				for(std::size_t i = 0; i < n; i++) {
+					const auto expected = quat::fromVector(a.get(i)).slerp(quat::fromVector(b.get(i)), t);
+					Assert::IsTrue(quat::fromVector(out.get(i)).approx(expected));
+				}
+			}
+		});
+	}
+	TEST_METHOD(skin_all) {
+		std::mt19937 rng(7);
+		std::uniform_real_distribution<float> d(-2, 2);
+		std::uniform_int_distribution<int> bone(0, 5);
+		vector<dualquat> bones(6);
+		for(auto& dq : bones) dq = dualquat::fromRotationTranslation(randomQuat(rng), {d(rng), d(rng), d(rng)});
+
+		/// Several chunks with an odd SIMD tail
+		const std::size_t n = 20003;
+		vector<uint16_t> joints(n * 4);
+		float4_stream weights(n);
+		float3_stream p(n), nrm(n);
+		for(std::size_t i = 0; i < n; i++) {
+			for(int k = 0; k < 4; k++) joints[i * 4 + k] = (uint16_t)bone(rng);
+			float4 w{std::abs(d(rng)), std::abs(d(rng)), std::abs(d(rng)), i % 3 == 0 ? 0.0f : std::abs(d(rng))};
+			weights.set(i, w / (w.x + w.y + w.z + w.w));
+			p.set(i, {d(rng), d(rng), d(rng)});
+			nrm.set(i, float3{d(rng), d(rng), d(rng)}.normalised());
+		}
+		forEachLevel([&]() {
+			float3_stream outP(n), outN(n), only(n);
+			skinAll(bones, joints, weights, p, outP, nrm, outN);
+			skinAll(bones, joints, weights, p, only);
+			for(std::size_t i = 0; i < n; i += 7) {
+				const dualquat dqs[] = {bones[joints[i * 4]], bones[joints[i * 4 + 1]], bones[joints[i * 4 + 2]], bones[joints[i * 4 + 3]]};
+				const float4 w = weights.get(i);
+				const float ws[] = {w.x, w.y, w.z, w.w};
+				const auto blended = dualquat::blend(dqs, ws);
+				Assert::IsTrue(outP.get(i).approx(blended.transformPoint(p.get(i))));
+				Assert::IsTrue(outN.get(i).approx(blended.transformDirection(nrm.get(i))));
+				Assert::IsTrue(only.get(i) == outP.get(i));
+			}
+		});
+	}
+	TEST_METHOD(skin_in_place) {
+		const dualquat bones[] = {dualquat::translate({1, 2, 3})};
+		const vector<uint16_t> joints(3 * 4, 0);
+		float4_stream weights(3);
+		float3_stream p(3);
+		for(std::size_t i = 0; i < 3; i++) {
+			weights.set(i, {1, 0, 0, 0});
+			p.set(i, {(float)i, 0, 0});
+		}
+		skinAll(bones, joints, weights, p, p);
+		Assert::IsTrue(p.get(2) == float3{3, 2, 3});
+	}
+};
+
+}
@@ -0,0 +1,107 @@
+#include "_pch.h"
+#include "CppUnitTest.h"
+#include "../Maths/maths.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace maths;
+
+namespace UnitTests {
+
+/// The cached matrices against the general inverses of the current V() and P()
+static void assertInverses(Camera& camera) {
+	const matrix v = camera.V(), p = camera.P(), vp = camera.VP();
+	Assert::IsTrue(camera.invV().approx(v.inversed()));
+	Assert::IsTrue(camera.invP().approx(p.inversed()));
+	Assert::IsTrue((vp * camera.invVP()).approx(matrix::identity()));
+	Assert::IsTrue(camera.normalMatrix().approx(matrix{v[0], v[1], v[2], float4{0, 0, 0, 1}}.inversed().transposed()));
+}
+
+TEST_CLASS(test_camera) {
+public:
+
+	TEST_METHOD(camera3d_inverses) {
+		Camera3D camera;
+		camera.init({800, 600}, {3, 4, 10}, {0, 1, 0}, {0, 0, 0}).fovNearFar(toRadians(60), 0.5f, 50);
+		assertInverses(camera);
+
+		/// Each change is picked up whichever matrix is asked for first
+		camera.moveForward(2);
+		Assert::IsTrue(camera.invV().approx(camera.V().inversed()));
+		assertInverses(camera);
+		camera.yaw(0.1f).pitch(-0.2f);
+		Assert::IsTrue(camera.invVP().approx(camera.VP().inversed()));
+		assertInverses(camera);
+		camera.fovNearFar(toRadians(45), 1, 200);
+		camera.V();
+		camera.P();
+		assertInverses(camera);
+		camera.rotateAroundYAxis(1).roll(0.3f);
+		assertInverses(camera);
+
+		/// Cached until something changes
+		const matrix* inv = &camera.invVP();
+		const matrix before = *inv;
+		Assert::IsTrue(&camera.invVP() == inv && camera.invVP() == before);
+	}
+	TEST_METHOD(camera2d_inverses) {
+		Camera2D camera;
+		camera.init({800, 600});
+		assertInverses(camera);
+		camera.moveBy({-30, 45}).setZoom(1.5f, 0.1f, 10);
+		assertInverses(camera);
+		camera.VP();
+		camera.zoomIn(0.2f);
+		Assert::IsTrue(camera.invVP().approx(camera.VP().inversed()));
+		assertInverses(camera);
+		camera.moveTo({10, 20});
+		Assert::IsTrue(camera.invV().approx(camera.V().inversed()));
+		assertInverses(camera);
+	}
+	TEST_METHOD(camera3d_versions) {
+		Camera3D camera;
+		Assert::IsTrue(camera.viewVersion() > 0 && camera.projVersion() > 0);
+		camera.init({800, 600}, {3, 4, 10}, {0, 1, 0}, {0, 0, 0});
+		auto v = camera.viewVersion(), p = camera.projVersion(), vp = camera.viewProjVersion();
+
+		/// Reading the matrices changes nothing
+		camera.VP();
+		camera.invVP();
+		Assert::IsTrue(camera.viewVersion() == v && camera.projVersion() == p && camera.viewProjVersion() == vp);
+
+		camera.moveForward(1);
+		Assert::IsTrue(camera.viewVersion() > v && camera.projVersion() == p && camera.viewProjVersion() > vp);
+		v = camera.viewVersion();
+		vp = camera.viewProjVersion();
+
+		camera.fovNearFar(toRadians(45), 1, 200);
+		Assert::IsTrue(camera.viewVersion() == v && camera.projVersion() > p && camera.viewProjVersion() > vp);
+		p = camera.projVersion();
+		vp = camera.viewProjVersion();
+
+		camera.yaw(0.1f).pitch(0.1f).roll(0.1f).rotateAroundYAxis(0.1f).movePositionRelative({1, 0, 0});
+		Assert::IsTrue(camera.viewVersion() >= v + 5 && camera.projVersion() == p && camera.viewProjVersion() >= vp + 5);
+	}
+	TEST_METHOD(camera2d_versions) {
+		Camera2D camera;
+		camera.init({800, 600});
+		auto v = camera.viewVersion(), p = camera.projVersion(), vp = camera.viewProjVersion();
+		camera.VP2();
+		camera.VP();
+		Assert::IsTrue(camera.viewProjVersion() == vp);
+
+		camera.moveBy({1, 2}).moveTo({3, 4});
+		Assert::IsTrue(camera.viewVersion() == v + 2 && camera.projVersion() == p && camera.viewProjVersion() == vp + 2);
+		v = camera.viewVersion();
+		vp = camera.viewProjVersion();
+
+		camera.setZoom(1, 0.5f, 2).zoomIn(0.1f);
+		Assert::IsTrue(camera.viewVersion() == v && camera.projVersion() == p + 2 && camera.viewProjVersion() == vp + 2);
+		p = camera.projVersion();
+
+		/// Already at the limit
+		camera.zoomIn(1).zoomIn(1);
+		Assert::IsTrue(camera.projVersion() == p + 1);
+	}
+};
+
+}
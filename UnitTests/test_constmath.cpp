@@ -0,0 +1,59 @@
+#include "_pch.h"
+#include "CppUnitTest.h"
+#include "../Maths/maths.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace maths;
+
+namespace UnitTests {
+
+/// Evaluated at compile time
+constexpr auto SINES = cx::table<64>([](std::size_t i) { return trig::sin(i * 2 * PI / 64); });
+constexpr matrix4<float> ROTATE = matrix4<float>::rotateX(PI / 2);
+constexpr matrix4<float> PROJECTION = matrix4<float>::perspectiveFovRH(toRadians(60), 16.0f / 9, 0.1f, 100);
+constexpr matrix4<float> VIEW = matrix4<float>::lookAtRH({0, 5, 10}, {0, 0, 0}, {0, 1, 0});
+constexpr float LENGTH = float3{3, 4, 12}.length();
+constexpr float4 UNIT = float4{1, 2, 2, 4}.normalised();
+
+static_assert(PI > 3.14159f && PI < 3.1416f);
+static_assert(LENGTH == 13);
+static_assert(approxEqual(UNIT.length(), 1));
+static_assert(approxEqual(ROTATE[1][1], 0) && ROTATE[1][2] == 1 && ROTATE[2][1] == -1);
+static_assert(SINES[0] == 0 && SINES[16] == 1);
+static_assert(cx::sqrt(16.0) == 4 && cx::sqrt(0.25f) == 0.5f);
+static_assert(trig::tan(PI / 4) == 1.0f);
+
+TEST_CLASS(test_constmath) {
+public:
+
+	TEST_METHOD(sqrt) {
+		for(double x : {0.0, 1e-310, 1e-20, 0.5, 2.0, 3.0, 12345.678, 1e30, 1.7e308}) {
+			const double r = std::sqrt(x);
+			Assert::IsTrue(std::abs(cx::sqrt(x) - r) <= r * 2.3e-16);
+			Assert::IsTrue(cx::sqrt((float)x) == std::sqrt((float)x) || x > 3e38);
+		}
+		Assert::IsTrue(std::isnan(cx::sqrt(-1.0)));
+		Assert::IsTrue(std::isinf(cx::sqrt(std::numeric_limits<double>::infinity())));
+	}
+	TEST_METHOD(sin_cos_tan) {
+		for(double x = -1000; x <= 1000; x += 0.0371) {
+			Assert::IsTrue(std::abs(cx::sin(x) - std::sin(x)) <= 1e-15 * 1000);
+			Assert::IsTrue(std::abs(cx::cos(x) - std::cos(x)) <= 1e-15 * 1000);
+		}
+		for(double x = -1.5; x <= 1.5; x += 0.01) {
+			Assert::IsTrue(std::abs(cx::tan(x) - std::tan(x)) <= 1e-14);
+		}
+		for(std::size_t i = 0; i < SINES.size(); i++) {
+			Assert::IsTrue(std::abs(SINES[i] - std::sin(i * 2 * PI / 64)) <= 1e-7f);
+		}
+	}
+	TEST_METHOD(same_as_runtime) {
+		volatile float angle = PI / 2, fov = toRadians(60);
+		Assert::IsTrue(ROTATE.approx(matrix4<float>::rotateX(angle)));
+		Assert::IsTrue(PROJECTION.approx(matrix4<float>::perspectiveFovRH(fov, 16.0f / 9, 0.1f, 100)));
+		const float3 eye = {0, angle * 10 / PI, 10};
+		Assert::IsTrue(VIEW.approx(matrix4<float>::lookAtRH(eye, {0, 0, 0}, {0, 1, 0})));
+	}
+};
+
+}
@@ -0,0 +1,91 @@
+#include "_pch.h"
+#include "CppUnitTest.h"
+#include "../Maths/maths.h"
+#include "helpers.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace maths;
+using std::vector;
+
+namespace UnitTests {
+
+TEST_CLASS(test_expr) {
+public:
+
+	TEST_METHOD(arithmetic) {
+		auto a = stream3(23, 1), b = stream3(23, 2), c = stream3(23, 3);
+		float3_stream out;
+		out = (a - b).normalised() * 2.0f + c;
+		Assert::IsTrue(out.size() == a.size());
+		for(auto i = 0u; i < a.size(); i++) {
+			Assert::IsTrue(out.get(i).approx((a.get(i) - b.get(i)).normalised() * 2.0f + c.get(i)));
+		}
+
+		out = -a / 4 - 1;
+		for(auto i = 0u; i < a.size(); i++) {
+			Assert::IsTrue(out.get(i).approx(-a.get(i) / 4 - 1));
+		}
+	}
+	TEST_METHOD(per_element_scalars) {
+		auto a = stream3(23, 1);
+		vector<float> s(a.size());
+		for(auto i = 0u; i < s.size(); i++) s[i] = i * 0.1f;
+
+		float3_stream out;
+		out = a * s + expr::length(a);
+		for(auto i = 0u; i < a.size(); i++) {
+			Assert::IsTrue(out.get(i).approx(a.get(i) * s[i] + a.get(i).length()));
+		}
+	}
+	TEST_METHOD(scalar_results) {
+		auto a = stream3(23, 1), b = stream3(23, 2);
+		vector<float> d(a.size()), len(a.size());
+		expr::evaluate(expr::dot(a, b - a), d);
+		expr::evaluate((a + b).length(), len);
+		for(auto i = 0u; i < a.size(); i++) {
+			Assert::IsTrue(approxEqual(d[i], a.get(i).dot(b.get(i) - a.get(i))));
+			Assert::IsTrue(approxEqual(len[i], (a.get(i) + b.get(i)).length()));
+		}
+	}
+	TEST_METHOD(functions) {
+		auto a = stream3(23, 1), b = stream3(23, 2);
+		float3_stream out;
+		out = expr::cross(a, b);
+		for(auto i = 0u; i < a.size(); i++) {
+			Assert::IsTrue(out.get(i).approx(a.get(i).cross(b.get(i))));
+		}
+		out = expr::lerp(a, b, 0.25f);
+		for(auto i = 0u; i < a.size(); i++) {
+			Assert::IsTrue(out.get(i).approx(a.get(i) + (b.get(i) - a.get(i)) * 0.25f));
+		}
+		out = expr::min(a, b) + expr::abs(expr::max(a, 0));
+		for(auto i = 0u; i < a.size(); i++) {
+			Assert::IsTrue(out.get(i).approx(a.get(i).min(b.get(i)) + a.get(i).max(float3{0, 0, 0}).abs()));
+		}
+	}
+	TEST_METHOD(in_place) {
+		auto a = stream3(23, 1), original = a;
+		a = a * 2 + a;
+		for(auto i = 0u; i < a.size(); i++) {
+			Assert::IsTrue(a.get(i).approx(original.get(i) * 3));
+		}
+	}
+	TEST_METHOD(float2_float4) {
+		float2_stream a;
+		float4_stream b;
+		for(int i = 0; i < 11; i++) {
+			a.push_back({(float)i, i * 2.0f});
+			b.push_back({(float)i, 1, 2, (float)-i});
+		}
+		float2_stream a2;
+		a2 = a * a;
+		float4_stream b2;
+		b2 = expr::normalised(b);
+		for(auto i = 0u; i < a.size(); i++) {
+			Assert::IsTrue(a2.get(i) == a.get(i) * a.get(i));
+			Assert::IsTrue(b2.get(i).approx(b.get(i).normalised()));
+		}
+	}
+};
+
+}
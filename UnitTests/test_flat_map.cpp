@@ -0,0 +1,105 @@
+#include "_pch.h"
+#include "CppUnitTest.h"
+#include "../Maths/maths.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace maths;
+using std::string;
+
+namespace UnitTests {
+
+TEST_CLASS(test_flat_map) {
+public:
+
+	TEST_METHOD(insert_find) {
+		flat_map<int3, int> m;
+		Assert::IsTrue(m.empty());
+		Assert::IsTrue(m.find({1, 2, 3}) == nullptr);
+
+		auto r = m.insert({1, 2, 3}, 10);
+		Assert::IsTrue(r.second && *r.first == 10);
+		r = m.insert({1, 2, 3}, 20);
+		Assert::IsTrue(!r.second && *r.first == 10);
+
+		m[{-4, 5, -6}] = 7;
+		Assert::IsTrue(m.size() == 2);
+		Assert::IsTrue(*m.find({-4, 5, -6}) == 7);
+		Assert::IsTrue(m.contains({1, 2, 3}));
+		Assert::IsTrue(!m.contains({3, 2, 1}));
+		Assert::IsTrue(m[{9, 9, 9}] == 0);
+		Assert::IsTrue(m.size() == 3);
+	}
+	TEST_METHOD(grow) {
+		flat_map<int3, int> m;
+		for(int x = -10; x < 10; x++)
+			for(int y = -10; y < 10; y++)
+				for(int z = -10; z < 10; z++)
+					m[{x, y, z}] = x * 10000 + y * 100 + z;
+
+		Assert::IsTrue(m.size() == 8000);
+		Assert::IsTrue(m.capacity() * 3 / 4 >= m.size());
+		for(int x = -10; x < 10; x++)
+			for(int y = -10; y < 10; y++)
+				for(int z = -10; z < 10; z++)
+					Assert::IsTrue(*m.find({x, y, z}) == x * 10000 + y * 100 + z);
+	}
+	TEST_METHOD(lookup_at_full_load) {
+		/// 12 entries is the most 16 slots hold. Existing keys must not rehash
+		flat_map<int3, int> m;
+		for(int i = 0; i < 12; i++) m[{i, 0, 0}] = i;
+		Assert::IsTrue(m.capacity() == 16);
+		int* p = m.find({5, 0, 0});
+		Assert::IsTrue(&m[{5, 0, 0}] == p);
+		Assert::IsTrue(m.insert({11, 0, 0}, 0).first == m.find({11, 0, 0}));
+		Assert::IsTrue(m.capacity() == 16 && *p == 5);
+
+		m[{12, 0, 0}] = 12;
+		Assert::IsTrue(m.capacity() == 32 && m.size() == 13);
+		for(int i = 0; i < 13; i++) Assert::IsTrue(*m.find({i, 0, 0}) == i);
+	}
+	TEST_METHOD(erase) {
+		flat_map<uint2, int> m;
+		for(unsigned i = 0; i < 1000; i++) m[{i, i * 7}] = (int)i;
+
+		for(unsigned i = 0; i < 1000; i += 2) Assert::IsTrue(m.erase({i, i * 7}));
+		Assert::IsTrue(!m.erase({0, 0}));
+		Assert::IsTrue(m.size() == 500);
+
+		/// Everything left must still be reachable after the back shifts
+		for(unsigned i = 0; i < 1000; i++) {
+			Assert::IsTrue(m.contains({i, i * 7}) == (i % 2 == 1));
+		}
+		for(unsigned i = 0; i < 1000; i += 2) m[{i, i * 7}] = -1;
+		Assert::IsTrue(m.size() == 1000);
+		Assert::IsTrue(*m.find({4, 28}) == -1);
+	}
+	TEST_METHOD(iterate) {
+		flat_map<float2, string> m;
+		m[{0.25f, 0.5f}] = "a";
+		m[{0.5f, 0.25f}] = "b";
+		m[{0.75f, 0.5f}] = "c";
+		m.erase({0.5f, 0.25f});
+
+		string all;
+		for(auto& e : m) all += e.second;
+		std::sort(all.begin(), all.end());
+		Assert::IsTrue(all == "ac");
+
+		const auto& c = m;
+		int n = 0;
+		for(auto it = c.begin(); it != c.end(); ++it) n++;
+		Assert::IsTrue(n == 2);
+
+		m.clear();
+		Assert::IsTrue(m.empty() && m.begin() == m.end());
+	}
+	TEST_METHOD(reserve) {
+		flat_map<int3, int> m(1000);
+		const auto cap = m.capacity();
+		Assert::IsTrue(cap * 3 / 4 >= 1000);
+		for(int i = 0; i < 1000; i++) m[{i, 0, 0}] = i;
+		Assert::IsTrue(m.capacity() == cap);
+	}
+};
+
+}
@@ -0,0 +1,138 @@
+#include "_pch.h"
+#include "CppUnitTest.h"
+#include "../Maths/maths.h"
+#include "helpers.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace maths;
+using std::vector;
+
+namespace UnitTests {
+
+/// Looking down -z from the origin
+static frustum cameraFrustum() {
+	Camera3D camera;
+	camera.init({800, 600}, {0, 0, 0}, {0, 1, 0}, {0, 0, -1}).fovNearFar(toRadians(60), 1, 100);
+	return frustum::fromCamera(camera);
+}
+/// The smallest distance of a sphere from any plane, positive inside
+static float margin(const frustum& f, const float3& c, float r) {
+	float m = f.distance(0, c) + r;
+	for(int i = 1; i < 6; i++) m = std::min(m, f.distance(i, c) + r);
+	return m;
+}
+static float margin(const frustum& f, const aabb3& box) {
+	const float3 e = box.size() * 0.5f;
+	float m = std::numeric_limits<float>::infinity();
+	for(int i = 0; i < 6; i++) {
+		const float4& p = f.planes[i];
+		m = std::min(m, f.distance(i, box.centre()) + e.x * std::fabs(p.x) + e.y * std::fabs(p.y) + e.z * std::fabs(p.z));
+	}
+	return m;
+}
+/// Several chunks with a partial last chunk and an odd tail
+static void spheres(float3_stream& c, vector<float>& r, std::size_t n = 40009) {
+	std::mt19937 rng(5);
+	std::uniform_real_distribution<float> d(-60, 60), radius(0, 4);
+	c.resize(n);
+	r.resize(n);
+	for(std::size_t i = 0; i < n; i++) {
+		c.set(i, {d(rng), d(rng), d(rng) - 50});
+		r[i] = radius(rng);
+	}
+}
+
+TEST_CLASS(test_frustum) {
+public:
+
+	TEST_METHOD(from_matrix) {
+		const frustum f = cameraFrustum();
+		for(auto& p : f.planes) {
+			Assert::IsTrue(approxEqual(float3{p.x, p.y, p.z}.length(), 1));
+		}
+		/// Near and far planes face each other along -z
+		Assert::IsTrue(f.planes[4].approx({0, 0, -1, -1}));
+		Assert::IsTrue(float3{f.planes[5].x, f.planes[5].y, f.planes[5].z}.approx({0, 0, 1}));
+		Assert::IsTrue(std::fabs(f.planes[5].w - 100) <= 1e-3f);
+
+		Assert::IsTrue(f.contains({0, 0, -2}));
+		Assert::IsTrue(f.contains({0, 0, -99}));
+		Assert::IsFalse(f.contains({0, 0, -0.5f}));
+		Assert::IsFalse(f.contains({0, 0, -101}));
+		Assert::IsFalse(f.contains({0, 0, 5}));
+		/// The half fov is 30 degrees vertically
+		Assert::IsTrue(f.contains({0, 5.7f, -10}));
+		Assert::IsFalse(f.contains({0, 5.8f, -10}));
+		Assert::IsFalse(f.contains({0, -5.8f, -10}));
+		Assert::IsTrue(f.contains({7.6f, 0, -10}));
+		Assert::IsFalse(f.contains({7.8f, 0, -10}));
+	}
+	TEST_METHOD(spheres_and_boxes) {
+		const frustum f = cameraFrustum();
+		Assert::IsTrue(f.intersects({0, 0, 1}, 2.5f));
+		Assert::IsFalse(f.intersects({0, 0, 1}, 1.5f));
+		/// 0.63 above the top plane
+		Assert::IsTrue(f.intersects({0, 6.5f, -10}, 1));
+		Assert::IsFalse(f.intersects({0, 6.5f, -10}, 0.5f));
+
+		Assert::IsTrue(f.intersects(aabb3{{-1, -1, -5}, {1, 1, -3}}));
+		Assert::IsTrue(f.intersects(aabb3{{5, -1, -10}, {9, 1, -9}}));
+		Assert::IsFalse(f.intersects(aabb3{{9, -1, -10}, {10, 1, -9}}));
+		Assert::IsFalse(f.intersects(aabb3{{-1, -1, 1}, {1, 1, 2}}));
+	}
+	TEST_METHOD(cull_all) {
+		const frustum f = cameraFrustum();
+		float3_stream c, lo, hi;
+		vector<float> r;
+		spheres(c, r);
+		const std::size_t n = r.size();
+		lo.resize(n);
+		hi.resize(n);
+		for(std::size_t i = 0; i < n; i++) {
+			lo.set(i, c.get(i) - r[i]);
+			hi.set(i, c.get(i) + float3{r[i], r[i] * 0.5f, r[i] * 2});
+		}
+		forEachLevel([&]() {
+			vector<uint64_t> points(maskWords(n), ~0ull), spheres(points.size(), ~0ull), boxes(points.size(), ~0ull);
+			cullPoints(f, c, points);
+			cullSpheres(f, c, r, spheres);
+			cullAabbs(f, lo, hi, boxes);
+
+			std::size_t visible = 0;
+			for(std::size_t i = 0; i < n; i++) {
+				/// Skip the few that are too close to a plane to be exact
+				if(std::fabs(margin(f, c.get(i), 0)) > 1e-4f) {
+					Assert::IsTrue(bit(points, i) == f.contains(c.get(i)));
+				}
+				if(std::fabs(margin(f, c.get(i), r[i])) > 1e-4f) {
+					Assert::IsTrue(bit(spheres, i) == f.intersects(c.get(i), r[i]));
+				}
+				const aabb3 box{lo.get(i), hi.get(i)};
+				if(std::fabs(margin(f, box)) > 1e-4f) {
+					Assert::IsTrue(bit(boxes, i) == f.intersects(box));
+				}
+				visible += bit(spheres, i);
+			}
+			/// Some of each
+			Assert::IsTrue(visible > n / 20 && visible < n / 2);
+			Assert::IsTrue(points.back() >> (n % 64) == 0);
+
+			vector<uint32_t> indices(n, 7), expected(countSet(spheres));
+			compact(spheres, expected);
+			cullSpheres(f, c, r, indices);
+			Assert::IsTrue(indices == expected);
+
+			expected.resize(countSet(boxes));
+			compact(boxes, expected);
+			cullAabbs(f, lo, hi, indices);
+			Assert::IsTrue(indices == expected);
+
+			expected.resize(countSet(points));
+			compact(points, expected);
+			cullPoints(f, c, indices);
+			Assert::IsTrue(indices == expected);
+		});
+	}
+};
+
+}
@@ -0,0 +1,87 @@
+#include "_pch.h"
+#include "CppUnitTest.h"
+#include "../Maths/maths.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace maths;
+using std::vector;
+
+namespace UnitTests {
+
+/// The world matrix of h by walking up the parents
+static matrix expectedWorld(const hierarchy& h, hierarchy::handle n) {
+	const matrix local = matrix::translate(h.translation(n)) * h.rotation(n).toMatrix() * matrix::scale(h.scale(n));
+	const auto p = h.parent(n);
+	return p == hierarchy::NONE ? local : expectedWorld(h, p) * local;
+}
+static void checkAll(const hierarchy& h) {
+	for(hierarchy::handle n = 0; n < h.size(); n++) {
+		Assert::IsTrue(h.worldMatrix(n).approx(expectedWorld(h, n)));
+	}
+}
+
+TEST_CLASS(test_hierarchy) {
+public:
+
+	TEST_METHOD(single_chain) {
+		hierarchy h;
+		const auto a = h.add(hierarchy::NONE, {1, 0, 0});
+		const auto b = h.add(a, {0, 2, 0}, quat::rotateZ(PI / 2));
+		const auto c = h.add(b, {3, 0, 0}, quat::identity(), {2, 2, 2});
+		h.update();
+		Assert::IsTrue(h.depthCount() == 3);
+		Assert::IsTrue(h.parent(c) == b && h.parent(a) == hierarchy::NONE);
+		Assert::IsTrue(h.world(c).translation().approx(float3{1, 5, 0}));
+		Assert::IsTrue(h.world(c).transformDirection({1, 0, 0}).approx(float3{0, 2, 0}));
+
+		h.setTranslation(a, {0, 0, 0});
+		h.update();
+		Assert::IsTrue(h.world(c).translation().approx(float3{0, 5, 0}));
+		checkAll(h);
+	}
+	TEST_METHOD(unsorted_adds) {
+		std::mt19937 rng(5);
+		std::uniform_real_distribution<float> d(-1, 1);
+		hierarchy h;
+		/// Random parents so that depths are added out of order
+		for(int i = 0; i < 2000; i++) {
+			const auto parent = i < 3 ? hierarchy::NONE : (hierarchy::handle)(rng() % i);
+			h.add(parent, {d(rng), d(rng), d(rng)}, quat::fromAxisAngle(float3{d(rng), d(rng), 1}.normalised(), d(rng)),
+				  {1 + d(rng) * 0.5f, 1, 1});
+		}
+		h.update();
+		checkAll(h);
+		for(std::size_t i = 1; i < h.size(); i++) {
+			const auto p = h.parent(h.handleAt(i));
+			/// Parents come before their children
+			Assert::IsTrue(p == hierarchy::NONE || h.worlds().data() + i > &h.world(p));
+		}
+
+		/// Dirty subtrees only
+		for(int i = 0; i < 50; i++) {
+			const auto n = (hierarchy::handle)(rng() % h.size());
+			h.setRotation(n, quat::rotateY(d(rng)));
+		}
+		h.setScale(0, {2, 2, 2});
+		h.update();
+		checkAll(h);
+	}
+	TEST_METHOD(wide_levels) {
+		/// Levels larger than one chunk run in parallel
+		hierarchy h;
+		h.reserve(30001);
+		const auto root = h.add(hierarchy::NONE, {0, 0, 1});
+		vector<hierarchy::handle> level;
+		for(int i = 0; i < 10000; i++) level.push_back(h.add(root, {(float)i, 0, 0}, quat::rotateX(i * 0.001f)));
+		for(int i = 0; i < 20000; i++) h.add(level[i % level.size()], {0, 1, 0}, quat::rotateZ(0.5f));
+		h.update();
+		Assert::IsTrue(h.depthCount() == 3);
+		checkAll(h);
+
+		h.setTranslation(root, {5, 5, 5});
+		h.update();
+		checkAll(h);
+	}
+};
+
+}
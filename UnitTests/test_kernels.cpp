@@ -0,0 +1,86 @@
+#include "_pch.h"
+#include "CppUnitTest.h"
+#include "../Maths/maths.h"
+#include "helpers.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace maths;
+using std::vector;
+
+namespace UnitTests {
+
+TEST_CLASS(test_kernels) {
+public:
+
+	TEST_METHOD(simdLevel) {
+		Assert::IsTrue(maths::simdLevel() <= detectedSimdLevel());
+
+		const SimdLevel original = maths::simdLevel();
+		setSimdLevel(SimdLevel::SSE2);
+		Assert::IsTrue(maths::simdLevel() == SimdLevel::SSE2);
+		Assert::IsTrue(kernels::table().level == SimdLevel::SSE2);
+
+		/// Clamped to what the CPU supports
+		setSimdLevel(SimdLevel::AVX512);
+		Assert::IsTrue(maths::simdLevel() == detectedSimdLevel());
+		setSimdLevel(original);
+	}
+	TEST_METHOD(toString) {
+		Assert::IsTrue(std::string(maths::toString(SimdLevel::SSE2)) == "SSE2");
+		Assert::IsTrue(std::string(maths::toString(SimdLevel::AVX2)) == "AVX2");
+		Assert::IsTrue(std::string(maths::toString(SimdLevel::AVX512)) == "AVX512");
+	}
+	TEST_METHOD(dot_cross_length) {
+		auto a = stream3(71, 1), b = stream3(71, 2);
+		forEachLevel([&]() {
+			vector<float> d(a.size()), len(a.size());
+			float3_stream c(a.size());
+			dot(a, b, d);
+			cross(a, b, c);
+			lengthAll(a, len);
+			for(auto i = 0u; i < a.size(); i++) {
+				Assert::IsTrue(approxEqual(d[i], a.get(i).dot(b.get(i))));
+				Assert::IsTrue(c.get(i).approx(a.get(i).cross(b.get(i))));
+				Assert::IsTrue(approxEqual(len[i], a.get(i).length()));
+			}
+		});
+	}
+	TEST_METHOD(normalise_lerp) {
+		auto a = stream3(71, 1), b = stream3(71, 2);
+		forEachLevel([&]() {
+			float3_stream n = a, l(a.size());
+			normaliseAll(n);
+			lerpAll(a, b, 0.75f, l);
+			for(auto i = 0u; i < a.size(); i++) {
+				Assert::IsTrue(n.get(i).approx(a.get(i).normalised()));
+				Assert::IsTrue(l.get(i).approx(a.get(i) + (b.get(i) - a.get(i)) * 0.75f));
+			}
+		});
+	}
+	TEST_METHOD(transform) {
+		auto m = matrix::translate({1, 2, 3}) * matrix::scale({2, 2, 2});
+		float4_stream v;
+		for(int i = 0; i < 37; i++) v.push_back({(float)i, i * 2.0f, -i * 1.0f, 1});
+		forEachLevel([&]() {
+			float4_stream out(v.size());
+			maths::transform(m, v, out);
+			for(auto i = 0u; i < v.size(); i++) {
+				Assert::IsTrue(out.get(i).approx(m * v.get(i)));
+			}
+		});
+	}
+	TEST_METHOD(madd_scale) {
+		vector<float> a(45), out(45, 1.0f);
+		for(auto i = 0u; i < a.size(); i++) a[i] = (float)i;
+		forEachLevel([&]() {
+			vector<float> r = out;
+			kernels::table().madd(a.data(), 2, r.data(), r.size());
+			kernels::table().scale(r.data(), 0.5f, r.size());
+			for(auto i = 0u; i < r.size(); i++) {
+				Assert::IsTrue(approxEqual(r[i], (1 + a[i] * 2) * 0.5f));
+			}
+		});
+	}
+};
+
+}
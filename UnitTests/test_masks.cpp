@@ -0,0 +1,92 @@
+#include "_pch.h"
+#include "CppUnitTest.h"
+#include "../Maths/maths.h"
+#include "helpers.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace maths;
+using std::vector;
+
+namespace UnitTests {
+
+/// 2 full mask words and a partial one
+static vector<float> values(std::size_t n = 151) {
+	vector<float> v(n);
+	for(std::size_t i = 0; i < n; i++) v[i] = (float)((i * 37) % 101) - 50;
+	return v;
+}
+
+TEST_CLASS(test_masks) {
+public:
+
+	TEST_METHOD(compare) {
+		const auto a = values(), b = values(a.size() + 7);
+		const std::span<const float> bs{b.data() + 7, a.size()};
+		forEachLevel([&]() {
+			vector<uint64_t> m(maskWords(a.size()), ~0ull);
+			maths::compare(a, Compare::LT, 10, m);
+			for(std::size_t i = 0; i < a.size(); i++) Assert::IsTrue(bit(m, i) == (a[i] < 10));
+			/// Unused bits are cleared
+			Assert::IsTrue(m.back() >> (a.size() % 64) == 0);
+
+			maths::compare(a, Compare::GTE, bs, m);
+			for(std::size_t i = 0; i < a.size(); i++) Assert::IsTrue(bit(m, i) == (a[i] >= bs[i]));
+			maths::compare(a, Compare::EQ, 0, m);
+			for(std::size_t i = 0; i < a.size(); i++) Assert::IsTrue(bit(m, i) == (a[i] == 0));
+			maths::compare(a, Compare::NEQ, bs, m);
+			for(std::size_t i = 0; i < a.size(); i++) Assert::IsTrue(bit(m, i) == (a[i] != bs[i]));
+		});
+	}
+	TEST_METHOD(combine_and_compact) {
+		const auto a = values();
+		vector<uint64_t> lo(maskWords(a.size())), hi(lo.size());
+		maths::compare(a, Compare::GT, -20, lo);
+		maths::compare(a, Compare::LT, 20, hi);
+		maskAnd(lo, hi);
+
+		vector<uint32_t> expected;
+		for(uint32_t i = 0; i < a.size(); i++) {
+			if(a[i] > -20 && a[i] < 20) expected.push_back(i);
+		}
+		Assert::IsTrue(countSet(lo) == expected.size());
+		vector<uint32_t> index(countSet(lo));
+		Assert::IsTrue(compact(lo, index) == expected.size());
+		Assert::IsTrue(index == expected);
+
+		maskOr(lo, hi);
+		Assert::IsTrue(lo == hi);
+		maskAndNot(lo, hi);
+		Assert::IsTrue(countSet(lo) == 0);
+	}
+	TEST_METHOD(select_clamp_step) {
+		const auto a = values();
+		vector<float> b(a.size(), 100.0f);
+		forEachLevel([&]() {
+			vector<uint64_t> m(maskWords(a.size()));
+			maths::compare(a, Compare::GT, 0, m);
+			vector<float> out(a.size());
+			selectAll(m, a, b, out);
+			for(std::size_t i = 0; i < a.size(); i++) Assert::IsTrue(out[i] == (a[i] > 0 ? a[i] : 100));
+
+			clampAll(a, -10, 5, out);
+			for(std::size_t i = 0; i < a.size(); i++) Assert::IsTrue(out[i] == std::clamp(a[i], -10.0f, 5.0f));
+			saturateAll(a, out);
+			for(std::size_t i = 0; i < a.size(); i++) Assert::IsTrue(out[i] == std::clamp(a[i], 0.0f, 1.0f));
+			stepAll(3, a, out);
+			for(std::size_t i = 0; i < a.size(); i++) Assert::IsTrue(out[i] == (a[i] < 3 ? 0 : 1));
+		});
+
+		float3_stream s, t, u;
+		for(int i = 0; i < 23; i++) {
+			s.push_back({(float)i, 1, 2});
+			t.push_back({0, 0, 0});
+		}
+		u = s;
+		vector<uint64_t> m(maskWords(s.size()));
+		maths::compare(s.x, Compare::GTE, 10, m);
+		selectAll(m, s, t, u);
+		for(int i = 0; i < 23; i++) Assert::IsTrue(u.get(i) == (i >= 10 ? s.get(i) : float3{0, 0, 0}));
+	}
+};
+
+}
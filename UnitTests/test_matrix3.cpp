@@ -0,0 +1,69 @@
+#include "_pch.h"
+#include "CppUnitTest.h"
+#include "../Maths/maths.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace maths;
+
+namespace UnitTests {
+
+TEST_CLASS(test_matrix3) {
+public:
+
+	TEST_METHOD(construction) {
+		const auto m = float3x3::rowMajor({
+			1, 2, 3,
+			4, 5, 6,
+			7, 8, 9
+		});
+		Assert::IsTrue(m[0] == float3{1, 4, 7});
+		Assert::IsTrue(m == float3x3::columnMajor({1, 4, 7, 2, 5, 8, 3, 6, 9}));
+		Assert::IsTrue(m.transposed() == float3x3::columnMajor({1, 2, 3, 4, 5, 6, 7, 8, 9}));
+
+		const auto upper = float3x3::fromMatrix(matrix::rotateY(0.5f) * matrix::translate({1, 2, 3}));
+		Assert::IsTrue(upper.approx(float3x3::fromMatrix(matrix::rotateY(0.5f))));
+	}
+	TEST_METHOD(operator_mul) {
+		const auto a = float3x3::rowMajor({
+			1, 2, 3,
+			4, 5, 6,
+			7, 8, 9
+		});
+		const auto b = float3x3::rowMajor({
+			-1, 0.5f, 2,
+			3, 1, -2,
+			0, 4, 1
+		});
+		Assert::IsTrue(a * b == float3x3::rowMajor({
+			5, 14.5f, 1,
+			11, 31, 4,
+			17, 47.5f, 7
+		}));
+		Assert::IsTrue(a * float3{1, 0, -1} == float3{-2, -2, -2});
+		Assert::IsTrue(a * float3x3::identity() == a);
+
+		/// 2D homogeneous transforms
+		const auto t = float3x3::translate({1, 2}) * float3x3::rotate(PI / 2) * float3x3::scale({2, 3});
+		Assert::IsTrue((t * float3{1, 1, 1}).approx(float3{-2, 4, 1}));
+		Assert::IsTrue(float3x3::rotate(0.7f).approx(float3x3::fromMatrix(matrix::rotateZ(0.7f))));
+	}
+	TEST_METHOD(inversed) {
+		const auto m = float3x3::rowMajor({
+			2, 0, 1,
+			1, 3, 0,
+			0, 1, 4
+		});
+		Assert::IsTrue(approxEqual(m.determinant(), 25));
+		Assert::IsTrue((m * m.inversed()).approx(float3x3::identity()));
+
+		float3x3 r = float3x3::identity();
+		Assert::IsFalse(float3x3::scale({0, 1}).inversed(r));
+		Assert::IsTrue(r == float3x3::identity());
+		Assert::IsTrue(m.inversed(r) && r.approx(m.inversed()));
+
+		constexpr auto d = double3x3::translate({1, 2}) * double3x3::scale({2, 4});
+		static_assert((d.inversed() * d).approx(double3x3::identity()));
+	}
+};
+
+}
@@ -7,6 +7,9 @@ using namespace maths;
 
 namespace UnitTests {
 
+static constexpr matrix ROTATED = matrix::rotateX(0.3f) * matrix::rotateZ(1.1f);
+static constexpr dmatrix D_ROTATED = dmatrix::rotateX(0.3) * dmatrix::rotateZ(1.1);
+
 TEST_CLASS(test_matrix4) {
 public:
 
@@ -17,6 +20,11 @@ public:
 		Assert::IsTrue(m[2] == float4{0, 0, 0, 0});
 		Assert::IsTrue(m[3] == float4{0, 0, 0, 0});
 	}
+	TEST_METHOD(alignment) {
+		Assert::IsTrue(alignof(matrix) == 32);
+		Assert::IsTrue(sizeof(matrix) == 64);
+		Assert::IsTrue(sizeof(dmatrix) == 128);
+	}
 	TEST_METHOD(ptr) {
 		matrix m;
 		m[1][1] = 3;
@@ -83,30 +91,30 @@ public:
 		float r = toRadians(90);
 		auto t = matrix::rotateX(r);
 		Assert::IsTrue(t[0][0] == 1.0f);
-		Assert::IsTrue(t[1][1] == cos(r));
-		Assert::IsTrue(t[1][2] == sin(r));
-		Assert::IsTrue(t[2][1] == -sin(r));
-		Assert::IsTrue(t[2][2] == cos(r));
+		Assert::IsTrue(approxEqual(t[1][1], cos(r)));
+		Assert::IsTrue(approxEqual(t[1][2], sin(r)));
+		Assert::IsTrue(approxEqual(t[2][1], -sin(r)));
+		Assert::IsTrue(approxEqual(t[2][2], cos(r)));
 		Assert::IsTrue(t[3][3] == 1.0f);
 	}
 	TEST_METHOD(rotateY) {
 		float r = toRadians(90);
 		auto t = matrix::rotateY(r);
-		Assert::IsTrue(t[0][0] == cos(r));
-		Assert::IsTrue(t[0][2] == -sin(r));
+		Assert::IsTrue(approxEqual(t[0][0], cos(r)));
+		Assert::IsTrue(approxEqual(t[0][2], -sin(r)));
 		Assert::IsTrue(t[1][1] == 1.0f);
-		Assert::IsTrue(t[2][0] == sin(r));
-		Assert::IsTrue(t[2][2] == cos(r));
+		Assert::IsTrue(approxEqual(t[2][0], sin(r)));
+		Assert::IsTrue(approxEqual(t[2][2], cos(r)));
 		Assert::IsTrue(t[3][3] == 1.0f);
 	}
 	TEST_METHOD(rotateZ) {
 		float r = toRadians(90);
 		auto t = matrix::rotateZ(r);
 
-		Assert::IsTrue(t[0][0] == cos(r));
-		Assert::IsTrue(t[0][1] == sin(r));
-		Assert::IsTrue(t[1][0] == -sin(r));
-		Assert::IsTrue(t[1][1] == cos(r));
+		Assert::IsTrue(approxEqual(t[0][0], cos(r)));
+		Assert::IsTrue(approxEqual(t[0][1], sin(r)));
+		Assert::IsTrue(approxEqual(t[1][0], -sin(r)));
+		Assert::IsTrue(approxEqual(t[1][1], cos(r)));
 		Assert::IsTrue(t[2][2] == 1.0f);
 		Assert::IsTrue(t[3][3] == 1.0f);
 	}
@@ -148,22 +156,200 @@ public:
 
 	}
 	TEST_METHOD(operator_mul_matrix) {
+		const auto a = matrix::rowMajor({
+			1, 2, 3, 4,
+			5, 6, 7, 8,
+			9, 10, 11, 12,
+			13, 14, 15, 16
+		});
+		const auto b = matrix::rowMajor({
+			-1, 0.5f, 2, 0,
+			3, 1, -2, 1,
+			0, 4, 1, -3,
+			2, 0, 0, 1
+		});
+		const auto expected = matrix::rowMajor({
+			13, 14.5f, 1, -3,
+			29, 36.5f, 5, -7,
+			45, 58.5f, 9, -11,
+			61, 80.5f, 13, -15
+		});
+		Assert::IsTrue(a * b == expected);
+		Assert::IsTrue(a * matrix::identity() == a);
+		Assert::IsTrue(matrix::identity() * b == b);
+
+		/// Same result as the scalar (constant evaluated) code
+		constexpr auto r = ROTATED * matrix::translate({1, 2, 3}) * matrix::scale({2, 3, 4});
+		Assert::IsTrue(ROTATED * matrix::translate({1, 2, 3}) * matrix::scale({2, 3, 4}) == r);
 
+		const auto d = dmatrix::rowMajor({
+			1, 2, 3, 4,
+			5, 6, 7, 8,
+			9, 10, 11, 12,
+			13, 14, 15, 16
+		}) * dmatrix::identity();
+		Assert::IsTrue(d[0] == double4{1, 5, 9, 13});
+
+		const auto da = dmatrix::rowMajor({
+			1, 2, 3, 4,
+			5, 6, 7, 8,
+			9, 10, 11, 12,
+			13, 14, 15, 16
+		});
+		const auto db = dmatrix::rowMajor({
+			-1, 0.5, 2, 0,
+			3, 1, -2, 1,
+			0, 4, 1, -3,
+			2, 0, 0, 1
+		});
+		const auto dp = da * db;
+		for(int i = 0; i < 4; i++) {
+			Assert::IsTrue(dp[i] == double4{expected[i].x, expected[i].y, expected[i].z, expected[i].w});
+		}
+		/// Same result as the scalar (constant evaluated) code
+		constexpr auto dr = D_ROTATED * dmatrix::translate({1, 2, 3});
+		Assert::IsTrue(D_ROTATED * dmatrix::translate({1, 2, 3}) == dr);
 	}
 	TEST_METHOD(operator_div_matrix) {
 
 	}
 	TEST_METHOD(operator_mul_vector4) {
+		const auto m = matrix::rowMajor({
+			1, 2, 3, 4,
+			5, 6, 7, 8,
+			9, 10, 11, 12,
+			13, 14, 15, 16
+		});
+		Assert::IsTrue(m * float4{1, 0, -1, 2} == float4{6, 14, 22, 30});
+		Assert::IsTrue(matrix::translate({1, 2, 3}) * float4{1, 1, 1, 1} == float4{2, 3, 4, 1});
+		Assert::IsTrue(matrix::translate({1, 2, 3}) * float4{1, 1, 1, 0} == float4{1, 1, 1, 0});
 
+		constexpr auto v = ROTATED * float4{1, 2, 3, 1};
+		Assert::IsTrue(ROTATED * float4{1, 2, 3, 1} == v);
+
+		/// row vector * matrix == transposed matrix * column vector
+		Assert::IsTrue(float4{1, 0, -1, 2} * m == m.transposed() * float4{1, 0, -1, 2});
+
+		const auto d = dmatrix::rowMajor({
+			1, 2, 3, 4,
+			5, 6, 7, 8,
+			9, 10, 11, 12,
+			13, 14, 15, 16
+		});
+		Assert::IsTrue(d * double4{1, 0, -1, 2} == double4{6, 14, 22, 30});
+		constexpr auto dv = D_ROTATED * double4{1, 2, 3, 1};
+		Assert::IsTrue(D_ROTATED * double4{1, 2, 3, 1} == dv);
+		constexpr auto cv = dmatrix::translate({1, 2, 3}) * double4{1, 1, 1, 1};
+		static_assert(cv == double4{2, 3, 4, 1});
 	}
 	TEST_METHOD(transposed) {
-		
+		const auto m = matrix4<float>::rowMajor({
+			1, 2, 3, 4,
+			5, 6, 7, 8,
+			9, 10, 11, 12,
+			13, 14, 15, 16
+		});
+		const auto t = matrix4<float>::columnMajor({
+			1, 2, 3, 4,
+			5, 6, 7, 8,
+			9, 10, 11, 12,
+			13, 14, 15, 16
+		});
+		Assert::IsTrue(m.transposed() == t);
+		Assert::IsTrue(t.transposed() == m);
+
+		const auto d = matrix4<double>::rowMajor({
+			1, 2, 3, 4,
+			5, 6, 7, 8,
+			9, 10, 11, 12,
+			13, 14, 15, 16
+		});
+		Assert::IsTrue(d.transposed().transposed() == d);
+		Assert::IsTrue(d.transposed()[0] == double4{1, 2, 3, 4});
 	}
 	TEST_METHOD(determinant) {
-
+		Assert::IsTrue(matrix::identity().determinant() == 1);
+		Assert::IsTrue(matrix::scale({2, 3, 4}).determinant() == 24);
+		Assert::IsTrue(approxEqual(ROTATED.determinant(), 1));
+		const auto m = matrix::rowMajor({
+			2, 0, 1, 3,
+			1, -1, 0, 2,
+			0, 4, 1, -2,
+			3, 1, 0, 1
+		});
+		Assert::IsTrue(m.determinant() == -6);
+		Assert::IsTrue(m.transposed().determinant() == -6);
+		constexpr auto d = dmatrix::rowMajor({
+			1, 2, 3, 4,
+			5, 6, 7, 8,
+			9, 10, 11, 12,
+			13, 14, 15, 16
+		}).determinant();
+		static_assert(d == 0);
 	}
 	TEST_METHOD(inversed) {
+		const auto m = matrix::rowMajor({
+			2, 0, 1, 3,
+			1, -1, 0, 2,
+			0, 4, 1, -2,
+			3, 1, 0, 1
+		});
+		const auto inv = m.inversed();
+		Assert::IsTrue((m * inv).approx(matrix::identity()));
+		Assert::IsTrue((inv * m).approx(matrix::identity()));
+		Assert::IsTrue(inv.inversed().approx(m));
 
+		/// SIMD and scalar versions agree
+		constexpr auto c = (ROTATED * matrix::translate({1, 2, 3}) * matrix::scale({2, 3, 4})).inversed();
+		Assert::IsTrue((ROTATED * matrix::translate({1, 2, 3}) * matrix::scale({2, 3, 4})).inversed().approx(c));
+		const auto d = dmatrix::rowMajor({
+			2, 0, 1, 3,
+			1, -1, 0, 2,
+			0, 4, 1, -2,
+			3, 1, 0, 1
+		});
+		Assert::IsTrue((d * d.inversed()).approx(dmatrix::identity()));
+		constexpr auto cd = dmatrix::rotateY(0.5) * dmatrix::translate({1, 2, 3});
+		constexpr auto ci = cd.inversed();
+		Assert::IsTrue(cd.inversed().approx(ci));
+		Assert::IsTrue(approxEqual((float)cd.determinant(), 1));
+		dmatrix singular;
+		Assert::IsFalse(dmatrix::scale({1, 0, 1}).inversed(singular));
+
+		/// Singular
+		matrix result = matrix::identity();
+		Assert::IsFalse(matrix::scale({1, 0, 1}).inversed(result));
+		Assert::IsTrue(result == matrix::identity());
+		Assert::IsTrue(m.inversed(result));
+		Assert::IsTrue(result == inv);
+	}
+	TEST_METHOD(inversedAffine) {
+		const auto m = matrix::translate({1, -2, 3}) * ROTATED * matrix::scale({2, 0.5f, 4});
+		Assert::IsTrue(m.inversedAffine().approx(m.inversed()));
+		Assert::IsTrue((m * m.inversedAffine()).approx(matrix::identity()));
+		Assert::IsTrue(matrix::identity().inversedAffine() == matrix::identity());
+		constexpr auto c = matrix::translate({1, -2, 3}).inversedAffine();
+		Assert::IsTrue(c == matrix::translate({-1, 2, -3}));
+	}
+	TEST_METHOD(inversedRigid) {
+		const auto view = matrix::lookAtRH({3, 5, 10}, {0, 1, 0}, {0, 1, 0});
+		Assert::IsTrue(view.inversedRigid().approx(view.inversed()));
+		Assert::IsTrue((view * view.inversedRigid()).approx(matrix::identity()));
+		const auto m = matrix::translate({1, -2, 3}) * ROTATED;
+		Assert::IsTrue(m.inversedRigid().approx(m.inversed()));
+		Assert::IsTrue(m.inversedRigid().approx(m.inversedAffine()));
+	}
+	TEST_METHOD(inversedPerspective) {
+		for(auto& p : {matrix::perspectiveFovRH(toRadians(60), 1.5f, 0.1f, 100), matrix::perspectiveFovLH(toRadians(90), 0.75f, 1, 50)}) {
+			Assert::IsTrue(p.inversedPerspective().approx(p.inversed()));
+			Assert::IsTrue((p * p.inversedPerspective()).approx(matrix::identity()));
+		}
+	}
+	TEST_METHOD(inversedOrtho) {
+		for(auto& o : {matrix::orthoRH(800, -600, 0, 100), matrix::orthoLH(640, 480, 1, 10), matrix::translate({1, -2, 3}) * matrix::scale({2, 4, 0.5f})}) {
+			Assert::IsTrue(o.inversedOrtho().approx(o.inversed()));
+			Assert::IsTrue((o * o.inversedOrtho()).approx(matrix::identity()));
+		}
 	}
 };
 
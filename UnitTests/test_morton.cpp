@@ -0,0 +1,98 @@
+#include "_pch.h"
+#include "CppUnitTest.h"
+#include "../Maths/maths.h"
+#include "helpers.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace maths;
+using std::vector;
+
+namespace UnitTests {
+
+TEST_CLASS(test_morton) {
+public:
+
+	TEST_METHOD(encode2) {
+		Assert::IsTrue(morton::encode(uint2{0, 0}) == 0);
+		Assert::IsTrue(morton::encode(uint2{1, 0}) == 1);
+		Assert::IsTrue(morton::encode(uint2{0, 1}) == 2);
+		Assert::IsTrue(morton::encode(uint2{3, 3}) == 15);
+		Assert::IsTrue(morton::encode(uint2{0xffff, 0}) == 0x55555555u);
+		Assert::IsTrue(morton::encode<uint64_t>(uint2{0xffffffff, 0}) == 0x5555555555555555ull);
+		Assert::IsTrue(morton::encode<uint64_t>(uint2{0, 0xffffffff}) == 0xaaaaaaaaaaaaaaaaull);
+
+		for(uint32_t i = 0; i < 1000; i++) {
+			const uint2 v{i * 37 % 65536, i * 101 % 65536};
+			Assert::IsTrue(morton::decode2(morton::encode(v)) == v);
+			const uint2 w{i * 4000037u, i * 1000003u};
+			Assert::IsTrue(morton::decode2(morton::encode<uint64_t>(w)) == w);
+		}
+	}
+	TEST_METHOD(encode3) {
+		Assert::IsTrue(morton::encode(uint3{1, 0, 0}) == 1);
+		Assert::IsTrue(morton::encode(uint3{0, 1, 0}) == 2);
+		Assert::IsTrue(morton::encode(uint3{0, 0, 1}) == 4);
+		Assert::IsTrue(morton::encode(uint3{1, 1, 1}) == 7);
+		Assert::IsTrue(morton::encode(uint3{0x3ff, 0x3ff, 0x3ff}) == 0x3fffffffu);
+		Assert::IsTrue(morton::encode<uint64_t>(uint3{0x1fffff, 0x1fffff, 0x1fffff}) == 0x7fffffffffffffffull);
+		/// Coordinates out of range are masked
+		Assert::IsTrue(morton::encode(uint3{0x400, 0, 0}) == 0);
+
+		for(uint32_t i = 0; i < 1000; i++) {
+			const uint3 v{i % 1024, i * 7 % 1024, i * 13 % 1024};
+			Assert::IsTrue(morton::decode3(morton::encode(v)) == v);
+			const uint3 w{i * 2011 % 0x200000, i * 1999 % 0x200000, i * 4099 % 0x200000};
+			Assert::IsTrue(morton::decode3(morton::encode<uint64_t>(w)) == w);
+		}
+	}
+	TEST_METHOD(batch) {
+		vector<uint2> in2;
+		vector<uint3> in3;
+		for(uint32_t i = 0; i < 37; i++) {
+			in2.push_back({i * 4000037u, i * 1000003u});
+			in3.push_back({i * 2011 % 0x200000, i * 1999 % 0x200000, i * 4099 % 0x200000});
+		}
+		forEachLevel([&]() {
+			vector<uint64_t> c2(in2.size()), c3(in3.size());
+			vector<uint2> out2(in2.size());
+			vector<uint3> out3(in3.size());
+			morton::encode(in2, c2);
+			morton::encode(in3, c3);
+			morton::decode(c2, out2);
+			morton::decode(c3, out3);
+			for(auto i = 0u; i < in2.size(); i++) {
+				Assert::IsTrue(c2[i] == morton::encode<uint64_t>(in2[i]));
+				Assert::IsTrue(c3[i] == morton::encode<uint64_t>(in3[i]));
+				Assert::IsTrue(out2[i] == in2[i]);
+				Assert::IsTrue(out3[i] == in3[i]);
+			}
+		});
+	}
+	TEST_METHOD(sortByKey) {
+		vector<uint64_t> keys = {5, 0x100000000ull, 3, 5, 0, 0xff00};
+		vector<uint32_t> values = {0, 1, 2, 3, 4, 5};
+		morton::sortByKey(keys, values);
+		Assert::IsTrue(keys == vector<uint64_t>{0, 3, 5, 5, 0xff00, 0x100000000ull});
+		/// Stable
+		Assert::IsTrue(values == vector<uint32_t>{4, 2, 0, 3, 5, 1});
+	}
+	TEST_METHOD(sort) {
+		/// A 4x4x4 grid in reverse order sorts into Z-order
+		vector<float3> points;
+		for(int i = 63; i >= 0; i--) {
+			const uint3 c = morton::decode3((uint32_t)i);
+			points.push_back({(float)c.x, (float)c.y, (float)c.z});
+		}
+		morton::sort(points);
+		for(int i = 0; i < 64; i++) {
+			const uint3 c = morton::decode3((uint32_t)i);
+			Assert::IsTrue(points[i] == float3{(float)c.x, (float)c.y, (float)c.z});
+		}
+
+		const auto index = morton::order(vector<float3>{{1, 1, 1}, {0, 0, 0}, {1, 0, 0}});
+		Assert::IsTrue(index == vector<uint32_t>{1, 2, 0});
+		Assert::IsTrue(morton::order(vector<float3>{}).empty());
+	}
+};
+
+}
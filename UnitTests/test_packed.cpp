@@ -0,0 +1,143 @@
+#include "_pch.h"
+#include "CppUnitTest.h"
+#include "../Maths/maths.h"
+#include "helpers.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace maths;
+using std::vector;
+
+namespace UnitTests {
+
+/// 37 values so that the padded tail is exercised at every width
+static vector<float4> colours() {
+	vector<float4> v;
+	for(int i = 0; i < 37; i++) {
+		v.push_back({i / 36.0f, 1 - i / 36.0f, i * 0.37f - 6, (i % 5) / 4.0f});
+	}
+	return v;
+}
+
+TEST_CLASS(test_packed) {
+public:
+
+	TEST_METHOD(half) {
+		Assert::IsTrue(maths::half(1.0f).bits == 0x3c00);
+		Assert::IsTrue(maths::half(-2.0f).bits == 0xc000);
+		Assert::IsTrue(maths::half(65504.0f).bits == 0x7bff);
+		Assert::IsTrue(maths::half(1e6f).bits == 0x7c00);
+		Assert::IsTrue(maths::half(5.9604645e-8f).bits == 0x0001);
+		Assert::IsTrue(maths::half(0.0f).bits == 0);
+		Assert::IsTrue(std::isnan((float)maths::half(NAN)));
+
+		/// Round half to even
+		Assert::IsTrue(maths::half(1.0f + 1.0f / 2048).bits == 0x3c00);
+		Assert::IsTrue(maths::half(1.0f + 3.0f / 2048).bits == 0x3c02);
+
+		for(int i = -1000; i <= 1000; i++) {
+			const float f = i * 0.37f;
+			Assert::IsTrue(std::fabs((float)maths::half(f) - f) <= std::fabs(f) / 2048);
+		}
+		Assert::IsTrue((float)maths::half(5.9604645e-8f) == 5.9604645e-8f);
+	}
+	TEST_METHOD(half4) {
+		auto in = colours();
+		vector<maths::half4> expected;
+		for(auto& c : in) expected.push_back(maths::half4{c});
+
+		forEachLevel([&]() {
+			vector<maths::half4> h(in.size());
+			vector<float4> out(in.size());
+			pack(in, h);
+			unpack(h, out);
+			for(auto i = 0u; i < in.size(); i++) {
+				Assert::IsTrue(h[i].x == expected[i].x && h[i].y == expected[i].y && h[i].z == expected[i].z && h[i].w == expected[i].w);
+				Assert::IsTrue(out[i] == float4(expected[i]));
+			}
+		});
+	}
+	TEST_METHOD(half2) {
+		vector<float2> in;
+		for(int i = 0; i < 19; i++) in.push_back({i * 0.1f, -i * 100.0f});
+		forEachLevel([&]() {
+			vector<maths::half2> h(in.size());
+			vector<float2> out(in.size());
+			pack(in, h);
+			unpack(h, out);
+			for(auto i = 0u; i < in.size(); i++) {
+				Assert::IsTrue(out[i] == float2(maths::half2{in[i]}));
+			}
+		});
+	}
+	TEST_METHOD(snorm16x4) {
+		Assert::IsTrue(float4(maths::snorm16x4{float4{-2, -1, 0, 1}}) == float4{-1, -1, 0, 1});
+		Assert::IsTrue(maths::snorm16x4{float4{-2, -1, 0, 1}}.x == -32767);
+
+		auto in = colours();
+		forEachLevel([&]() {
+			vector<maths::snorm16x4> p(in.size());
+			vector<float4> out(in.size());
+			pack(in, p);
+			unpack(p, out);
+			for(auto i = 0u; i < in.size(); i++) {
+				Assert::IsTrue(out[i] == float4(maths::snorm16x4{in[i]}));
+			}
+		});
+	}
+	TEST_METHOD(unorm8x4) {
+		Assert::IsTrue(float4(maths::unorm8x4{float4{-1, 0, 0.5f, 2}}) == float4{0, 0, 128 / 255.0f, 1});
+
+		auto in = colours();
+		forEachLevel([&]() {
+			vector<maths::unorm8x4> p(in.size());
+			vector<float4> out(in.size());
+			pack(in, p);
+			unpack(p, out);
+			for(auto i = 0u; i < in.size(); i++) {
+				Assert::IsTrue(out[i] == float4(maths::unorm8x4{in[i]}));
+				Assert::IsTrue(std::fabs(out[i].x - in[i].x) <= 0.5f / 255 + 1e-6f);
+			}
+		});
+	}
+	TEST_METHOD(octNormal) {
+		vector<float3> in;
+		for(int i = 0; i < 37; i++) {
+			in.push_back(float3{std::sin(i * 0.7f), std::cos(i * 1.3f), i * 0.1f - 1.8f}.normalised());
+		}
+		in.push_back({0, 0, 1});
+		in.push_back({0, 0, -1});
+		in.push_back({-1, 0, 0});
+
+		forEachLevel([&]() {
+			vector<maths::octNormal> p(in.size());
+			vector<float3> out(in.size());
+			pack(in, p);
+			unpack(p, out);
+			for(auto i = 0u; i < in.size(); i++) {
+				Assert::IsTrue(out[i].approx(in[i]));
+				Assert::IsTrue(float3(maths::octNormal{in[i]}).approx(in[i]));
+				Assert::IsTrue(approxEqual(out[i].length(), 1));
+			}
+		});
+	}
+	TEST_METHOD(rgb10a2) {
+		const maths::rgb10a2 white{float4{1, 1, 1, 1}};
+		Assert::IsTrue(white.bits == 0xffffffff);
+		Assert::IsTrue(float4(white) == float4{1, 1, 1, 1});
+		Assert::IsTrue(maths::rgb10a2{float4{1, 0, 0, 0}}.bits == 0x3ff);
+
+		auto in = colours();
+		forEachLevel([&]() {
+			vector<maths::rgb10a2> p(in.size());
+			vector<float4> out(in.size());
+			pack(in, p);
+			unpack(p, out);
+			for(auto i = 0u; i < in.size(); i++) {
+				Assert::IsTrue(p[i].bits == maths::rgb10a2{in[i]}.bits);
+				Assert::IsTrue(out[i] == float4(p[i]));
+			}
+		});
+	}
+};
+
+}
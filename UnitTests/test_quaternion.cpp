@@ -0,0 +1,104 @@
+#include "_pch.h"
+#include "CppUnitTest.h"
+#include "../Maths/maths.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace maths;
+
+namespace UnitTests {
+
+static float3 mulPoint(const matrix& m, const float3& p) {
+	const float4 r = m * float4{p.x, p.y, p.z, 1};
+	return {r.x, r.y, r.z};
+}
+
+TEST_CLASS(test_quaternion) {
+public:
+
+	TEST_METHOD(size) {
+		Assert::IsTrue(sizeof(quat) == 16);
+		Assert::IsTrue(sizeof(dualquat) == 32);
+		Assert::IsTrue(sizeof(ddualquat) == 64);
+	}
+	TEST_METHOD(rotations_match_matrix) {
+		Assert::IsTrue(quat::rotateX(0.7f).toMatrix().approx(matrix::rotateX(0.7f)));
+		Assert::IsTrue(quat::rotateY(0.7f).toMatrix().approx(matrix::rotateY(0.7f)));
+		Assert::IsTrue(quat::rotateZ(-1.3f).toMatrix().approx(matrix::rotateZ(-1.3f)));
+		Assert::IsTrue(quat::identity().toMatrix() == matrix::identity());
+
+		const float3 v{1, -2, 0.5f};
+		Assert::IsTrue(quat::rotateX(0.7f).rotate(v).approx(v.rotatedAroundX(0.7f)));
+		Assert::IsTrue(quat::rotateY(0.7f).rotate(v).approx(v.rotatedAroundY(0.7f)));
+		Assert::IsTrue(quat::rotateZ(0.7f).rotate(v).approx(v.rotatedAroundZ(0.7f)));
+
+		const auto axis = float3{1, 2, -1}.normalised();
+		Assert::IsTrue(quat::fromAxisAngle(axis, 2.0f).rotate(axis).approx(axis));
+	}
+	TEST_METHOD(multiply) {
+		const auto a = quat::rotateX(0.3f), b = quat::rotateZ(1.1f);
+		Assert::IsTrue((a * b).toMatrix().approx(matrix::rotateX(0.3f) * matrix::rotateZ(1.1f)));
+		Assert::IsTrue((a * quat::identity()) == a);
+		Assert::IsTrue((a * a.conjugate()).approx(quat::identity()));
+		const quat s = a * 2.0f;
+		Assert::IsTrue((s * s.inversed()).approx(quat::identity()));
+
+		constexpr auto c = dquat::rotateY(0.5) * dquat::rotateY(0.25);
+		static_assert(c.approx(dquat::rotateY(0.75)));
+	}
+	TEST_METHOD(matrix_conversion) {
+		/// Each branch of fromMatrix
+		const float angles[] = {0.2f, 2.9f, -2.9f, 3.1f};
+		for(float r : angles) {
+			for(const auto& q : {quat::rotateX(r), quat::rotateY(r), quat::rotateZ(r),
+								 quat::fromAxisAngle(float3{1, 1, 1}.normalised(), r)}) {
+				const auto back = quat::fromMatrix(q.toMatrix());
+				Assert::IsTrue(back.approx(q) || back.approx(-q));
+			}
+		}
+	}
+	TEST_METHOD(interpolation) {
+		const auto a = quat::rotateY(0.2f), b = quat::rotateY(1.4f);
+		Assert::IsTrue(a.slerp(b, 0).approx(a));
+		Assert::IsTrue(a.slerp(b, 1).approx(b));
+		Assert::IsTrue(a.slerp(b, 0.25f).approx(quat::rotateY(0.5f)));
+		Assert::IsTrue(approxEqual(a.nlerp(b, 0.5f).length(), 1));
+		Assert::IsTrue(a.nlerp(b, 0.5f).approx(quat::rotateY(0.8f)));
+
+		/// Shortest path
+		Assert::IsTrue(a.slerp(-b, 0.25f).approx(quat::rotateY(0.5f)));
+		/// Almost parallel
+		Assert::IsTrue(a.slerp(a, 0.5f).approx(a));
+	}
+	TEST_METHOD(dual_quaternion) {
+		const auto r = quat::rotateX(0.3f) * quat::rotateZ(1.1f);
+		const float3 t{1, -2, 3};
+		const auto dq = dualquat::fromRotationTranslation(r, t);
+		const matrix m = matrix::translate(t) * r.toMatrix();
+		Assert::IsTrue(dq.translation().approx(t));
+		Assert::IsTrue(dq.toMatrix().approx(m));
+		Assert::IsTrue(dualquat::fromMatrix(m).approx(dq));
+
+		const float3 p{0.5f, 2, -1};
+		Assert::IsTrue(dq.transformPoint(p).approx(mulPoint(m, p)));
+		Assert::IsTrue(dq.transformDirection(p).approx(r.rotate(p)));
+		Assert::IsTrue(dq.inversed().transformPoint(dq.transformPoint(p)).approx(p));
+
+		const auto other = dualquat::translate({0, 1, 0}) * dualquat::fromRotationTranslation(quat::rotateY(0.4f), {});
+		Assert::IsTrue((other * dq).toMatrix().approx(other.toMatrix() * m));
+	}
+	TEST_METHOD(blend) {
+		const dualquat a = dualquat::fromRotationTranslation(quat::rotateY(0.2f), {1, 0, 0});
+		const dualquat b = dualquat::fromRotationTranslation(quat::rotateY(0.6f), {1, 0, 0});
+		const dualquat dqs[] = {a, b};
+		const float w[] = {0.5f, 0.5f};
+		const auto r = dualquat::blend(dqs, w);
+		Assert::IsTrue(r.real.approx(quat::rotateY(0.4f)));
+		Assert::IsTrue(r.translation().approx(float3{1, 0, 0}));
+
+		/// The opposite hemisphere version of b blends the same way
+		const dualquat flipped[] = {a, b * -1.0f};
+		Assert::IsTrue(dualquat::blend(flipped, w).approx(r));
+	}
+};
+
+}
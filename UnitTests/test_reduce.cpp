@@ -0,0 +1,147 @@
+#include "_pch.h"
+#include "CppUnitTest.h"
+#include "../Maths/maths.h"
+#include "helpers.h"
+#include <atomic>
+#include <thread>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace maths;
+using std::vector;
+
+namespace UnitTests {
+
+/// More than 3 chunks with a partial last chunk and an odd SIMD tail
+static vector<float3> points(std::size_t n = 200003) {
+	return randomPoints3(n, 7, {-100, 900, -1}, {100, 1100, 1});
+}
+
+TEST_CLASS(test_reduce) {
+public:
+
+	TEST_METHOD(bounds) {
+		const auto p = points();
+		aabb3 expected;
+		for(auto& v : p) expected = expected.merged(v);
+
+		forEachLevel([&]() {
+			const aabb3 b = boundsOf(p);
+			Assert::IsTrue(b == expected);
+			Assert::IsTrue(minOf(p) == expected.min);
+			Assert::IsTrue(maxOf(p) == expected.max);
+		});
+
+		vector<float4> p4;
+		for(int i = 0; i < 37; i++) p4.push_back({(float)i, (float)-i, i * 0.5f, 1});
+		const aabb4 b4 = boundsOf(p4);
+		Assert::IsTrue(b4.min == float4{0, -36, 0, 1});
+		Assert::IsTrue(b4.max == float4{36, 0, 18, 1});
+		Assert::IsTrue(b4.centre() == float4{18, -18, 9, 1});
+
+		Assert::IsTrue(boundsOf(vector<float3>{}).empty());
+		Assert::IsFalse(boundsOf(vector<float3>{{1, 2, 3}}).empty());
+		Assert::IsTrue(boundsOf(vector<float3>{{1, 2, 3}}).contains({1, 2, 3}));
+	}
+	TEST_METHOD(sum_and_mean) {
+		const auto p = points();
+		double expected[3] = {};
+		for(auto& v : p) {
+			expected[0] += v.x;
+			expected[1] += v.y;
+			expected[2] += v.z;
+		}
+		forEachLevel([&]() {
+			const float3 s = sumOf(p);
+			Assert::IsTrue(std::abs(s.x - expected[0]) <= 1e-6 * std::abs(expected[0]) + 1);
+			Assert::IsTrue(std::abs(s.y - expected[1]) <= 1e-6 * std::abs(expected[1]));
+			Assert::IsTrue(std::abs(s.z - expected[2]) <= 1e-6 * std::abs(expected[2]) + 0.01);
+			const float3 m = meanOf(p);
+			Assert::IsTrue(std::abs(m.y - expected[1] / p.size()) <= 1e-4);
+		});
+
+		/// Naive float summation of 10 million 0.1s is out by several percent
+		vector<float3> small(10000000, float3{0.1f, 1, 0});
+		const float3 s = sumOf(small);
+		Assert::IsTrue(std::abs(s.x - 1000000.0) < 1);
+		Assert::IsTrue(s.y == 10000000);
+		Assert::IsTrue(meanOf(vector<float3>{}) == float3{0, 0, 0});
+
+		vector<float4> p4 = {{1, 2, 3, 4}, {5, 6, 7, 8}};
+		Assert::IsTrue(sumOf(p4) == float4{6, 8, 10, 12});
+		Assert::IsTrue(meanOf(p4) == float4{3, 4, 5, 6});
+	}
+	TEST_METHOD(arg_min_max) {
+		const auto p = points();
+		const float3 dir = float3{1, 2, -3}.normalised();
+		std::size_t lo = 0, hi = 0;
+		for(std::size_t i = 1; i < p.size(); i++) {
+			if(p[i].dot(dir) < p[lo].dot(dir)) lo = i;
+			if(p[i].dot(dir) > p[hi].dot(dir)) hi = i;
+		}
+		Assert::IsTrue(argMin(p, dir) == lo);
+		Assert::IsTrue(argMax(p, dir) == hi);
+
+		/// Ties go to the lowest index, across chunks too
+		vector<float> v(150000, 1.0f);
+		v[70000] = 5;
+		v[140000] = 5;
+		v[100] = -1;
+		v[90000] = -1;
+		Assert::IsTrue(argMax(v) == 70000);
+		Assert::IsTrue(argMin(v) == 100);
+		Assert::IsTrue(argMin(std::span<const float>{}) == 0);
+	}
+	TEST_METHOD(thread_count_independent) {
+		const auto p = points(1000003);
+		const unsigned original = parallel::threadCount();
+		parallel::setThreadCount(1);
+		const aabb3 b = boundsOf(p);
+		const float3 s = sumOf(p);
+		const std::size_t a = argMax(p, {0, 1, 0});
+		for(unsigned n : {2u, 3u, 8u, 0u}) {
+			parallel::setThreadCount(n);
+			Assert::IsTrue(boundsOf(p) == b);
+			Assert::IsTrue(sumOf(p) == s);
+			Assert::IsTrue(argMax(p, {0, 1, 0}) == a);
+		}
+		parallel::setThreadCount(original);
+	}
+	TEST_METHOD(parallel_forEach) {
+		vector<int> hits(1000);
+		parallel::forEach(hits.size(), [&](std::size_t i) {
+			/// Nested calls run serially
+			parallel::forEach(2, [&](std::size_t) { hits[i]++; });
+		});
+		for(auto h : hits) Assert::IsTrue(h == 2);
+
+		bool thrown = false;
+		try {
+			parallel::forEach(100, [](std::size_t i) { if(i == 50) throw std::runtime_error("x"); });
+		} catch(const std::runtime_error&) {
+			thrown = true;
+		}
+		Assert::IsTrue(thrown);
+	}
+	TEST_METHOD(parallel_forEach_thread_count_changes) {
+		const unsigned original = parallel::threadCount();
+		for(int round = 0; round < 50; round++) {
+			parallel::setThreadCount(2 + round % 4);
+			for(int call = 0; call < 3; call++) {
+				/// forEach must not return while a chunk is still running
+				vector<std::atomic<int>> hits(64);
+				std::atomic<int> running{0};
+				parallel::forEach(hits.size(), [&](std::size_t i) {
+					running++;
+					std::this_thread::yield();
+					hits[i]++;
+					running--;
+				});
+				Assert::IsTrue(running == 0);
+				for(auto& h : hits) Assert::IsTrue(h == 1);
+			}
+		}
+		parallel::setThreadCount(original);
+	}
+};
+
+}
@@ -0,0 +1,162 @@
+#include "_pch.h"
+#include "CppUnitTest.h"
+#include "../Maths/maths.h"
+#include "helpers.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace maths;
+using std::vector;
+
+namespace UnitTests {
+
+TEST_CLASS(test_streams) {
+public:
+
+	TEST_METHOD(Construction) {
+		float3_stream s;
+		Assert::IsTrue(s.size() == 0 && s.empty());
+		s.push_back({1, 2, 3});
+		Assert::IsTrue(s.size() == 1 && s.get(0) == float3{1, 2, 3});
+		s.set(0, {4, 5, 6});
+		Assert::IsTrue(s.x[0] == 4 && s.y[0] == 5 && s.z[0] == 6);
+
+		auto p = points3(19, 1);
+		float3_stream a{p};
+		Assert::IsTrue(a.size() == p.size());
+		vector<float3> back(p.size());
+		a.toArray(back);
+		Assert::IsTrue(back == p);
+
+		float4_stream b{points4(19, 1)};
+		Assert::IsTrue(b.size() == 19 && b.get(3) == points4(19, 1)[3]);
+	}
+	TEST_METHOD(dot) {
+		auto p = points3(19, 1), q = points3(19, 2);
+		float3_stream a{p}, b{q};
+		vector<float> out(p.size());
+		maths::dot(a, b, out);
+		for(auto i = 0u; i < p.size(); i++) {
+			Assert::IsTrue(approxEqual(out[i], p[i].dot(q[i])));
+		}
+
+		auto p4 = points4(19, 1), q4 = points4(19, 2);
+		float4_stream a4{p4}, b4{q4};
+		maths::dot(a4, b4, out);
+		for(auto i = 0u; i < p4.size(); i++) {
+			Assert::IsTrue(approxEqual(out[i], p4[i].dot(q4[i])));
+		}
+	}
+	TEST_METHOD(cross) {
+		auto p = points3(19, 1), q = points3(19, 2);
+		float3_stream a{p}, b{q}, out(p.size());
+		maths::cross(a, b, out);
+		for(auto i = 0u; i < p.size(); i++) {
+			Assert::IsTrue(out.get(i).approx(p[i].cross(q[i])));
+		}
+	}
+	TEST_METHOD(lengthAll) {
+		auto p = points3(19, 1);
+		float3_stream a{p};
+		vector<float> out(p.size());
+		maths::lengthAll(a, out);
+		for(auto i = 0u; i < p.size(); i++) {
+			Assert::IsTrue(approxEqual(out[i], p[i].length()));
+		}
+
+		auto p4 = points4(19, 1);
+		float4_stream a4{p4};
+		maths::lengthAll(a4, out);
+		for(auto i = 0u; i < p4.size(); i++) {
+			Assert::IsTrue(approxEqual(out[i], p4[i].length()));
+		}
+	}
+	TEST_METHOD(normaliseAll) {
+		auto p = points3(19, 1);
+		float3_stream a{p};
+		maths::normaliseAll(a);
+		for(auto i = 0u; i < p.size(); i++) {
+			Assert::IsTrue(a.get(i).approx(p[i].normalised()));
+		}
+
+		auto p4 = points4(19, 1);
+		float4_stream a4{p4};
+		maths::normaliseAll(a4);
+		for(auto i = 0u; i < p4.size(); i++) {
+			Assert::IsTrue(a4.get(i).approx(p4[i].normalised()));
+		}
+	}
+	TEST_METHOD(lerpAll) {
+		auto p = points3(19, 1), q = points3(19, 2);
+		float3_stream a{p}, b{q}, out(p.size());
+		maths::lerpAll(a, b, 0.25f, out);
+		for(auto i = 0u; i < p.size(); i++) {
+			Assert::IsTrue(out.get(i).approx(p[i] + (q[i] - p[i]) * 0.25f));
+		}
+	}
+	TEST_METHOD(subspan) {
+		auto p = points3(19, 1), q = points3(19, 2);
+		float3_stream a{p}, b{q};
+		vector<float> out(3);
+		maths::dot(cfloat3_span(a).subspan(5, 3), cfloat3_span(b).subspan(5, 3), out);
+		Assert::IsTrue(approxEqual(out[0], p[5].dot(q[5])));
+		Assert::IsTrue(approxEqual(out[2], p[7].dot(q[7])));
+	}
+	TEST_METHOD(interleave) {
+		const SimdLevel original = simdLevel();
+		for(int level = 0; level <= (int)detectedSimdLevel(); level++) {
+			setSimdLevel((SimdLevel)level);
+			vector<float2> p2;
+			for(int i = 0; i < 19; i++) p2.push_back({(float)i, -i * 2.0f});
+			const auto p3 = points3(19, 1);
+			const auto p4 = points4(19, 1);
+
+			float2_stream s2(p2.size());
+			float3_stream s3(p3.size());
+			float4_stream s4(p4.size());
+			deinterleave(p2, s2);
+			deinterleave(p3, s3);
+			deinterleave(p4, s4);
+			for(auto i = 0u; i < p3.size(); i++) {
+				Assert::IsTrue(s2.get(i) == p2[i]);
+				Assert::IsTrue(s3.get(i) == p3[i]);
+				Assert::IsTrue(s4.get(i) == p4[i]);
+			}
+			vector<float2> b2(p2.size());
+			vector<float3> b3(p3.size());
+			vector<float4> b4(p4.size());
+			maths::interleave(s2, b2);
+			maths::interleave(s3, b3);
+			maths::interleave(s4, b4);
+			Assert::IsTrue(b2 == p2 && b3 == p3 && b4 == p4);
+		}
+		setSimdLevel(original);
+	}
+	TEST_METHOD(aosoa) {
+		const auto p3 = points3(19, 1);
+		const auto p4 = points4(19, 2);
+		for(int block : {4, 8}) {
+			vector<float> a3(aosoaSize(p3.size(), 3, block), -1.0f);
+			toAosoa(p3, block, a3);
+			for(auto i = 0u; i < p3.size(); i++) {
+				const float* b = &a3[i / block * block * 3];
+				Assert::IsTrue(float3(b[i % block], b[block + i % block], b[block * 2 + i % block]) == p3[i]);
+			}
+			/// 19 points pad the last block with zeros
+			for(auto i = p3.size(); i % block; i++) {
+				Assert::IsTrue(a3[i / block * block * 3 + block + i % block] == 0);
+			}
+			vector<float3> back3(p3.size());
+			fromAosoa(a3, block, back3);
+			Assert::IsTrue(back3 == p3);
+
+			vector<float> a4(aosoaSize(p4.size(), 4, block));
+			toAosoa(p4, block, a4);
+			Assert::IsTrue(a4[block * 3 + 1] == p4[1].w);
+			vector<float4> back4(p4.size());
+			fromAosoa(a4, block, back4);
+			Assert::IsTrue(back4 == p4);
+		}
+	}
+};
+
+}
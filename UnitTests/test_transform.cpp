@@ -0,0 +1,225 @@
+#include "_pch.h"
+#include "CppUnitTest.h"
+#include "../Maths/maths.h"
+#include "helpers.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace maths;
+using std::vector;
+
+namespace UnitTests {
+
+/// Several chunks with a partial last chunk and an odd SIMD tail.
+/// z is in [-11, -1] so that the points are in front of a RH camera
+static vector<float3> points(std::size_t n = 50003) {
+	return randomPoints3(n, 11, {-5, -5, -11}, {5, 5, -1});
+}
+static float4 mul(const matrix& m, const float3& p, float w) {
+	return m * float4{p.x, p.y, p.z, w};
+}
+
+TEST_CLASS(test_transform) {
+public:
+
+	TEST_METHOD(points_and_directions) {
+		const auto p = points();
+		const auto m = matrix::translate({1, -2, 3}) * matrix::rotateY(0.4f) * matrix::scale({2, 1, 0.5f});
+		forEachLevel([&]() {
+			vector<float3> points(p.size()), dirs(p.size());
+			transformPoints(m, p, points);
+			transformDirections(m, p, dirs);
+			for(auto i = 0u; i < p.size(); i++) {
+				const float4 e = mul(m, p[i], 1), d = mul(m, p[i], 0);
+				Assert::IsTrue(points[i].approx(float3{e.x, e.y, e.z}));
+				Assert::IsTrue(dirs[i].approx(float3{d.x, d.y, d.z}));
+			}
+		});
+	}
+	TEST_METHOD(in_place) {
+		auto p = points(37);
+		const auto original = p;
+		transformPoints(matrix::translate({1, 2, 3}), p, p);
+		for(auto i = 0u; i < p.size(); i++) {
+			Assert::IsTrue(p[i].approx(original[i] + float3{1, 2, 3}));
+		}
+		vector<float3> empty;
+		transformPoints(matrix::identity(), empty, empty);
+	}
+	TEST_METHOD(project) {
+		const auto p = points();
+		const auto vp = matrix::perspectiveFovRH(toRadians(60), 1.5f, 0.1f, 100) *
+			matrix::lookAtRH({0, 0, 0}, {0, 0, -1}, {0, 1, 0});
+		forEachLevel([&]() {
+			vector<float4> clip(p.size());
+			vector<float3> ndc(p.size());
+			projectPoints(vp, p, clip);
+			projectPoints(vp, p, ndc);
+			for(auto i = 0u; i < p.size(); i++) {
+				const float4 e = mul(vp, p[i], 1);
+				Assert::IsTrue(clip[i].approx(e));
+				Assert::IsTrue(ndc[i].approx(float3{e.x / e.w, e.y / e.w, e.z / e.w}));
+			}
+		});
+	}
+	TEST_METHOD(points_and_directions_2d) {
+		const auto p3 = points();
+		vector<float2> p(p3.size());
+		for(auto i = 0u; i < p.size(); i++) p[i] = {p3[i].x, p3[i].y};
+		const auto a = float2x3::translate({1, -2}) * float2x3::rotate(0.4f) * float2x3::scale({2, 0.5f});
+		forEachLevel([&]() {
+			vector<float2> points(p.size()), dirs(p.size());
+			transformPoints(a, p, points);
+			transformDirections(a, p, dirs);
+			for(auto i = 0u; i < p.size(); i++) {
+				Assert::IsTrue(points[i].approx(a.transformPoint(p[i])));
+				Assert::IsTrue(dirs[i].approx(a.transformDirection(p[i])));
+			}
+		});
+	}
+	TEST_METHOD(instance_mvps) {
+		Camera3D camera;
+		camera.init({800, 600}, {3, 4, 10}, {0, 1, 0}, {0, 0, 0});
+		/// Several chunks with an odd SIMD tail
+		const std::size_t n = 9001;
+		vector<matrix> models(n);
+		for(auto i = 0u; i < n; i++) {
+			models[i] = matrix::translate({i * 0.01f, -1, 2}) * matrix::rotateY(i * 0.1f) *
+						matrix::scale({1 + (i % 5) * 0.5f, 1, 0.5f + (i % 3)});
+		}
+		struct Instance {
+			matrix mvp;
+			float4 normal[3];
+			uint32_t id;
+			uint32_t pad[3];
+		};
+		forEachLevel([&]() {
+			vector<matrix> mvps(n), only(n);
+			vector<float4> normals(n * 3);
+			vector<Instance> instances(n);
+			instanceMVPs(camera, models, mvps, normals);
+			instanceMVPs(camera, models, only);
+			for(auto i = 0u; i < n; i++) instances[i].id = i;
+			instanceMVPs(camera, models, instances.data(), {sizeof(Instance), offsetof(Instance, mvp), offsetof(Instance, normal)});
+
+			for(auto i = 0u; i < n; i += 7) {
+				const matrix expected = camera.VP() * models[i];
+				const float3x3 nm = float3x3::fromMatrix(models[i]).inversed().transposed();
+				for(int c = 0; c < 4; c++) {
+					Assert::IsTrue(mvps[i][c].approx(expected[c]));
+				}
+				Assert::IsTrue(only[i] == mvps[i]);
+				Assert::IsTrue(instances[i].mvp == mvps[i]);
+				Assert::IsTrue(instances[i].id == i);
+				for(int c = 0; c < 3; c++) {
+					Assert::IsTrue(normals[i * 3 + c].approx(float4{nm[c].x, nm[c].y, nm[c].z, 0}));
+					Assert::IsTrue(instances[i].normal[c] == normals[i * 3 + c]);
+				}
+			}
+		});
+	}
+	TEST_METHOD(instance_normals_singular) {
+		/// Every third model is flattened in y
+		vector<matrix> models(19);
+		for(auto i = 0u; i < models.size(); i++) {
+			models[i] = matrix::scale({2, i % 3 == 0 ? 0.0f : 1.0f, 1});
+		}
+		forEachLevel([&]() {
+			vector<matrix> mvps(models.size());
+			vector<float4> normals(models.size() * 3);
+			instanceMVPs(matrix::identity(), models, mvps, normals);
+			for(auto i = 0u; i < models.size(); i++) {
+				for(int c = 0; c < 3; c++) {
+					const float4 expected = i % 3 == 0 ? float4{0, 0, 0, 0} : matrix::identity()[c] * float4{0.5f, 1, 1, 0};
+					Assert::IsTrue(normals[i * 3 + c] == expected);
+				}
+			}
+		});
+	}
+	TEST_METHOD(dmatrix_multiply_and_transform) {
+		/// Two chunks, the second partial
+		vector<dmatrix> a(5001), b(a.size());
+		vector<double4> v(a.size());
+		for(auto i = 0u; i < a.size(); i++) {
+			a[i] = dmatrix::translate({1e7 + i, -2e7, 0.25 * i}) * dmatrix::rotateY(i * 0.1);
+			b[i] = dmatrix::rotateX(i * 0.01) * dmatrix::scale({1.5, 2, 0.5 + i});
+			v[i] = {i * 1.1, -1.0 / (i + 1), 3, 1};
+		}
+		forEachLevel([&]() {
+			vector<dmatrix> ab(a.size()), a0b(a.size());
+			vector<double4> mv(v.size());
+			multiply(a, b, ab);
+			multiply(a[7], b, a0b);
+			transform(a[3], v, mv);
+			for(auto i = 0u; i < a.size(); i++) {
+				/// Same order of operations as the dmatrix operators
+				Assert::IsTrue(ab[i] == a[i] * b[i]);
+				Assert::IsTrue(a0b[i] == a[7] * b[i]);
+				Assert::IsTrue(mv[i] == a[3] * v[i]);
+			}
+			/// In place
+			vector<dmatrix> c = b;
+			multiply(a, c, c);
+			Assert::IsTrue(c == ab);
+		});
+	}
+	TEST_METHOD(dmatrix_inverse_transpose_normalise) {
+		/// Two chunks, the second partial, and an odd tail for normaliseAll
+		vector<dmatrix> m(5003);
+		vector<double4> v(m.size());
+		for(auto i = 0u; i < m.size(); i++) {
+			m[i] = dmatrix::translate({1e7 + i, -2e7, 0.25 * i}) * dmatrix::rotateY(i * 0.1) * dmatrix::scale({1, 2 + i, 0.5});
+			v[i] = {i * 1.1, -1.0 / (i + 1), 3, 1e10 * (i % 3)};
+		}
+		/// Singular
+		m[17] = dmatrix::scale({1, 0, 1});
+		forEachLevel([&]() {
+			vector<dmatrix> inv(m.size()), tr(m.size());
+			vector<double4> n = v;
+			inversedAll(m, inv);
+			transposedAll(m, tr);
+			normaliseAll(n);
+			for(auto i = 0u; i < m.size(); i++) {
+				Assert::IsTrue(inv[i] == m[i].inversed());
+				Assert::IsTrue(tr[i] == m[i].transposed());
+				Assert::IsTrue(n[i] == v[i].normalised());
+			}
+			/// In place
+			vector<dmatrix> c = m;
+			inversedAll(c, c);
+			Assert::IsTrue(c == inv);
+		});
+	}
+	TEST_METHOD(to_float) {
+		vector<dmatrix> d(37);
+		vector<double4> d4(37);
+		vector<double3> d3(37);
+		for(auto i = 0u; i < d.size(); i++) {
+			d[i] = dmatrix::translate({1e7 + i, -2e7, 0.25 * i}) * dmatrix::rotateY(i * 0.1);
+			d4[i] = {i * 1.1, -1.0 / (i + 1), 3, 1e10};
+			d3[i] = {i * 0.3, 2, -1.0 * i};
+		}
+		forEachLevel([&]() {
+			vector<matrix> m(d.size()), rel(d.size());
+			vector<float4> f4(d4.size());
+			vector<float3> f3(d3.size());
+			toFloat(d, m);
+			toFloat(d4, f4);
+			toFloat(d3, f3);
+			toFloat(d, {1e7, -2e7, 0}, rel);
+			for(auto i = 0u; i < d.size(); i++) {
+				for(int c = 0; c < 4; c++) {
+					for(int r = 0; r < 4; r++) {
+						Assert::IsTrue(m[i][c][r] == (float)d[i][c][r]);
+					}
+				}
+				Assert::IsTrue(f4[i] == float4{(float)d4[i].x, (float)d4[i].y, (float)d4[i].z, (float)d4[i].w});
+				Assert::IsTrue(f3[i] == float3{(float)d3[i].x, (float)d3[i].y, (float)d3[i].z});
+				/// The translation keeps its fractional part relative to the origin
+				Assert::IsTrue(rel[i][3] == float4{(float)i, 0, 0.25f * i, 1});
+				Assert::IsTrue(rel[i][0] == m[i][0]);
+			}
+		});
+	}
+};
+
+}
@@ -0,0 +1,164 @@
+#include "_pch.h"
+#include "CppUnitTest.h"
+#include "../Maths/maths.h"
+#include "helpers.h"
+#include <bit>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace maths;
+using std::vector;
+
+namespace UnitTests {
+
+/// Error of a in units of the last place of the correctly rounded b
+static double ulps(float a, double b) {
+	const float r = (float)b;
+	const float next = std::nextafter(std::fabs(r), INFINITY);
+	const double ulp = next - std::fabs(r);
+	return std::fabs(a - b) / (r == 0 ? std::numeric_limits<float>::denorm_min() : ulp);
+}
+
+/// Number of floats between a and the correctly rounded b, as in the table in trig.h
+static int64_t ulpDistance(float a, double b) {
+	const auto ordered = [](float f) {
+		const int32_t i = std::bit_cast<int32_t>(f);
+		return i < 0 ? (int64_t)INT32_MIN - i : (int64_t)i;
+	};
+	return std::abs(ordered(a) - ordered((float)b));
+}
+/// fn(x) for every step-th float from lo to hi, both positive
+template<typename F>
+static void forEachFloat(float lo, float hi, uint32_t step, F fn) {
+	for(uint32_t b = std::bit_cast<uint32_t>(lo); b <= std::bit_cast<uint32_t>(hi); b += step) {
+		fn(std::bit_cast<float>(b));
+	}
+}
+
+TEST_CLASS(test_trig) {
+public:
+
+	TEST_METHOD(sincos) {
+		for(int i = -1000; i <= 1000; i++) {
+			const float x = i * 0.00314159f;
+			float s, c;
+			trig::sincos(x, s, c);
+			Assert::IsTrue(ulps(s, std::sin((double)x)) <= 2);
+			Assert::IsTrue(ulps(c, std::cos((double)x)) <= 2);
+			Assert::IsTrue(s == trig::sin(x) && c == trig::cos(x));
+		}
+		/// Large arguments are within 1e-7 absolute
+		for(int i = -1000; i <= 1000; i++) {
+			const float x = i * 8.191f;
+			Assert::IsTrue(std::fabs(trig::sin(x) - std::sin((double)x)) <= 1e-7);
+			Assert::IsTrue(std::fabs(trig::cos(x) - std::cos((double)x)) <= 1e-7);
+		}
+		/// Beyond the reduction range, including lanes mixed with small ones
+		for(float x : {65537.0f, -1e5f, 1e6f, 1e7f, -1e8f, 3e9f, 1e10f, 1e20f, -3e38f}) {
+			float s, c;
+			trig::sincos(x, s, c);
+			Assert::IsTrue(ulps(s, std::sin((double)x)) <= 1);
+			Assert::IsTrue(ulps(c, std::cos((double)x)) <= 1);
+			Assert::IsTrue(ulps(trig::tan(x), std::tan((double)x)) <= 4);
+
+			alignas(16) float in[4] = {0.5f, x, -x, 2}, out[4];
+			trig::sin(simd::f32x4::load(in)).store(out);
+			for(int i = 0; i < 4; i++) Assert::IsTrue(out[i] == trig::sin(in[i]));
+		}
+		const float inf = std::numeric_limits<float>::infinity();
+		Assert::IsTrue(std::isnan(trig::sin(inf)) && std::isnan(trig::cos(-inf)));
+		Assert::IsTrue(std::isnan(trig::sin(std::numeric_limits<float>::quiet_NaN())));
+
+		/// The functions that use sincos
+		const matrix m = matrix::rotateZ(5e9f);
+		Assert::IsTrue(m.approx(matrix::rotateZ((float)std::fmod(5e9, 2 * 3.14159265358979323846))));
+		Assert::IsTrue(float3{0, 1, 0}.rotatedAroundX(1e10f).approx(float3{0, 1, 0}.rotatedAroundX((float)std::fmod(1e10, 2 * 3.14159265358979323846))));
+	}
+	TEST_METHOD(tan) {
+		for(int i = -1000; i <= 1000; i++) {
+			const float x = i * 0.0015f;
+			Assert::IsTrue(ulps(trig::tan(x), std::tan((double)x)) <= 4);
+		}
+	}
+	TEST_METHOD(inverse) {
+		for(int i = -1000; i <= 1000; i++) {
+			const float x = i * 0.001f;
+			Assert::IsTrue(ulps(trig::asin(x), std::asin((double)x)) <= 3);
+			Assert::IsTrue(ulps(trig::acos(x), std::acos((double)x)) <= 2);
+			Assert::IsTrue(ulps(trig::atan(x * 50), std::atan((double)x * 50)) <= 2);
+		}
+		/// A sample of all of [-1, 1] and of every positive float for atan
+		forEachFloat(1e-30f, 1, 251, [](float x) {
+			Assert::IsTrue(ulpDistance(trig::asin(x), std::asin((double)x)) <= 3);
+			Assert::IsTrue(ulpDistance(trig::acos(x), std::acos((double)x)) <= 2);
+			Assert::IsTrue(ulpDistance(trig::acos(-x), std::acos(-(double)x)) <= 2);
+		});
+		forEachFloat(1e-30f, 1e30f, 251, [](float x) {
+			Assert::IsTrue(ulpDistance(trig::atan(x), std::atan((double)x)) <= 2);
+		});
+	}
+	TEST_METHOD(atan_dense) {
+		/// Every float where atan uses the pi/4 offset, and either side of it.
+		/// The errors there only show up at isolated inputs
+		forEachFloat(0.4f, 2.5f, 1, [](float x) {
+			Assert::IsTrue(ulpDistance(trig::atan(x), std::atan((double)x)) <= 2);
+		});
+	}
+	TEST_METHOD(atan2) {
+		for(int i = -20; i <= 20; i++) {
+			for(int j = -20; j <= 20; j++) {
+				const float y = i * 0.37f, x = j * 0.53f;
+				if(x == 0 && y == 0) continue;
+				Assert::IsTrue(ulps(trig::atan2(y, x), std::atan2((double)y, (double)x)) <= 4);
+			}
+		}
+		Assert::IsTrue(trig::atan2(0.0f, 0.0f) == 0);
+		Assert::IsTrue(trig::atan2(1.0f, 0.0f) == PI / 2);
+		Assert::IsTrue(trig::atan2(-1.0f, 0.0f) == -PI / 2);
+		Assert::IsTrue(trig::atan2(0.0f, -1.0f) == PI);
+
+		const float inf = std::numeric_limits<float>::infinity();
+		Assert::IsTrue(trig::atan2(inf, inf) == PI / 4);
+		Assert::IsTrue(trig::atan2(-inf, inf) == -PI / 4);
+		Assert::IsTrue(approxEqual(trig::atan2(inf, -inf), 3 * PI / 4));
+		Assert::IsTrue(approxEqual(trig::atan2(-inf, -inf), -3 * PI / 4));
+		Assert::IsTrue(trig::atan2(inf, 1.0f) == PI / 2);
+		Assert::IsTrue(trig::atan2(1.0f, inf) == 0);
+		Assert::IsTrue(trig::atan2(1.0f, -inf) == PI);
+		Assert::IsTrue(std::isnan(trig::atan2(std::numeric_limits<float>::quiet_NaN(), 1.0f)));
+	}
+	TEST_METHOD(wide) {
+		/// Every lane gives the same result as the scalar version
+		alignas(16) float x[4] = {-2.5f, -0.1f, 0.7f, 3.0f}, s[4], c[4];
+		simd::f32x4 vs, vc;
+		trig::sincos(simd::f32x4::load(x), vs, vc);
+		vs.store(s);
+		vc.store(c);
+		for(int i = 0; i < 4; i++) {
+			Assert::IsTrue(s[i] == trig::sin(x[i]));
+			Assert::IsTrue(c[i] == trig::cos(x[i]));
+		}
+	}
+	TEST_METHOD(rotateAround) {
+		/// 37 elements so that the unrolled loop and padded tail are exercised at every width
+		float3_stream v;
+		vector<float> radians;
+		for(int i = 0; i < 37; i++) {
+			v.push_back({i * 0.5f, 3 - i * 0.25f, i * 0.1f - 2});
+			/// Some beyond the reduction range
+			radians.push_back(i % 5 == 0 ? i * 1e7f : i * 0.3f - 5);
+		}
+		forEachLevel([&]() {
+			float3_stream x(v.size()), y(v.size()), z = v;
+			rotateAroundX(v, radians, x);
+			rotateAroundY(v, radians, y);
+			rotateAroundZ(z, radians, z);
+			for(auto i = 0u; i < v.size(); i++) {
+				Assert::IsTrue(x.get(i).approx(v.get(i).rotatedAroundX(radians[i])));
+				Assert::IsTrue(y.get(i).approx(v.get(i).rotatedAroundY(radians[i])));
+				Assert::IsTrue(z.get(i).approx(v.get(i).rotatedAroundZ(radians[i])));
+			}
+		});
+	}
+};
+
+}
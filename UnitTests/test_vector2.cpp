@@ -168,8 +168,15 @@ public:
 
 		Assert::IsTrue(n.approx({0.707106f, 0.707106f}));
 	}
+	TEST_METHOD(normalise_fast) {
+		float2 v = {5, 5};
+		Assert::IsTrue(approxEqual(v.length<Precision::Fast>(), 7.0710678f));
+		Assert::IsTrue(v.normalised<Precision::Fast>().approx({0.707106f, 0.707106f}));
+		Assert::IsTrue(v.normalise<Precision::Fast>().approx({0.707106f, 0.707106f}));
+	}
 	TEST_METHOD(reciprocal) {
 		Assert::IsTrue(float2{10, 20}.reciprocal().approx({0.1f, 0.05f}));
+		Assert::IsTrue(float2{10, 20}.reciprocal<Precision::Fast>().approx({0.1f, 0.05f}));
 	}
 	TEST_METHOD(abs) {
 		Assert::IsTrue(float2{-1, -4.4f}.abs().approx({1, 4.4f}));
@@ -183,6 +190,12 @@ public:
 		Assert::IsTrue(a.angleTo(b)==toRadians(90));
 		Assert::IsTrue(a.angleTo(c) == toRadians(180));
 		Assert::IsTrue(a.angleTo(d) == toRadians(90));
+
+		Assert::IsTrue(approxEqual(a.angleTo<Precision::Fast>(b), toRadians(90)));
+		Assert::IsTrue(approxEqual(a.angleTo<Precision::Fast>(c), toRadians(180)));
+		Assert::IsTrue(approxEqual(float2{1, 2}.angleTo<Precision::Fast>({-3, 1}), float2{1, 2}.angleTo({-3, 1})));
+		/// The product of the squared lengths would overflow
+		Assert::IsTrue(approxEqual(float2{1e10f, 2e10f}.angleTo<Precision::Fast>({-3e10f, 1e10f}), float2{1, 2}.angleTo({-3, 1})));
 	}
 	TEST_METHOD(left_right) {
 		Assert::IsTrue(float2{1, 2}.left() == float2{-2, 1});
@@ -200,6 +213,15 @@ public:
         vector2<unsigned long long> sl{1, 2};
         Assert::IsTrue(sl.toString() == "[1, 2]");
     }
+	TEST_METHOD(hash) {
+		/// Values in [0,1) must not collide
+		std::unordered_set<std::size_t> hashes;
+		for(int i = 0; i < 100; i++) {
+			hashes.insert(float2::HashFunc{}({i / 100.0f, 0.5f}));
+		}
+		Assert::IsTrue(hashes.size() == 100);
+		Assert::IsTrue(int2::HashFunc{}({1, 2}) != int2::HashFunc{}({2, 1}));
+	}
 };
 
 }
\ No newline at end of file
@@ -136,6 +136,27 @@ public:
 		Assert::IsTrue(float3{1, 3, 5}.allGTE(1) == true);
 		Assert::IsTrue(float3{1, 3, 5}.allGTE(3) == false);
 	}
+	TEST_METHOD(masks) {
+		Assert::IsTrue(float3{1, 3, 5}.maskLT(3) == 0b001);
+		Assert::IsTrue(float3{1, 3, 5}.maskLTE(3) == 0b011);
+		Assert::IsTrue(float3{1, 3, 5}.maskGT(3) == 0b100);
+		Assert::IsTrue(float3{1, 3, 5}.maskGTE(3) == 0b110);
+		Assert::IsTrue(float3{1, 3, 5}.maskEQ(3) == 0b010);
+		Assert::IsTrue(float3{1, 3, 5}.maskNEQ(3) == 0b101);
+		Assert::IsTrue(float3{1, 3, 5}.maskLT({2, 2, 6}) == 0b101);
+		Assert::IsTrue(int3{1, 3, 5}.maskGTE({2, 2, 6}) == 0b010);
+		static_assert(int3{1, 2, 3}.maskEQ(2) == 0b010);
+	}
+	TEST_METHOD(select_clamp_step) {
+		Assert::IsTrue(select(0b101, float3{1, 2, 3}, float3{4, 5, 6}) == float3{1, 5, 3});
+		Assert::IsTrue(select(float3{1, 3, 5}.maskGT(2), float3{0, 0, 0}, float3{1, 3, 5}) == float3{1, 0, 0});
+
+		Assert::IsTrue(float3{-1, 0.5f, 7}.clamp(0, 2) == float3{0, 0.5f, 2});
+		Assert::IsTrue(float3{-1, 0.5f, 7}.clamp({0, 1, 0}, {1, 2, 3}) == float3{0, 1, 3});
+		Assert::IsTrue(float3{-1, 0.5f, 7}.saturate() == float3{0, 0.5f, 1});
+		Assert::IsTrue(float3{-1, 0.5f, 7}.step(0.5f) == float3{0, 1, 1});
+		Assert::IsTrue(float3{-1, 0.5f, 7}.step({-2, 1, 7}) == float3{1, 0, 1});
+	}
 	TEST_METHOD(hadd) {
 		Assert::IsTrue(float3{3, 6, 9}.hadd() == 18);
 	}
@@ -172,8 +193,25 @@ public:
 
 		Assert::IsTrue(n.approx({0.577350f, 0.577350f, 0.577350f}));
 	}
+	TEST_METHOD(normalise_fast) {
+		float3 v = {5, 5, 5};
+		Assert::IsTrue(approxEqual(v.length<Precision::Fast>(), 8.6602540f));
+		Assert::IsTrue(approxEqual(v.invLength<Precision::Fast>(), 0.1154700f));
+		Assert::IsTrue(v.normalised<Precision::Fast>().approx({0.577350f, 0.577350f, 0.577350f}));
+		Assert::IsTrue(v.normalise<Precision::Fast>().approx({0.577350f, 0.577350f, 0.577350f}));
+		Assert::IsTrue(float3{0, 0, 0}.length<Precision::Fast>() == 0);
+		/// lengthSquared() overflows to inf or is denormal
+		Assert::IsTrue(float3{1e30f, 0, 0}.length<Precision::Fast>() == INFINITY);
+		Assert::IsTrue(std::abs(float3{1e-20f, 0, 0}.length<Precision::Fast>() / 1e-20f - 1) < 1e-4f);
+		Assert::IsTrue(fast::sqrt(INFINITY) == INFINITY);
+		Assert::IsTrue(std::isnan(fast::sqrt(-1.0f)));
+
+		double3 d = {5, 5, 5};
+		Assert::IsTrue(d.normalised<Precision::Fast>() == d.normalised());
+	}
 	TEST_METHOD(reciprocal) {
 		Assert::IsTrue(float3{10, 20, 30}.reciprocal().approx({0.1f, 0.05f, 0.0333333f}));
+		Assert::IsTrue(float3{10, 20, 30}.reciprocal<Precision::Fast>().approx({0.1f, 0.05f, 0.0333333f}));
 	}
 	TEST_METHOD(cross_product) {
 		float3 v = {1, 2, 3};
@@ -205,6 +243,13 @@ public:
 		Assert::IsTrue(a.angleTo(b) == toRadians(90));
 		Assert::IsTrue(a.angleTo(c) == toRadians(180));
 		Assert::IsTrue(a.angleTo(d) == toRadians(90));
+
+		Assert::IsTrue(approxEqual(a.angleTo<Precision::Fast>(a), 0));
+		Assert::IsTrue(approxEqual(a.angleTo<Precision::Fast>(b), toRadians(90)));
+		Assert::IsTrue(approxEqual(a.angleTo<Precision::Fast>(c), toRadians(180)));
+		Assert::IsTrue(approxEqual(float3{1, 2, 3}.angleTo<Precision::Fast>({-3, 1, 2}), float3{1, 2, 3}.angleTo({-3, 1, 2})));
+		/// The product of the squared lengths would overflow
+		Assert::IsTrue(approxEqual(float3{1e10f, 2e10f, 3e10f}.angleTo<Precision::Fast>({-3e10f, 1e10f, 2e10f}), float3{1, 2, 3}.angleTo({-3, 1, 2})));
 	}
 	TEST_METHOD(rotateTowards) {
 		float3 a = {0, 10, 0};
@@ -232,6 +277,11 @@ public:
 		Assert::IsTrue(a.rotatedAroundZ(toRadians(90)).approx({0, 10, 0}));
 		Assert::IsTrue(a.rotatedAroundZ(toRadians(-90)).approx({0, -10, 0}));
 	}
+	TEST_METHOD(rotatedAround_int) {
+		Assert::IsTrue(int3{0, 10, 0}.rotatedAroundX(1) == int3{0, 5, 8});
+		Assert::IsTrue(int3{10, 0, 0}.rotatedAroundY(1) == int3{5, 0, -8});
+		Assert::IsTrue(int3{10, 0, 0}.rotatedAroundZ(1) == int3{5, 8, 0});
+	}
 	TEST_METHOD(left_right) {
 		float3 a{10, 0, 0};
 		float3 up{0, 10, 0};
@@ -257,6 +307,18 @@ public:
         std::unordered_set<float3, float3::HashFunc> s;
 
         s.insert(f);
+        Assert::IsTrue(s.count(f) == 1);
+
+        /// -0 and 0 are equal so must hash the same
+        Assert::IsTrue(float3::HashFunc{}({0, -0.0f, 0}) == float3::HashFunc{}({0, 0, 0}));
+
+        /// Neighbouring voxels spread over the low bits
+        std::unordered_set<std::size_t> buckets;
+        for(int x = 0; x < 16; x++)
+            for(int y = 0; y < 16; y++)
+                for(int z = 0; z < 16; z++)
+                    buckets.insert(int3::HashFunc{}({x, y, z}) & 4095);
+        Assert::IsTrue(buckets.size() > 2400);
     }
 };
 
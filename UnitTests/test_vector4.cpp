@@ -148,6 +148,23 @@ public:
 	TEST_METHOD(ceil) {
 		Assert::IsTrue(float4{5.4f, -9.1f, 1.1f, 0.1f}.ceil() == float4{6, -9, 2, 1});
 	}
+	TEST_METHOD(masks) {
+		Assert::IsTrue(float4{1, 3, 5, 7}.maskLT(5) == 0b0011);
+		Assert::IsTrue(float4{1, 3, 5, 7}.maskGTE(5) == 0b1100);
+		Assert::IsTrue(float4{1, 3, 5, 7}.maskNEQ({1, 0, 5, 0}) == 0b1010);
+		Assert::IsTrue(int4{1, 3, 5, 7}.maskLT(5) == 0b0011);
+		Assert::IsTrue(int4{1, 3, 5, 7}.maskEQ({1, 0, 5, 0}) == 0b0101);
+	}
+	TEST_METHOD(select_clamp_step) {
+		Assert::IsTrue(select(0b0110, float4{1, 2, 3, 4}, float4{5, 6, 7, 8}) == float4{5, 2, 3, 8});
+		Assert::IsTrue(select(0b0110, int4{1, 2, 3, 4}, int4{5, 6, 7, 8}) == int4{5, 2, 3, 8});
+
+		Assert::IsTrue(float4{-1, 0.5f, 7, 1}.clamp(0, 2) == float4{0, 0.5f, 2, 1});
+		Assert::IsTrue(float4{-1, 0.5f, 7, 1}.saturate() == float4{0, 0.5f, 1, 1});
+		Assert::IsTrue(float4{-1, 0.5f, 7, 1}.step(1) == float4{0, 0, 1, 1});
+		Assert::IsTrue(int4{-1, 0, 7, 1}.saturate() == int4{0, 0, 1, 1});
+		Assert::IsTrue(int4{-1, 0, 7, 1}.step({0, 0, 8, 0}) == int4{0, 1, 0, 1});
+	}
 	TEST_METHOD(min_max) {
 		Assert::IsTrue(float4{3, 5, 9, 1}.min() == 1);
 		Assert::IsTrue(float4{3, 5, 9, 1}.max() == 9);
@@ -172,12 +189,71 @@ public:
 
 		Assert::IsTrue(n.approx({0.5f, 0.5f, 0.5f, 0.5f}));
 	}
+	TEST_METHOD(normalise_fast) {
+		float4 v = {5, 5, 5, 5};
+		Assert::IsTrue(approxEqual(v.length<Precision::Fast>(), 10));
+		Assert::IsTrue(approxEqual(v.invLength<Precision::Fast>(), 0.1f));
+		Assert::IsTrue(v.normalised<Precision::Fast>().approx({0.5f, 0.5f, 0.5f, 0.5f}));
+		Assert::IsTrue(v.normalise<Precision::Fast>().approx({0.5f, 0.5f, 0.5f, 0.5f}));
+
+		double4 d = {5, 5, 5, 5};
+		Assert::IsTrue(d.normalised<Precision::Fast>().approx({0.5, 0.5, 0.5, 0.5}));
+	}
 	TEST_METHOD(reciprocal) {
 		Assert::IsTrue(float4{10, 20, 30, 40}.reciprocal().approx({0.1f, 0.05f, 0.0333333f, 0.025f}));
+		Assert::IsTrue(float4{10, 20, 30, 40}.reciprocal<Precision::Fast>().approx({0.1f, 0.05f, 0.0333333f, 0.025f}));
 	}
 	TEST_METHOD(abs) {
 		Assert::IsTrue(float4{-1, -4.4f, 0.1f, 0}.abs().approx({1, 4.4f, 0.1f, 0}));
 	}
+	TEST_METHOD(alignment) {
+		Assert::IsTrue(alignof(float4) == 16 && sizeof(float4) == 16);
+		float4 a[3];
+		Assert::IsTrue(((uintptr_t)&a[1] & 15) == 0);
+	}
+	TEST_METHOD(double_simd) {
+		Assert::IsTrue(alignof(double4) == 16 && sizeof(double4) == 32);
+		const double4 a{1, -2, 3, 4}, b{0.5, 4, -1, 2};
+		Assert::IsTrue(a + b == double4{1.5, 2, 2, 6});
+		Assert::IsTrue(a - b == double4{0.5, -6, 4, 2});
+		Assert::IsTrue(a * b == double4{0.5, -8, -3, 8});
+		Assert::IsTrue(a / b == double4{2, -0.5, -3, 2});
+		Assert::IsTrue(a * 2 + 1 == double4{3, -3, 7, 9});
+		Assert::IsTrue(-a == double4{-1, 2, -3, -4});
+		Assert::IsTrue(a != b);
+		Assert::IsTrue(a.min(b) == double4{0.5, -2, -1, 2});
+		Assert::IsTrue(a.max(b) == double4{1, 4, 3, 4});
+		Assert::IsTrue(a.abs() == double4{1, 2, 3, 4});
+		Assert::IsTrue(a.dot(b) == -2.5);
+		Assert::IsTrue(a.lengthSquared() == 30);
+
+		/// Full double precision
+		const double4 n = double4{1e8, 1, 0, 0}.normalised();
+		Assert::IsTrue(std::abs(n.length() - 1) < 1e-15);
+		Assert::IsTrue(std::abs(n.y - 1e-8) < 1e-20);
+		double4 m = a;
+		m += b;
+		m *= 2;
+		Assert::IsTrue(m == double4{3, 4, 4, 12});
+
+		constexpr double4 c = double4{1, 2, 3, 4} * 2 - double4{1, 1, 1, 1};
+		static_assert(c == double4{1, 3, 5, 7});
+		static_assert(double4{3, 4, 0, 0}.normalised().approx(double4{0.6, 0.8, 0, 0}));
+	}
+	TEST_METHOD(constant_evaluated) {
+		constexpr float4 a = float4{1, 2, 3, 4} * 2 + float4{1, 1, 1, 1};
+		static_assert(a == float4{3, 5, 7, 9});
+		Assert::IsTrue(a == float4{3, 5, 7, 9});
+	}
+	TEST_METHOD(operator_mul_matrix) {
+		matrix m = matrix::rowMajor({
+			1, 2, 3, 4,
+			5, 6, 7, 8,
+			9, 10, 11, 12,
+			13, 14, 15, 16
+		});
+		Assert::IsTrue(float4{1, 2, 3, 4} * m == float4{90, 100, 110, 120});
+	}
     TEST_METHOD(toString) {
         float4 f{1.1f, 2.2f, 3.3f, 4.4f};
 